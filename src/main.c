@@ -65,14 +65,38 @@ void test_lexer_sequence() {
     TJAMES_EQUAL(tok.type, TOKEN_EOF);
 }
 
+TJAMES_TEST("Lexer", test_lexer_whitespace)
+{
+        const char *input = "   +";
+        struct Token tok = lex_next(&input);
+        TJAMES_EQUAL(tok.type, TOKEN_PLUS);
+}
+
 void test_new()
 {
         TJAMES_EQUAL_INT(2, 2);
         TJAMES_EQUAL_FLOAT(3.2, 3.2);
 }
 
-int main() {
+void bench_lexer_sequence(const size_t iterations)
+{
+        for(size_t i = 0; i < iterations; ++i) {
+                const char *input = "7 + - 3";
+                TJAMES_DO_NOT_OPTIMIZE(input);
+                struct Token tok;
+                do {
+                        tok = lex_next(&input);
+                        TJAMES_DO_NOT_OPTIMIZE(tok);
+                } while(tok.type != TOKEN_EOF);
+        }
+}
+
+int main(int argc, char **argv) {
         TJames_Init();
+        if(TJames_ParseArgs(argc, argv) != 0) {
+                TJames_Destroy();
+                return 1;
+        }
 
         TJAMES_ADD_GROUPED_FUNC(test_lexer_plus, "Lexer");
         TJAMES_ADD_GROUPED_FUNC(test_lexer_minus, "Lexer");
@@ -80,5 +104,7 @@ int main() {
         TJAMES_ADD_GROUPED_FUNC(test_lexer_sequence, "Lexer");
         TJAMES_ADD_FUNC(test_new);
 
+        TJAMES_ADD_GROUPED_BENCH(bench_lexer_sequence, "Lexer");
+
         return TJames_Run();
 }
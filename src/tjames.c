@@ -1,9 +1,63 @@
+// dl_iterate_phdr, which the result cache uses, is a GNU extension.
+#define _GNU_SOURCE
+
 #include "tjames.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdarg.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sched.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#define TJAMES_PERF_COUNTERS
+#define TJAMES_THREAD_PINNING
+#endif
+
+// The result cache hashes the code of tests, which it finds through the symbol
+// table of the running executable, and the build IDs of the loaded libraries.
+#if defined(__linux__) && defined(__LP64__)
+#include <elf.h>
+#include <link.h>
+#include <sys/auxv.h>
+#define TJAMES_CODE_SYMBOLS
+#endif
+
+// Bulk comparisons use SSE2 and, if the CPU has it, AVX2. Elsewhere they fall
+// back to scalar loops.
+#if defined(__x86_64__) && !defined(TJAMES_NO_SIMD)
+#include <immintrin.h>
+#define TJAMES_X86_KERNELS
+#endif
+
+// The tables of the allocation trackers bypass the malloc family, which
+// tjames_alloc_hooks.c may replace, so tracking an allocation never recurses.
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+extern void *__libc_calloc(size_t count, size_t size);
+extern void __libc_free(void *ptr);
+#define TJAMES_RAW_CALLOC(count, size) __libc_calloc(count, size)
+#define TJAMES_RAW_FREE(ptr) __libc_free(ptr)
+#else
+#define TJAMES_RAW_CALLOC(count, size) calloc(count, size)
+#define TJAMES_RAW_FREE(ptr) free(ptr)
+#endif
 
 struct TJames_List
 {
@@ -16,40 +70,540 @@ struct TJames_List
 #define LIST_EPTR(element_type, list, index) ((element_type*)list.data + index)
 #define LIST_E(element_type, list, index) (*LIST_EPTR(element_type, list, index))
 
-struct TJames_TestFuncData
+struct TJames_BenchFunc
 {
-        const char *func_name;
-        const char *group_name;
-        size_t added_on_line;
-        const char *file;
-        const char *file_name;
+        BenchFuncPtr func_ptr;
+        struct TJames_TestFuncData data;
 };
 
-struct TJames_TestFunc
+struct TJames_LoadFunc
 {
-        TestFuncPtr func_ptr;
+        LoadFuncPtr func_ptr;
+        size_t max_threads; // 0 for one per available CPU
         struct TJames_TestFuncData data;
 };
 
+enum TJames_PerfCounter
+{
+        PERF_CYCLES = 0,
+        PERF_INSTRUCTIONS,
+        PERF_BRANCH_MISSES,
+        PERF_L1D_MISSES,
+        PERF_LLC_MISSES,
+        PERF_TASK_CLOCK,
+        PERF_PAGE_FAULTS,
+        PERF_CONTEXT_SWITCHES,
+        PERF_COUNTER_COUNT
+};
+
+static const char *const PERF_COUNTER_NAMES[PERF_COUNTER_COUNT] =
+{
+        "cycles", "instructions", "branch_misses", "l1d_misses",
+        "llc_misses", "task_clock_ns", "page_faults", "context_switches"
+};
+
+struct TJames_PerfStats
+{
+        unsigned available; // bit per enum TJames_PerfCounter
+        double values[PERF_COUNTER_COUNT];
+};
+
+// Counters of one thread, opened as a single group so they are enabled,
+// disabled and read together.
+struct TJames_PerfGroup
+{
+        int leader; // -1 if no counter could be opened
+        int fds[PERF_COUNTER_COUNT];
+        enum TJames_PerfCounter order[PERF_COUNTER_COUNT]; // the order a group read returns the counters in
+        size_t count;
+};
+
+// Robust statistics over the ns/op of every sample of a benchmark, computed
+// after outliers further than 3 scaled MADs from the median were dropped.
+struct TJames_BenchStats
+{
+        size_t iterations;
+        size_t samples;
+        size_t outliers;
+        double min;
+        double median;
+        double p99;
+        double mad;
+        struct TJames_PerfStats perf; // per iteration
+};
+
+// One thread count of a load test, latencies are in nanoseconds per call.
+struct TJames_LoadStats
+{
+        size_t threads;
+        size_t calls;
+        double seconds;
+        double calls_per_second;
+        double efficiency; // throughput per thread relative to the single thread
+        double p50;
+        double p99;
+        double p999;
+        double max;
+};
+
+// Outcome of a test run --repeat times or for --soak ms, wall times in ns.
+struct TJames_RepeatStats
+{
+        size_t runs;
+        size_t failures;
+        size_t skips;
+        double mean;
+        double stddev;
+        double p50;
+        double p99;
+        double max;
+        int flaky; // failed some runs and passed others
+        int high_variance; // p99 exceeds TJAMES_REPEAT_MAX_SPREAD times p50
+        int regressed; // significantly slower than the --compare-baseline samples
+};
+
+// A failed TJAMES_EXPECT_* check, waiting to be formatted.
+struct TJames_CheckFailure
+{
+        const struct TJames_Check *check;
+        struct TJames_Operand operands[2];
+        size_t row; // SIZE_MAX outside of tables
+};
+
 struct TJames_Error
 {
-        char *message;
+        const char *message; // NULL until a failed check is formatted
         enum TJames_ErrorType type; 
         size_t line;
+        const struct TJames_CheckFailure *check;
+};
+
+#define TJAMES_ARENA_BLOCK_SIZE (16 * 1024)
+
+struct TJames_ArenaBlock
+{
+        struct TJames_ArenaBlock *next;
+        size_t size;
+        size_t used;
+        char data[];
+};
+
+// Bump allocator for the error messages of a test. Resetting it only rewinds
+// to the first block, the following blocks are rewound once they are reached.
+struct TJames_Arena
+{
+        struct TJames_ArenaBlock *first;
+        struct TJames_ArenaBlock *current;
+};
+
+struct TJames_AllocStats
+{
+        size_t allocations;
+        size_t bytes;
+        size_t peak_bytes; // most bytes the test had allocated at once
+        size_t leaked_allocations;
+        size_t leaked_bytes;
+        int tracked;
+};
+
+struct TJames_AllocEntry
+{
+        void *ptr; // NULL marks a empty slot
+        size_t size;
+        size_t ordinal;
+};
+
+// Counts the allocations of the thread running a test. Its live allocations
+// are kept in a open addressing table, so frees of memory the test did not
+// allocate are told apart and whatever is left at the end leaked.
+struct TJames_AllocTracker
+{
+        struct TJames_AllocStats stats;
+        struct TJames_AllocEntry *entries;
+        size_t slot_count;
+        size_t live_count;
+        size_t live_bytes;
+        int active;
+
+        size_t max_allocs; // SIZE_MAX without TJAMES_MAX_ALLOCS
+        size_t max_allocs_line;
+        size_t max_allocs_base;
+        int check_leaks;
+        size_t leaks_line;
+        size_t leaks_base;
+};
+
+struct TJames_Table
+{
+        TableFuncPtr func_ptr;
+        const char *data; // the mapped case file
+        size_t size;
+        struct TJames_Chunk *chunks;
+        size_t chunk_count;
+};
+
+enum TJames_ChunkKind
+{
+        TABLE_CHUNK = 0,
+        PROPERTY_CHUNK
+};
+
+// The part of a table or property that is registered as one test.
+struct TJames_Chunk
+{
+        enum TJames_ChunkKind kind;
+        const struct TJames_Table *table;
+        const struct TJames_Property *property;
+        size_t first_row;
+        size_t begin; // byte offsets into the table data, or the first and past the last case
+        size_t end;
+        char *name;
+};
+
+// Hooks of a group. Its state is built by the first of its scheduled tests to
+// run and torn down once `pending_tests` dropped to 0.
+struct TJames_Fixture
+{
+        const char *group_name;
+        GroupSetupPtr group_setup;
+        TeardownPtr group_teardown;
+        TestSetupPtr test_setup;
+        TeardownPtr test_teardown;
+
+        pthread_mutex_t mutex;
+        int built;
+        int setup_failed;
+        char *setup_error; // first error the group setup pushed, if it failed
+        void *state;
+        size_t pending_tests;
 };
 
 typedef struct TJames_List TJames_TestFuncList;
+typedef struct TJames_List TJames_BenchFuncList;
 typedef struct TJames_List TJames_ErrorList;
+typedef struct TJames_List TJames_ContextList;
 
-struct TJames_CoreData
+// Everything a running test writes to. Contexts are pooled and handed to
+// whichever thread executes a test, so tests never share mutable state.
+struct TJames_ExecContext
 {
-        TJames_TestFuncList func_list;
         TJames_ErrorList error_list;
+        struct TJames_Arena arena;
         enum TJames_TestResult last_test_result;
+        double wall_time; // seconds
+        double cpu_time;  // seconds of CPU time of the executing thread
+        int stream_fd; // pipe to the parent when running in a isolated child, otherwise -1
+        struct TJames_AllocTracker allocs;
+        struct TJames_PerfStats perf;
+        size_t row; // row of the running table test, SIZE_MAX outside of tables
+        unsigned long long seed; // of the cases of property tests, --seed unless repeated runs vary it
+        const void *group_state;
+        void *test_state;
+        struct TJames_ExecContext *next_free;
+};
+
+#define TJAMES_HISTORY_LENGTH 16
+
+// Recent results of a test, kept in the --history file.
+struct TJames_History
+{
+        char results[TJAMES_HISTORY_LENGTH + 1]; // newest first, 'P' passed or 'F' failed, "" if never run
+        double duration; // seconds of the last run, -1 if unknown
+};
+
+// Per-test slot of a run, filled by the executing thread and drained in
+// registration order by the reporting thread.
+struct TJames_TestRun
+{
+        struct TJames_ExecContext *context;
+        enum TJames_TestResult result;
+        double wall_time;
+        double cpu_time;
+        int over_budget;
+        int scheduled;
+        struct TJames_AllocStats allocs;
+        struct TJames_PerfStats perf;
+        struct TJames_Fixture *fixture; // of the group of the test, NULL without one
+        unsigned long long fingerprint; // of the code and inputs of the test, 0 if it can not be cached
+        int cached; // passed before with the same fingerprint, not run again
+        double *samples; // sorted wall times in ns of the passed --repeat runs, NULL without
+        size_t sample_count;
+};
+
+struct TJames_IndexGroup
+{
+        const char *group_name;
+        unsigned long long hash;
+        struct TJames_List tests; // size_t test indices
+};
+
+// Open addressing hash tables over the registered tests, one from a group name
+// to the tests of that group and one from group and function name to a test.
+// The slots hold a position + 1, so 0 marks a empty slot.
+struct TJames_TestIndex
+{
+        struct TJames_List groups;
+        size_t *group_slots;
+        size_t group_slot_count;
+        size_t *test_slots;
+        size_t test_slot_count;
+        size_t indexed_tests;
+        int indexed_static;
+};
+
+// A --filter or --exclude pattern. "GROUP/FUNC" matches both names separately,
+// a pattern without a slash matches either name and is kept in `func`.
+struct TJames_Filter
+{
+        const char *group;
+        size_t group_length;
+        const char *func;
+        size_t func_length;
+};
+
+enum TJames_BaselineKind
+{
+        BASELINE_TEST = 0,
+        BASELINE_BENCH
+};
+
+static const char *const BASELINE_KIND_NAMES[] = { "test", "bench" };
+
+// Sorted timing samples of a test or benchmark, in nanoseconds (per
+// iteration for benchmarks).
+struct TJames_BaselineEntry
+{
+        enum TJames_BaselineKind kind;
+        char *group_name;
+        char *func_name;
+        double *samples;
+        size_t sample_count;
+};
+
+// The --compare-baseline file, hashed by kind, group and function name, and
+// the file --save-baseline is written to. It is written next to its final
+// path and moved there once the run is done, so one file can be compared
+// against and replaced in the same run.
+struct TJames_Baseline
+{
+        struct TJames_List entries;
+        size_t *slots; // position + 1, 0 marks a empty slot
+        size_t slot_count;
+        int loaded;
+        FILE *output;
+        char *output_path;
+};
+
+struct TJames_RunSummary
+{
+        size_t test_count; // reported tests
+        size_t failed_tests;
+        size_t not_run_tests; // scheduled, but dropped by an aborted run
+        double wall_time;
+};
+
+struct TJames_GroupTime
+{
+        const char *group_name;
+        double wall_time;
+        double cpu_time;
+        size_t test_count;
+};
+
+struct TJames_WorkQueue
+{
+        pthread_mutex_t mutex;
+        size_t begin;
+        size_t end;
+};
+
+struct TJames_Worker
+{
+        pthread_t thread;
+        size_t id;
+        struct TJames_WorkQueue queue;
+};
+
+enum TJames_ChildRecordKind
+{
+        CHILD_ERROR_RECORD = 0,
+        CHILD_RESULT_RECORD,
+        CHILD_ALLOC_RECORD, // followed by the struct TJames_AllocStats of the test
+        CHILD_PERF_RECORD // followed by the struct TJames_PerfStats of the test
+};
+
+// Wire format between a isolated test process and the runner. A error record
+// is followed by `length` bytes of message text.
+struct TJames_ChildRecord
+{
+        enum TJames_ChildRecordKind kind;
+        int value;
+        size_t line;
+        size_t length;
+        double wall_time;
+        double cpu_time;
+};
+
+// The test a thread is currently running, as seen by the watchdog.
+struct TJames_Watch
+{
+        _Atomic unsigned long long deadline; // 0 while no timed test is running
+        _Atomic unsigned long long start;
+        _Atomic size_t index;
+};
+
+struct TJames_Child
+{
+        pid_t pid;
+        int fd;
+        size_t index;
+        struct TJames_ExecContext *context;
+        struct TJames_List buffer;
+        int has_result;
+        unsigned long long spawn_time;
+        unsigned long long deadline; // 0 if the test has no timeout
+        int timed_out;
+};
+
+#define TJAMES_WRITER_BUFFER_SIZE (64 * 1024)
+
+// Fewer samples on either side can not show a significant difference.
+#define TJAMES_BASELINE_MIN_SAMPLES 5
+#define TJAMES_BASELINE_ALPHA 0.01
+
+// Collects the report output and hands it to the stream in large batches.
+struct TJames_Writer
+{
+        FILE *stream;
+        size_t used;
+        char buffer[TJAMES_WRITER_BUFFER_SIZE];
+};
+
+// Output format of a run. Every callback writes into the shared writer and is
+// only ever called from the reporting thread, in registration order.
+struct TJames_Reporter
+{
+        const char *name;
+        void (*begin_run)(struct TJames_Writer *writer, const size_t test_count);
+        void (*begin_test)(struct TJames_Writer *writer, const struct TJames_TestFuncData *func);
+        void (*end_test)(struct TJames_Writer *writer,
+                const size_t position,
+                const struct TJames_TestFuncData *func,
+                const struct TJames_TestRun *run,
+                const struct TJames_ExecContext *context);
+        void (*end_run)(struct TJames_Writer *writer, const struct TJames_RunSummary *summary);
+        void (*bench)(struct TJames_Writer *writer,
+                const struct TJames_TestFuncData *func,
+                const struct TJames_BenchStats *stats,
+                const struct TJames_ExecContext *context);
+        void (*load)(struct TJames_Writer *writer,
+                const struct TJames_TestFuncData *func,
+                const struct TJames_LoadStats *steps,
+                const size_t step_count,
+                const struct TJames_ExecContext *context);
+        void (*repeat)(struct TJames_Writer *writer,
+                const size_t position,
+                const struct TJames_TestFuncData *func,
+                const struct TJames_RepeatStats *stats,
+                const struct TJames_ExecContext *context);
+};
+
+struct TJames_Options
+{
+        size_t jobs;
+        int isolate;
+        int run_benchmarks;
+        size_t bench_samples;
+        double bench_sample_time; // seconds every sample should take
+        int run_loads;
+        double load_time; // seconds every thread count of a load test runs
+        size_t slowest_count;
+        double time_budget; // seconds, 0 disables the budget
+        double timeout; // seconds, 0 disables the timeout
+        int track_allocs;
+        int perf_counters;
+        const char *baseline_path;
+        const char *save_baseline_path;
+        double regression_threshold; // slowdown of the median that counts as a regression
+        const char *reporter_name;
+        const char *output_path;
+        struct TJames_List filters;
+        struct TJames_List excludes;
+        int list_tests;
+        size_t shard_index;
+        size_t shard_count;
+        const char *timings_path;
+        const char *record_timings_path;
+        unsigned long long seed; // of the cases of property tests
+        const char *golden_dir;
+        int update_golden;
+        const char *events_path;
+        const char *cache_path;
+        const char *history_path;
+        int fail_fast;
+        size_t repeat_count; // runs of every test, 0 without --repeat
+        double soak_time; // seconds to keep repeating the tests, 0 without --soak
+};
+
+struct TJames_CoreData
+{
+        TJames_TestFuncList func_list;
+        const struct TJames_TestFunc **static_tests; // the tjames_tests section, by file and line
+        TJames_BenchFuncList bench_list;
+        struct TJames_List load_list; // struct TJames_LoadFunc
+        struct TJames_List table_list; // struct TJames_Table*
+        struct TJames_List property_chunks; // struct TJames_Chunk*
+        struct TJames_List fixtures; // struct TJames_Fixture*
+        TJames_ContextList context_list;
+        struct TJames_ExecContext *free_contexts;
+        pthread_mutex_t context_mutex;
+
+        struct TJames_TestIndex index;
+        size_t *schedule; // test indices selected for the run, in run order
+        size_t schedule_count;
+
+        struct TJames_TestRun *runs;
+        double *repeat_samples; // backs the samples of the runs
+        pthread_mutex_t run_mutex;
+        pthread_cond_t run_cond;
+
+        struct TJames_Worker *workers;
+        size_t worker_count;
+        atomic_size_t stop_position; // schedule position of the first failure with --fail-fast, SIZE_MAX before
+        atomic_size_t abort_position; // first schedule position no execution context was left for, SIZE_MAX before
+
+        struct TJames_Watch *watches;
+        size_t watch_count;
+        pthread_t watchdog;
+        pthread_mutex_t watchdog_mutex;
+        pthread_cond_t watchdog_cond;
+        int stop_watchdog;
+        unsigned long long run_start;
+
+        struct TJames_Baseline baseline;
+
+        const struct TJames_Reporter *reporter;
+        pthread_mutex_t report_mutex;
+        size_t reported_tests;
+        struct TJames_Writer writer;
+
+        struct TJames_Options options;
+        struct TJames_EventHeader *events; // mapped --events file, NULL without one
+        size_t events_size;
+        const struct TJames_CacheHeader *cache; // mapped --cache file, NULL without one
+        size_t cache_size;
+        int cache_enabled; // fingerprints were computed
+        struct TJames_History *history; // per test, NULL without --history
 };
 
 
 static struct TJames_CoreData GLOBAL_CORE_DATA;
+static _Thread_local struct TJames_ExecContext *THREAD_CONTEXT;
+static _Thread_local struct TJames_Watch *THREAD_WATCH;
+static _Thread_local struct TJames_AllocTracker *THREAD_ALLOCS;
+// Set by tjames_alloc_hooks.c, if it is linked into the binary.
+static int ALLOC_HOOKS_INSTALLED;
+static _Thread_local struct TJames_PerfGroup *THREAD_PERF;
 
 struct TJames_List TJames_CreateList(const size_t size_of_element)
 {
@@ -82,7 +636,7 @@ int TJames_AddToList(struct TJames_List *list, const void *data)
                 }
                 if(list->data == NULL)
                 {
-                        printf("TJames Error: Memory allocation failed, while adding a element to a list!\n");
+                        fprintf(stderr, "TJames Error: Memory allocation failed, while adding a element to a list!\n");
                         return -1;
                 }
         }
@@ -94,6 +648,28 @@ int TJames_AddToList(struct TJames_List *list, const void *data)
         return 0;
 }
 
+int TJames_AddRangeToList(struct TJames_List *list, const void *data, const size_t count)
+{
+        if(list->reserved < list->count + count) {
+                size_t reserved = (list->reserved == 0) ? 10 : list->reserved;
+                while(reserved < list->count + count) {
+                        reserved *= 2;
+                }
+                void *new_data = realloc(list->data, reserved * list->size_of_element);
+                if(new_data == NULL)
+                {
+                        fprintf(stderr, "TJames Error: Memory allocation failed, while adding elements to a list!\n");
+                        return -1;
+                }
+                list->data = new_data;
+                list->reserved = reserved;
+        }
+
+        memcpy((char*)list->data + list->count * list->size_of_element, data, count * list->size_of_element);
+        list->count += count;
+        return 0;
+}
+
 void TJames_ClearList(struct TJames_List *list)
 {
         list->count = 0;
@@ -110,190 +686,6788 @@ const char *GetFileName(const char *path)
         return path + last_slash + 1;
 }
 
-char *TJames_FormatErrorMessage(const char* message, va_list args)
+// Tests defined with TJAMES_TEST are collected by the linker into the
+// tjames_tests section, the weak bounds stay NULL if there are none.
+extern const struct TJames_TestFunc *const __start_tjames_tests[] __attribute__((weak));
+extern const struct TJames_TestFunc *const __stop_tjames_tests[] __attribute__((weak));
+
+size_t TJames_StaticTestCount()
 {
-        va_list args_string;
+        if(__start_tjames_tests == NULL || __stop_tjames_tests == NULL) {
+                return 0;
+        }
+        return __stop_tjames_tests - __start_tjames_tests;
+}
 
-        va_copy(args_string, args);
-        int length = vsnprintf(NULL, 0, message, args);
+// Number of tests, the ones in the tjames_tests section come first followed
+// by the ones added with TJames_AddFunc.
+size_t TJames_TestCount()
+{
+        return TJames_StaticTestCount() + GLOBAL_CORE_DATA.func_list.count;
+}
 
-        if(length < 0) {
-                va_end(args_string);
-                return NULL;
+int TJames_CompareStaticTests(const void *a, const void *b)
+{
+        const struct TJames_TestFunc *first = *(const struct TJames_TestFunc *const*)a;
+        const struct TJames_TestFunc *second = *(const struct TJames_TestFunc *const*)b;
+        int order = strcmp(first->data.file, second->data.file);
+        if(order != 0) {
+                return order;
         }
+        return (first->data.added_on_line > second->data.added_on_line) -
+                (first->data.added_on_line < second->data.added_on_line);
+}
 
-        char* buffer = malloc((length + 1) * sizeof(char));
-        if(!buffer) {
-                va_end(args_string);
-                return NULL;
+// The section holds the tests in the order the compiler emitted them, which
+// changes with the optimization level, so they are sorted by file and line.
+void TJames_SortStaticTests()
+{
+        size_t count = TJames_StaticTestCount();
+        GLOBAL_CORE_DATA.static_tests = NULL;
+        if(count == 0) {
+                return;
         }
-
-        int result = vsnprintf(buffer, length + 1, message, args_string);
-        va_end(args_string);
-
-        if(result < 0) {
-                va_end(args_string);
-                return NULL;
+        GLOBAL_CORE_DATA.static_tests = malloc(count * sizeof(const struct TJames_TestFunc*));
+        if(GLOBAL_CORE_DATA.static_tests == NULL) {
+                fprintf(stderr, "TJames Error: Memory allocation failed, while sorting the tests!\n");
+                return;
         }
+        memcpy(GLOBAL_CORE_DATA.static_tests, __start_tjames_tests, count * sizeof(const struct TJames_TestFunc*));
+        qsort(GLOBAL_CORE_DATA.static_tests, count, sizeof(const struct TJames_TestFunc*), TJames_CompareStaticTests);
+}
 
-        return buffer;
+const struct TJames_TestFunc *TJames_GetTestFunc(const size_t index)
+{
+        size_t static_count = TJames_StaticTestCount();
+        if(index < static_count) {
+                return (GLOBAL_CORE_DATA.static_tests) ? GLOBAL_CORE_DATA.static_tests[index] : __start_tjames_tests[index];
+        }
+        return LIST_EPTR(struct TJames_TestFunc, GLOBAL_CORE_DATA.func_list, index - static_count);
 }
 
-void TJames_PushError(const enum TJames_ErrorType type, const size_t line, const char* message, ...)
+const char *TJames_FileName(const struct TJames_TestFuncData *func)
 {
-        struct TJames_Error error;
-        
-        va_list message_args;
-        va_start(message_args, message);
-        error.message = TJames_FormatErrorMessage(message, message_args);
-        va_end(message_args);
+        return (func->file_name) ? func->file_name : GetFileName(func->file);
+}
 
-        error.type = type;
-        error.line = line;
-        TJames_AddToList(&GLOBAL_CORE_DATA.error_list, &error);
+void TJames_DestroyArena(struct TJames_Arena *arena)
+{
+        struct TJames_ArenaBlock *block = arena->first;
+        while(block != NULL) {
+                struct TJames_ArenaBlock *next = block->next;
+                free(block);
+                block = next;
+        }
+        arena->first = NULL;
+        arena->current = NULL;
 }
 
-void TJames_ClearErrorList()
+// Frees nothing, the blocks are reused by the next allocations.
+void TJames_ResetArena(struct TJames_Arena *arena)
 {
-        for(size_t i = 0; i < GLOBAL_CORE_DATA.error_list.count; ++i) {
-                free(LIST_EPTR(struct TJames_Error, GLOBAL_CORE_DATA.error_list, i)->message);
+        arena->current = arena->first;
+        if(arena->current != NULL) {
+                arena->current->used = 0;
         }
-        TJames_ClearList(&GLOBAL_CORE_DATA.error_list);
 }
 
-void TJames_SetTestFuncResult(const enum TJames_TestResult result)
+// Makes sure the current block has at least `size` free bytes, moving on to
+// the next (reset lazily) block or appending a new one if it has not.
+int TJames_ReserveArena(struct TJames_Arena *arena, const size_t size)
 {
-        switch(result)
-        {
-        case SKIPED_TEST:
-        case FAILED_TEST:
-        case EMPTY_TEST:
-                GLOBAL_CORE_DATA.last_test_result = result;
-                return;
-        case SUCCESSFUL_TEST:
-                if(GLOBAL_CORE_DATA.last_test_result == EMPTY_TEST) {
-                        GLOBAL_CORE_DATA.last_test_result = result;
+        while(arena->current != NULL && arena->current->size - arena->current->used < size) {
+                if(arena->current->next == NULL) {
+                        break;
                 }
-                return;
+                arena->current = arena->current->next;
+                arena->current->used = 0;
+        }
+        if(arena->current != NULL && arena->current->size - arena->current->used >= size) {
+                return 0;
+        }
+
+        size_t block_size = (size > TJAMES_ARENA_BLOCK_SIZE) ? size : TJAMES_ARENA_BLOCK_SIZE;
+        struct TJames_ArenaBlock *block = malloc(sizeof(struct TJames_ArenaBlock) + block_size);
+        if(block == NULL) {
+                fprintf(stderr, "TJames Error: Memory allocation failed, while growing a arena!\n");
+                return -1;
+        }
+        block->next = NULL;
+        block->size = block_size;
+        block->used = 0;
+
+        if(arena->current == NULL) {
+                arena->first = block;
+        } else {
+                arena->current->next = block;
         }
+        arena->current = block;
+        return 0;
 }
 
-void TJames_Init()
+// Formats straight into the free tail of the current block. Only messages that
+// do not fit are formatted a second time, into a freshly reserved block.
+const char *TJames_ArenaFormat(struct TJames_Arena *arena, const char* message, va_list args)
 {
-        GLOBAL_CORE_DATA.func_list = TJames_CreateList(sizeof(struct TJames_TestFunc));
-        GLOBAL_CORE_DATA.error_list = TJames_CreateList(sizeof(struct TJames_Error));
-        GLOBAL_CORE_DATA.last_test_result = EMPTY_TEST;
-        printf("Initilized TJames!\n");
+        va_list args_retry;
+        va_copy(args_retry, args);
+
+        struct TJames_ArenaBlock *block = arena->current;
+        char *tail = (block) ? block->data + block->used : NULL;
+        size_t available = (block) ? block->size - block->used : 0;
+
+        int length = vsnprintf(tail, available, message, args);
+        if(length < 0) {
+                va_end(args_retry);
+                return NULL;
+        }
+        if((size_t)length < available) {
+                block->used += length + 1;
+                va_end(args_retry);
+                return tail;
+        }
+
+        if(TJames_ReserveArena(arena, length + 1) != 0) {
+                va_end(args_retry);
+                return NULL;
+        }
+        block = arena->current;
+        tail = block->data + block->used;
+        vsnprintf(tail, length + 1, message, args_retry);
+        block->used += length + 1;
+        va_end(args_retry);
+        return tail;
 }
 
-void TJames_Destroy()
+// Returns `size` bytes aligned for any type, or NULL.
+void *TJames_ArenaAlloc(struct TJames_Arena *arena, const size_t size)
 {
-        TJames_DestroyList(&GLOBAL_CORE_DATA.func_list);
-        TJames_ClearErrorList();
-        TJames_DestroyList(&GLOBAL_CORE_DATA.error_list);
-        printf("Destroyed TJames!\n");
+        const size_t alignment = _Alignof(max_align_t);
+        if(TJames_ReserveArena(arena, size + alignment - 1) != 0) {
+                return NULL;
+        }
+        struct TJames_ArenaBlock *block = arena->current;
+        uintptr_t address = (uintptr_t)(block->data + block->used);
+        address = (address + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        block->used = (char*)address - block->data + size;
+        return (void*)address;
 }
 
-void TJames_DumpTestFunc(const struct TJames_TestFuncData* func)
+const char *TJames_ArenaPrintf(struct TJames_Arena *arena, const char* message, ...)
 {
-        printf("%s: [GROUP: %s] [FUNC: %s] ", func->file_name, func->group_name, func->func_name);
+        va_list args;
+        va_start(args, message);
+        const char *result = TJames_ArenaFormat(arena, message, args);
+        va_end(args);
+        return result;
 }
 
-void TJames_DumpLineTestFunc(const struct TJames_TestFuncData* func)
+unsigned long long TJames_ClockNs(const clockid_t clock)
 {
-        TJames_DumpTestFunc(func);
-        printf("\n");
+        struct timespec now;
+        clock_gettime(clock, &now);
+        return (unsigned long long)now.tv_sec * 1000000000ull + (unsigned long long)now.tv_nsec;
 }
 
-const char *TJames_ErrorTypeString(const enum TJames_ErrorType type)
+int TJames_WriteAll(const int fd, const void *data, size_t size)
 {
-        switch(type)
-        {
-        case WARNING_ERROR:
-                return "WARNING";
-        case NORMAL_ERROR:
-                return "ERROR";
-        case CRITICAL_ERROR:
-                return "CRITICAL";
+        const char *bytes = data;
+        while(size > 0) {
+                ssize_t written = write(fd, bytes, size);
+                if(written < 0) {
+                        if(errno == EINTR) {
+                                continue;
+                        }
+                        return -1;
+                }
+                bytes += written;
+                size -= written;
         }
-        return "ERROR IN ERROR TYPE STRING";
+        return 0;
 }
 
-void TJames_ReportErrors(const struct TJames_TestFuncData* func)
+int TJames_WriteChildRecord(const int fd, const struct TJames_ChildRecord *record, const char *message)
 {
-        for(size_t j = 0; j < GLOBAL_CORE_DATA.error_list.count; ++j) {
-                struct TJames_Error *error = LIST_EPTR(struct TJames_Error, GLOBAL_CORE_DATA.error_list, j);
-                const char *error_type = TJames_ErrorTypeString(error->type);
-                printf("%s:%lu (%s) [%s] %s\n", func->file, error->line, func->func_name, error_type, error->message);
+        if(TJames_WriteAll(fd, record, sizeof(*record)) != 0) {
+                return -1;
+        }
+        if(record->length > 0) {
+                return TJames_WriteAll(fd, message, record->length);
         }
+        return 0;
 }
 
-void TJames_ReportTestFuncResult(const struct TJames_TestFuncData* func)
+// *---------------------*
+// |                     |
+// |   BUFFERED OUTPUT   |
+// |                     |
+// *---------------------*
+
+void TJames_FlushWriter(struct TJames_Writer *writer)
 {
-        switch(GLOBAL_CORE_DATA.last_test_result)
-        {
-        default:
-        case FAILED_TEST:
-                printf("- Failed!\n");
-                break;
-        case EMPTY_TEST:
-                TJames_PushError(WARNING_ERROR, 0, "Empty Test");
-        case SUCCESSFUL_TEST:
-                printf("- Success!\n");
-                break;
-        case SKIPED_TEST:
-                printf("- Skipped!\n");
-                break;
+        if(writer->used > 0) {
+                fwrite(writer->buffer, 1, writer->used, writer->stream);
+                writer->used = 0;
         }
-        TJames_ReportErrors(func);
+        fflush(writer->stream);
 }
 
-int TJames_RunTestFunc(const size_t index)
+void TJames_WriterWrite(struct TJames_Writer *writer, const char *data, const size_t size)
 {
-        GLOBAL_CORE_DATA.last_test_result = EMPTY_TEST;
-        TJames_ClearErrorList();
-
-        struct TJames_TestFunc *func = LIST_EPTR(struct TJames_TestFunc, GLOBAL_CORE_DATA.func_list, index);
-
-        TJames_DumpTestFunc(&func->data);
+        if(TJAMES_WRITER_BUFFER_SIZE - writer->used < size) {
+                TJames_FlushWriter(writer);
+                if(size >= TJAMES_WRITER_BUFFER_SIZE) {
+                        fwrite(data, 1, size, writer->stream);
+                        return;
+                }
+        }
+        memcpy(writer->buffer + writer->used, data, size);
+        writer->used += size;
+}
 
-        func->func_ptr();
+void TJames_WriterPrintf(struct TJames_Writer *writer, const char *format, ...)
+{
+        va_list args;
+        va_list args_retry;
+        va_start(args, format);
+        va_copy(args_retry, args);
 
-        TJames_ReportTestFuncResult(&func->data);
+        size_t available = TJAMES_WRITER_BUFFER_SIZE - writer->used;
+        int length = vsnprintf(writer->buffer + writer->used, available, format, args);
+        if(length >= 0 && (size_t)length < available) {
+                writer->used += length;
+        } else if(length >= 0) {
+                TJames_FlushWriter(writer);
+                if(length < TJAMES_WRITER_BUFFER_SIZE) {
+                        vsnprintf(writer->buffer, TJAMES_WRITER_BUFFER_SIZE, format, args_retry);
+                        writer->used = length;
+                } else {
+                        vfprintf(writer->stream, format, args_retry);
+                }
+        }
 
-        return GLOBAL_CORE_DATA.last_test_result == SUCCESSFUL_TEST || GLOBAL_CORE_DATA.last_test_result == EMPTY_TEST;
+        va_end(args_retry);
+        va_end(args);
 }
 
-int TJames_Run()
+void TJames_AddError(struct TJames_ExecContext *context, const struct TJames_Error *error)
 {
-        size_t test_count = GLOBAL_CORE_DATA.func_list.count;
-        size_t failed_tests = 0;
-        for(size_t i = 0; i < GLOBAL_CORE_DATA.func_list.count; ++i)
-        {
-                printf("\n");
-                int result = TJames_RunTestFunc(i);
-                if(!result){
-                        failed_tests += 1;
-                }
+        TJames_AddToList(&context->error_list, error);
+
+        if(context->stream_fd >= 0) {
+                struct TJames_ChildRecord record;
+                record.kind = CHILD_ERROR_RECORD;
+                record.value = error->type;
+                record.line = error->line;
+                record.length = (error->message) ? strlen(error->message) : 0;
+                record.wall_time = 0.0;
+                record.cpu_time = 0.0;
+                TJames_WriteChildRecord(context->stream_fd, &record, error->message);
         }
-        printf("\nRun a total of %lu tests, with a successrate of %lu/%lu\n",
-                test_count, test_count - failed_tests, test_count);
-        TJames_Destroy();
-        return failed_tests != 0;
 }
 
-int TJames_AddFunc(const TestFuncPtr func_ptr,
+// Adds a error whose message lives at least until the context is released.
+void TJames_AddContextError(struct TJames_ExecContext *context,
+        const enum TJames_ErrorType type,
+        const size_t line,
+        const char* message)
+{
+        struct TJames_Error error;
+        error.message = message;
+        if(context->row != SIZE_MAX) {
+                error.message = TJames_ArenaPrintf(&context->arena, "Row %lu: %s", context->row, (message) ? message : "");
+        }
+        error.type = type;
+        error.line = line;
+        error.check = NULL;
+        TJames_AddError(context, &error);
+}
+
+void TJames_PushContextErrorV(struct TJames_ExecContext *context,
+        const enum TJames_ErrorType type,
+        const size_t line,
+        const char* message,
+        va_list args)
+{
+        TJames_AddContextError(context, type, line, TJames_ArenaFormat(&context->arena, message, args));
+}
+
+void TJames_PushContextError(struct TJames_ExecContext *context,
+        const enum TJames_ErrorType type,
+        const size_t line,
+        const char* message, ...)
+{
+        va_list message_args;
+        va_start(message_args, message);
+        TJames_PushContextErrorV(context, type, line, message, message_args);
+        va_end(message_args);
+}
+
+void TJames_PushError(const enum TJames_ErrorType type, const size_t line, const char* message, ...)
+{
+        if(THREAD_CONTEXT == NULL) {
+                fprintf(stderr, "TJames Error: Errors can only be pushed from inside a running test!\n");
+                return;
+        }
+
+        // The messages are allocated on behalf of the test, but not by it.
+        struct TJames_AllocTracker *tracker = THREAD_ALLOCS;
+        THREAD_ALLOCS = NULL;
+        va_list message_args;
+        va_start(message_args, message);
+        TJames_PushContextErrorV(THREAD_CONTEXT, type, line, message, message_args);
+        va_end(message_args);
+        THREAD_ALLOCS = tracker;
+}
+
+void TJames_PushConstError(const enum TJames_ErrorType type, const size_t line, const char* message)
+{
+        if(THREAD_CONTEXT == NULL) {
+                fprintf(stderr, "TJames Error: Errors can only be pushed from inside a running test!\n");
+                return;
+        }
+        struct TJames_AllocTracker *tracker = THREAD_ALLOCS;
+        THREAD_ALLOCS = NULL;
+        TJames_AddContextError(THREAD_CONTEXT, type, line, message);
+        THREAD_ALLOCS = tracker;
+}
+
+void TJames_ClearErrorList(struct TJames_ExecContext *context)
+{
+        TJames_ClearList(&context->error_list);
+        TJames_ResetArena(&context->arena);
+}
+
+void TJames_SetContextResult(struct TJames_ExecContext *context, const enum TJames_TestResult result)
+{
+        switch(result)
+        {
+        case SKIPED_TEST:
+        case CACHED_TEST:
+        case FAILED_TEST:
+        case EMPTY_TEST:
+                context->last_test_result = result;
+                return;
+        case SUCCESSFUL_TEST:
+                if(context->last_test_result == EMPTY_TEST) {
+                        context->last_test_result = result;
+                }
+                return;
+        }
+}
+
+_Thread_local size_t TJames_PassedChecks;
+
+// Turns the checks that passed since the last call into a successful result,
+// unless something else decided the result already.
+void TJames_CollectPassedChecks(struct TJames_ExecContext *context)
+{
+        if(TJames_PassedChecks > 0) {
+                TJames_SetContextResult(context, SUCCESSFUL_TEST);
+                TJames_PassedChecks = 0;
+        }
+}
+
+const char *TJames_FormatOperand(struct TJames_Arena *arena, const struct TJames_Operand *operand)
+{
+        switch(operand->kind)
+        {
+        case SIGNED_OPERAND:
+                return TJames_ArenaPrintf(arena, "%lld", operand->i);
+        case UNSIGNED_OPERAND:
+                return TJames_ArenaPrintf(arena, "%llu", operand->u);
+        case FLOATING_OPERAND:
+                return TJames_ArenaPrintf(arena, "%.17g", operand->f);
+        case CHAR_OPERAND:
+                if(operand->i >= ' ' && operand->i <= '~') {
+                        return TJames_ArenaPrintf(arena, "'%c'", (int)operand->i);
+                }
+                return TJames_ArenaPrintf(arena, "'\\x%02x'", (unsigned)(unsigned char)operand->i);
+        case STRING_OPERAND:
+                return (operand->s) ? TJames_ArenaPrintf(arena, "\"%s\"", operand->s) : "NULL";
+        case POINTER_OPERAND:
+                return TJames_ArenaPrintf(arena, "%p", operand->p);
+        }
+        return "?";
+}
+
+const char *TJames_FormatCheckFailure(struct TJames_Arena *arena, const struct TJames_CheckFailure *failure)
+{
+        const char *a = TJames_FormatOperand(arena, &failure->operands[0]);
+        const char *b = TJames_FormatOperand(arena, &failure->operands[1]);
+        if(failure->row != SIZE_MAX) {
+                return TJames_ArenaPrintf(arena, "Row %lu: Failed \"%s\", got %s %s %s!",
+                        failure->row, failure->check->expression, a, failure->check->op, b);
+        }
+        return TJames_ArenaPrintf(arena, "Failed \"%s\", got %s %s %s!", failure->check->expression, a, failure->check->op, b);
+}
+
+// Formats the failed checks of a test, once it is about to be reported.
+void TJames_FormatDeferredErrors(struct TJames_ExecContext *context)
+{
+        for(size_t i = 0; i < context->error_list.count; ++i) {
+                struct TJames_Error *error = LIST_EPTR(struct TJames_Error, context->error_list, i);
+                if(error->message == NULL && error->check != NULL) {
+                        error->message = TJames_FormatCheckFailure(&context->arena, error->check);
+                }
+        }
+}
+
+// Only the operands are kept, strings copied as they may not outlive the test.
+// A isolated child has to send text, so it formats right away.
+void TJames_CheckFailed(const struct TJames_Check *check, const struct TJames_Operand a, const struct TJames_Operand b)
+{
+        struct TJames_ExecContext *context = THREAD_CONTEXT;
+        if(context == NULL) {
+                fprintf(stderr, "TJames Error: Checks can only fail from inside a running test!\n");
+                return;
+        }
+        struct TJames_AllocTracker *tracker = THREAD_ALLOCS;
+        THREAD_ALLOCS = NULL;
+
+        TJames_SetContextResult(context, FAILED_TEST);
+        struct TJames_CheckFailure *failure = TJames_ArenaAlloc(&context->arena, sizeof(struct TJames_CheckFailure));
+        if(failure != NULL) {
+                failure->check = check;
+                failure->operands[0] = a;
+                failure->operands[1] = b;
+                failure->row = context->row;
+                for(size_t i = 0; i < 2; ++i) {
+                        struct TJames_Operand *operand = &failure->operands[i];
+                        if(operand->kind == STRING_OPERAND && operand->s != NULL) {
+                                size_t length = strlen(operand->s);
+                                char *copy = TJames_ArenaAlloc(&context->arena, length + 1);
+                                if(copy != NULL) {
+                                        memcpy(copy, operand->s, length + 1);
+                                }
+                                operand->s = copy;
+                        }
+                }
+
+                struct TJames_Error error;
+                error.message = NULL;
+                error.type = NORMAL_ERROR;
+                error.line = check->line;
+                error.check = failure;
+                if(context->stream_fd >= 0) {
+                        error.message = TJames_FormatCheckFailure(&context->arena, failure);
+                }
+                TJames_AddError(context, &error);
+        }
+        THREAD_ALLOCS = tracker;
+}
+
+void TJames_SetTestFuncResult(const enum TJames_TestResult result)
+{
+        if(THREAD_CONTEXT == NULL) {
+                fprintf(stderr, "TJames Error: Test results can only be set from inside a running test!\n");
+                return;
+        }
+        TJames_SetContextResult(THREAD_CONTEXT, result);
+}
+
+struct TJames_ExecContext *TJames_AcquireContext()
+{
+        pthread_mutex_lock(&GLOBAL_CORE_DATA.context_mutex);
+        struct TJames_ExecContext *context = GLOBAL_CORE_DATA.free_contexts;
+        if(context != NULL) {
+                GLOBAL_CORE_DATA.free_contexts = context->next_free;
+        } else {
+                context = malloc(sizeof(struct TJames_ExecContext));
+                if(context != NULL) {
+                        context->error_list = TJames_CreateList(sizeof(struct TJames_Error));
+                        context->arena.first = NULL;
+                        context->arena.current = NULL;
+                        memset(&context->allocs, 0, sizeof(context->allocs));
+                        TJames_AddToList(&GLOBAL_CORE_DATA.context_list, &context);
+                }
+        }
+        pthread_mutex_unlock(&GLOBAL_CORE_DATA.context_mutex);
+
+        if(context == NULL) {
+                fprintf(stderr, "TJames Error: Memory allocation failed, while creating a execution context!\n");
+                return NULL;
+        }
+        context->last_test_result = EMPTY_TEST;
+        context->wall_time = 0.0;
+        context->cpu_time = 0.0;
+        context->stream_fd = -1;
+        memset(&context->allocs.stats, 0, sizeof(context->allocs.stats));
+        memset(&context->perf, 0, sizeof(context->perf));
+        context->row = SIZE_MAX;
+        context->seed = GLOBAL_CORE_DATA.options.seed;
+        context->group_state = NULL;
+        context->test_state = NULL;
+        context->next_free = NULL;
+        return context;
+}
+
+void TJames_ReleaseContext(struct TJames_ExecContext *context)
+{
+        TJames_ClearErrorList(context);
+        pthread_mutex_lock(&GLOBAL_CORE_DATA.context_mutex);
+        context->next_free = GLOBAL_CORE_DATA.free_contexts;
+        GLOBAL_CORE_DATA.free_contexts = context;
+        pthread_mutex_unlock(&GLOBAL_CORE_DATA.context_mutex);
+}
+
+// *--------------*
+// |              |
+// |   FIXTURES   |
+// |              |
+// *--------------*
+
+// Runs the group setup in a context of its own, so its errors do not end up in
+// whichever test happened to need the state first. Called with the fixture
+// locked.
+void TJames_BuildFixture(struct TJames_Fixture *fixture)
+{
+        fixture->built = 1;
+        if(fixture->group_setup == NULL) {
+                return;
+        }
+        struct TJames_ExecContext *context = TJames_AcquireContext();
+        if(context == NULL) {
+                fixture->setup_failed = 1;
+                return;
+        }
+
+        struct TJames_ExecContext *test_context = THREAD_CONTEXT;
+        THREAD_CONTEXT = context;
+        fixture->state = fixture->group_setup();
+        TJames_PassedChecks = 0;
+        THREAD_CONTEXT = test_context;
+
+        if(context->last_test_result == FAILED_TEST) {
+                fixture->setup_failed = 1;
+                TJames_FormatDeferredErrors(context);
+                for(size_t i = 0; i < context->error_list.count; ++i) {
+                        const struct TJames_Error *error = LIST_EPTR(struct TJames_Error, context->error_list, i);
+                        if(error->type != WARNING_ERROR && error->message != NULL) {
+                                fixture->setup_error = malloc(strlen(error->message) + 1);
+                                if(fixture->setup_error != NULL) {
+                                        strcpy(fixture->setup_error, error->message);
+                                }
+                                break;
+                        }
+                }
+        }
+        TJames_ReleaseContext(context);
+}
+
+void TJames_TeardownFixture(struct TJames_Fixture *fixture)
+{
+        if(fixture->built && !fixture->setup_failed && fixture->group_teardown != NULL) {
+                fixture->group_teardown(fixture->state);
+        }
+        fixture->built = 0;
+        fixture->setup_failed = 0;
+        free(fixture->setup_error);
+        fixture->setup_error = NULL;
+        fixture->state = NULL;
+}
+
+// Builds the group state if no test did so yet and runs the test setup.
+// Returns 0 if the test must not run, with its result already set.
+int TJames_EnterFixture(struct TJames_Fixture *fixture, struct TJames_ExecContext *context)
+{
+        pthread_mutex_lock(&fixture->mutex);
+        if(!fixture->built) {
+                TJames_BuildFixture(fixture);
+        }
+        pthread_mutex_unlock(&fixture->mutex);
+
+        if(fixture->setup_failed) {
+                TJames_SetContextResult(context, FAILED_TEST);
+                TJames_PushContextError(context, CRITICAL_ERROR, 0, "Setup of group '%s' failed: %s",
+                        fixture->group_name, (fixture->setup_error) ? fixture->setup_error : "no error was pushed");
+                return 0;
+        }
+        context->group_state = fixture->state;
+        if(fixture->test_setup == NULL) {
+                return 1;
+        }
+
+        context->test_state = fixture->test_setup(fixture->state);
+        TJames_PassedChecks = 0;
+        if(context->last_test_result == FAILED_TEST) {
+                TJames_PushContextError(context, CRITICAL_ERROR, 0, "Test setup failed");
+                return 0;
+        }
+        if(context->last_test_result == SKIPED_TEST) {
+                return 0;
+        }
+        context->last_test_result = EMPTY_TEST;
+        return 1;
+}
+
+void TJames_LeaveFixture(struct TJames_Fixture *fixture, struct TJames_ExecContext *context, const int entered)
+{
+        if(entered && fixture->test_teardown != NULL) {
+                fixture->test_teardown(context->test_state);
+        }
+        context->group_state = NULL;
+        context->test_state = NULL;
+}
+
+// Counts a test of the group as done, the last one tears the group state down.
+void TJames_ReleaseFixture(const size_t index)
+{
+        struct TJames_Fixture *fixture = GLOBAL_CORE_DATA.runs[index].fixture;
+        if(fixture == NULL) {
+                return;
+        }
+        pthread_mutex_lock(&fixture->mutex);
+        fixture->pending_tests -= 1;
+        if(fixture->pending_tests == 0) {
+                TJames_TeardownFixture(fixture);
+        }
+        pthread_mutex_unlock(&fixture->mutex);
+}
+
+const void *TJames_GroupState()
+{
+        if(THREAD_CONTEXT == NULL) {
+                fprintf(stderr, "TJames Error: The group state can only be accessed from inside a running test!\n");
+                return NULL;
+        }
+        return THREAD_CONTEXT->group_state;
+}
+
+void *TJames_TestState()
+{
+        if(THREAD_CONTEXT == NULL) {
+                fprintf(stderr, "TJames Error: The test state can only be accessed from inside a running test!\n");
+                return NULL;
+        }
+        return THREAD_CONTEXT->test_state;
+}
+
+// *-----------------*
+// |                 |
+// |   BULK CHECKS   |
+// |                 |
+// *-----------------*
+
+// The kernels return the first position at or after `begin` where the inputs
+// differ, or the end if there is none. A value is near its counterpart if both
+// are equal or at most `delta` apart, so NaN is never near anything.
+struct TJames_BulkKernels
+{
+        size_t (*find_mismatch)(const unsigned char *a, const unsigned char *b, size_t begin, const size_t size);
+        size_t (*find_far_float)(const float *a, const float *b, size_t begin, const size_t count, const float delta);
+        size_t (*find_far_double)(const double *a, const double *b, size_t begin, const size_t count, const double delta);
+};
+
+size_t TJames_FindMismatchScalar(const unsigned char *a, const unsigned char *b, size_t begin, const size_t size)
+{
+        for(; begin + 8 <= size; begin += 8) {
+                uint64_t x;
+                uint64_t y;
+                memcpy(&x, a + begin, 8);
+                memcpy(&y, b + begin, 8);
+                if(x != y) {
+                        break;
+                }
+        }
+        while(begin < size && a[begin] == b[begin]) {
+                ++begin;
+        }
+        return begin;
+}
+
+size_t TJames_FindFarFloatScalar(const float *a, const float *b, size_t begin, const size_t count, const float delta)
+{
+        while(begin < count && (a[begin] == b[begin] || fabsf(a[begin] - b[begin]) <= delta)) {
+                ++begin;
+        }
+        return begin;
+}
+
+size_t TJames_FindFarDoubleScalar(const double *a, const double *b, size_t begin, const size_t count, const double delta)
+{
+        while(begin < count && (a[begin] == b[begin] || fabs(a[begin] - b[begin]) <= delta)) {
+                ++begin;
+        }
+        return begin;
+}
+
+#ifdef TJAMES_X86_KERNELS
+// SSE2 is part of x86-64, AVX2 is only used once the CPU reported it.
+size_t TJames_FindMismatchSse2(const unsigned char *a, const unsigned char *b, size_t begin, const size_t size)
+{
+        for(; begin + 16 <= size; begin += 16) {
+                __m128i equal = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + begin)),
+                        _mm_loadu_si128((const __m128i*)(b + begin)));
+                unsigned mask = (unsigned)_mm_movemask_epi8(equal) ^ 0xFFFFu;
+                if(mask != 0) {
+                        return begin + __builtin_ctz(mask);
+                }
+        }
+        return TJames_FindMismatchScalar(a, b, begin, size);
+}
+
+size_t TJames_FindFarFloatSse2(const float *a, const float *b, size_t begin, const size_t count, const float delta)
+{
+        const __m128 sign = _mm_set1_ps(-0.0f);
+        const __m128 limit = _mm_set1_ps(delta);
+        for(; begin + 4 <= count; begin += 4) {
+                __m128 x = _mm_loadu_ps(a + begin);
+                __m128 y = _mm_loadu_ps(b + begin);
+                __m128 near = _mm_or_ps(_mm_cmpeq_ps(x, y), _mm_cmple_ps(_mm_andnot_ps(sign, _mm_sub_ps(x, y)), limit));
+                unsigned mask = (unsigned)_mm_movemask_ps(near) ^ 0xFu;
+                if(mask != 0) {
+                        return begin + __builtin_ctz(mask);
+                }
+        }
+        return TJames_FindFarFloatScalar(a, b, begin, count, delta);
+}
+
+size_t TJames_FindFarDoubleSse2(const double *a, const double *b, size_t begin, const size_t count, const double delta)
+{
+        const __m128d sign = _mm_set1_pd(-0.0);
+        const __m128d limit = _mm_set1_pd(delta);
+        for(; begin + 2 <= count; begin += 2) {
+                __m128d x = _mm_loadu_pd(a + begin);
+                __m128d y = _mm_loadu_pd(b + begin);
+                __m128d near = _mm_or_pd(_mm_cmpeq_pd(x, y), _mm_cmple_pd(_mm_andnot_pd(sign, _mm_sub_pd(x, y)), limit));
+                unsigned mask = (unsigned)_mm_movemask_pd(near) ^ 0x3u;
+                if(mask != 0) {
+                        return begin + __builtin_ctz(mask);
+                }
+        }
+        return TJames_FindFarDoubleScalar(a, b, begin, count, delta);
+}
+
+// Compares 64 bytes per round, the common case of equal blocks costs a single
+// test of the combined mask.
+__attribute__((target("avx2")))
+size_t TJames_FindMismatchAvx2(const unsigned char *a, const unsigned char *b, size_t begin, const size_t size)
+{
+        for(; begin + 64 <= size; begin += 64) {
+                __m256i low = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(a + begin)),
+                        _mm256_loadu_si256((const __m256i*)(b + begin)));
+                __m256i high = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(a + begin + 32)),
+                        _mm256_loadu_si256((const __m256i*)(b + begin + 32)));
+                if((unsigned)_mm256_movemask_epi8(_mm256_and_si256(low, high)) == 0xFFFFFFFFu) {
+                        continue;
+                }
+                unsigned mask = ~(unsigned)_mm256_movemask_epi8(low);
+                if(mask != 0) {
+                        return begin + __builtin_ctz(mask);
+                }
+                return begin + 32 + __builtin_ctz(~(unsigned)_mm256_movemask_epi8(high));
+        }
+        return TJames_FindMismatchSse2(a, b, begin, size);
+}
+
+__attribute__((target("avx2")))
+size_t TJames_FindFarFloatAvx2(const float *a, const float *b, size_t begin, const size_t count, const float delta)
+{
+        const __m256 sign = _mm256_set1_ps(-0.0f);
+        const __m256 limit = _mm256_set1_ps(delta);
+        for(; begin + 8 <= count; begin += 8) {
+                __m256 x = _mm256_loadu_ps(a + begin);
+                __m256 y = _mm256_loadu_ps(b + begin);
+                __m256 near = _mm256_or_ps(_mm256_cmp_ps(x, y, _CMP_EQ_OQ),
+                        _mm256_cmp_ps(_mm256_andnot_ps(sign, _mm256_sub_ps(x, y)), limit, _CMP_LE_OQ));
+                unsigned mask = (unsigned)_mm256_movemask_ps(near) ^ 0xFFu;
+                if(mask != 0) {
+                        return begin + __builtin_ctz(mask);
+                }
+        }
+        return TJames_FindFarFloatSse2(a, b, begin, count, delta);
+}
+
+__attribute__((target("avx2")))
+size_t TJames_FindFarDoubleAvx2(const double *a, const double *b, size_t begin, const size_t count, const double delta)
+{
+        const __m256d sign = _mm256_set1_pd(-0.0);
+        const __m256d limit = _mm256_set1_pd(delta);
+        for(; begin + 4 <= count; begin += 4) {
+                __m256d x = _mm256_loadu_pd(a + begin);
+                __m256d y = _mm256_loadu_pd(b + begin);
+                __m256d near = _mm256_or_pd(_mm256_cmp_pd(x, y, _CMP_EQ_OQ),
+                        _mm256_cmp_pd(_mm256_andnot_pd(sign, _mm256_sub_pd(x, y)), limit, _CMP_LE_OQ));
+                unsigned mask = (unsigned)_mm256_movemask_pd(near) ^ 0xFu;
+                if(mask != 0) {
+                        return begin + __builtin_ctz(mask);
+                }
+        }
+        return TJames_FindFarDoubleSse2(a, b, begin, count, delta);
+}
+#endif
+
+static struct TJames_BulkKernels BULK_KERNELS =
+{
+        TJames_FindMismatchScalar, TJames_FindFarFloatScalar, TJames_FindFarDoubleScalar
+};
+
+void TJames_SelectBulkKernels()
+{
+#ifdef TJAMES_X86_KERNELS
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2")) {
+                BULK_KERNELS.find_mismatch = TJames_FindMismatchAvx2;
+                BULK_KERNELS.find_far_float = TJames_FindFarFloatAvx2;
+                BULK_KERNELS.find_far_double = TJames_FindFarDoubleAvx2;
+        } else {
+                BULK_KERNELS.find_mismatch = TJames_FindMismatchSse2;
+                BULK_KERNELS.find_far_float = TJames_FindFarFloatSse2;
+                BULK_KERNELS.find_far_double = TJames_FindFarDoubleSse2;
+        }
+#endif
+}
+
+// Appends to a fixed size message, whatever does not fit is cut off.
+void TJames_AppendText(char *text, const size_t size, size_t *used, const char *format, ...)
+{
+        if(*used >= size) {
+                return;
+        }
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(text + *used, size - *used, format, args);
+        va_end(args);
+        if(length > 0) {
+                *used += length;
+        }
+}
+
+// Hexdump of the lines around `first`, the bytes of `b` that equal those of
+// `a` are left out so the differences stand out.
+void TJames_AppendHexWindow(char *text, const size_t size, size_t *used,
+        const unsigned char *a,
+        const unsigned char *b,
+        const size_t first,
+        const size_t length)
+{
+        size_t begin = (first & ~(size_t)15);
+        begin = (begin >= 16) ? begin - 16 : 0;
+        size_t end = (length - begin > 48) ? begin + 48 : length;
+        for(size_t line = begin; line < end; line += 16) {
+                TJames_AppendText(text, size, used, "\n    %08lx  a:", line);
+                for(size_t i = line; i < line + 16 && i < end; ++i) {
+                        TJames_AppendText(text, size, used, " %02x", a[i]);
+                }
+                TJames_AppendText(text, size, used, "\n              b:");
+                for(size_t i = line; i < line + 16 && i < end; ++i) {
+                        if(a[i] == b[i]) {
+                                TJames_AppendText(text, size, used, " ..");
+                        } else {
+                                TJames_AppendText(text, size, used, " %02x", b[i]);
+                        }
+                }
+        }
+}
+
+// Compares `size` bytes of elements `element_size` bytes large. Returns 1 if
+// they are equal, otherwise pushes the mismatches and fails the test.
+int TJames_EqualMemory(const size_t line,
+        const char *a_text,
+        const char *b_text,
+        const void *a,
+        const void *b,
+        const size_t size,
+        const size_t element_size)
+{
+        const unsigned char *x = a;
+        const unsigned char *y = b;
+        size_t first = BULK_KERNELS.find_mismatch(x, y, 0, size);
+        if(first == size) {
+                return 1;
+        }
+
+        size_t mismatches = 0;
+        for(size_t position = first; position < size; position = BULK_KERNELS.find_mismatch(x, y, position, size)) {
+                mismatches += 1;
+                position = (position / element_size + 1) * element_size;
+        }
+
+        char text[4096];
+        size_t used = 0;
+        if(element_size == 1) {
+                TJames_AppendText(text, sizeof(text), &used, "Failed \"%s\" == \"%s\": %lu of %lu bytes differ, first at byte %lu:",
+                        a_text, b_text, mismatches, size, first);
+        } else {
+                TJames_AppendText(text, sizeof(text), &used,
+                        "Failed \"%s\" == \"%s\": %lu of %lu elements differ, first at index %lu (byte %lu):",
+                        a_text, b_text, mismatches, size / element_size, first / element_size, first);
+        }
+        TJames_AppendHexWindow(text, sizeof(text), &used, x, y, first, size);
+        TJames_SetTestFuncResult(FAILED_TEST);
+        TJames_PushError(NORMAL_ERROR, line, "%s", text);
+        return 0;
+}
+
+// Lists the values around the first one that is too far off.
+int TJames_ReportFarValues(const size_t line,
+        const char *a_text,
+        const char *b_text,
+        const double *a,
+        const double *b,
+        const float *a_float,
+        const float *b_float,
+        const size_t count,
+        const double delta,
+        const size_t first,
+        const size_t mismatches)
+{
+        char text[4096];
+        size_t used = 0;
+        TJames_AppendText(text, sizeof(text), &used,
+                "Failed \"%s\" == \"%s\": %lu of %lu values differ by more than %g, first at index %lu:",
+                a_text, b_text, mismatches, count, delta, first);
+        size_t begin = (first >= 2) ? first - 2 : 0;
+        size_t end = (count - first > 3) ? first + 3 : count;
+        for(size_t i = begin; i < end; ++i) {
+                double x = (a) ? a[i] : a_float[i];
+                double y = (b) ? b[i] : b_float[i];
+                int far = !(x == y || fabs(x - y) <= delta);
+                TJames_AppendText(text, sizeof(text), &used, "\n    %s [%lu] %.*g vs %.*g",
+                        (i == first) ? ">" : " ", i, (a) ? 17 : 9, x, (a) ? 17 : 9, y);
+                if(far) {
+                        TJames_AppendText(text, sizeof(text), &used, " (off by %g)", fabs(x - y));
+                }
+        }
+        TJames_SetTestFuncResult(FAILED_TEST);
+        TJames_PushError(NORMAL_ERROR, line, "%s", text);
+        return 0;
+}
+
+int TJames_NearFloats(const size_t line,
+        const char *a_text,
+        const char *b_text,
+        const float *a,
+        const float *b,
+        const size_t count,
+        const float delta)
+{
+        size_t first = BULK_KERNELS.find_far_float(a, b, 0, count, delta);
+        if(first == count) {
+                return 1;
+        }
+        size_t mismatches = 0;
+        for(size_t i = first; i < count; i = BULK_KERNELS.find_far_float(a, b, i + 1, count, delta)) {
+                mismatches += 1;
+        }
+        return TJames_ReportFarValues(line, a_text, b_text, NULL, NULL, a, b, count, delta, first, mismatches);
+}
+
+int TJames_NearDoubles(const size_t line,
+        const char *a_text,
+        const char *b_text,
+        const double *a,
+        const double *b,
+        const size_t count,
+        const double delta)
+{
+        size_t first = BULK_KERNELS.find_far_double(a, b, 0, count, delta);
+        if(first == count) {
+                return 1;
+        }
+        size_t mismatches = 0;
+        for(size_t i = first; i < count; i = BULK_KERNELS.find_far_double(a, b, i + 1, count, delta)) {
+                mismatches += 1;
+        }
+        return TJames_ReportFarValues(line, a_text, b_text, a, b, NULL, NULL, count, delta, first, mismatches);
+}
+
+// *------------------*
+// |                  |
+// |   GOLDEN FILES   |
+// |                  |
+// *------------------*
+
+#define TJAMES_GOLDEN_CONTEXT_LINES 3
+#define TJAMES_GOLDEN_LINE_LENGTH 120
+
+char *TJames_GoldenPath(const char *name)
+{
+        const char *dir = GLOBAL_CORE_DATA.options.golden_dir;
+        size_t length = strlen(dir) + strlen(name) + 2;
+        char *path = malloc(length);
+        if(path != NULL) {
+                snprintf(path, length, "%s/%s", dir, name);
+        }
+        return path;
+}
+
+// Replaces the golden file in one step, a crash midway leaves the old one.
+// Missing directories on the way are created.
+int TJames_WriteGolden(const char *path, const void *data, const size_t size)
+{
+        size_t length = strlen(path) + 8;
+        char *temp_path = malloc(length);
+        if(temp_path == NULL) {
+                return -1;
+        }
+        snprintf(temp_path, length, "%s", path);
+        for(char *slash = strchr(temp_path + 1, '/'); slash != NULL; slash = strchr(slash + 1, '/')) {
+                *slash = '\0';
+                mkdir(temp_path, 0755);
+                *slash = '/';
+        }
+        snprintf(temp_path, length, "%s.XXXXXX", path);
+        int fd = mkstemp(temp_path);
+        if(fd < 0) {
+                free(temp_path);
+                return -1;
+        }
+        const char *cursor = data;
+        size_t left = size;
+        while(left > 0) {
+                ssize_t written = write(fd, cursor, left);
+                if(written < 0 && errno == EINTR) {
+                        continue;
+                }
+                if(written <= 0) {
+                        break;
+                }
+                cursor += written;
+                left -= written;
+        }
+        int failed = (left > 0 || fchmod(fd, 0644) != 0 || fsync(fd) != 0);
+        if(close(fd) != 0 || failed || rename(temp_path, path) != 0) {
+                unlink(temp_path);
+                free(temp_path);
+                return -1;
+        }
+        free(temp_path);
+        return 0;
+}
+
+// Maps the golden file, an empty one needs no mapping. Returns -1 with errno
+// set if the file can't be read.
+int TJames_MapGolden(const char *path, const unsigned char **data, size_t *size)
+{
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        struct stat info;
+        if(fd < 0 || fstat(fd, &info) != 0) {
+                int error = errno;
+                if(fd >= 0) {
+                        close(fd);
+                }
+                errno = error;
+                return -1;
+        }
+        *size = info.st_size;
+        *data = NULL;
+        if(*size > 0) {
+                void *mapped = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(mapped == MAP_FAILED) {
+                        int error = errno;
+                        close(fd);
+                        errno = error;
+                        return -1;
+                }
+                madvise(mapped, *size, MADV_SEQUENTIAL);
+                *data = mapped;
+        }
+        close(fd);
+        return 0;
+}
+
+// Appends up to `lines` lines starting at `begin`, each cut to a bounded
+// length. Returns where the next line starts.
+size_t TJames_AppendLines(char *text, const size_t size, size_t *used,
+        const char *marker,
+        const unsigned char *data,
+        size_t begin,
+        const size_t length,
+        size_t line_number,
+        const size_t lines)
+{
+        for(size_t i = 0; i < lines && begin < length; ++i, ++line_number) {
+                const unsigned char *line_end = memchr(data + begin, '\n', length - begin);
+                size_t end = (line_end != NULL) ? (size_t)(line_end - data) : length;
+                size_t shown = (end - begin > TJAMES_GOLDEN_LINE_LENGTH) ? TJAMES_GOLDEN_LINE_LENGTH : end - begin;
+                TJames_AppendText(text, size, used, "\n    %s %6lu | %.*s%s", marker, line_number,
+                        (int)shown, (const char*)data + begin, (shown < end - begin) ? "..." : "");
+                begin = end + 1;
+        }
+        return begin;
+}
+
+// Shows where the output leaves the golden file, as lines if both look like
+// text and as a hexdump otherwise.
+void TJames_ReportGoldenMismatch(const size_t line,
+        const char *path,
+        const unsigned char *golden,
+        const size_t golden_size,
+        const unsigned char *output,
+        const size_t output_size,
+        const size_t first)
+{
+        char text[4096];
+        size_t used = 0;
+        size_t common = (golden_size < output_size) ? golden_size : output_size;
+        // Either side having a NUL byte near the difference makes it binary.
+        size_t begin = (first > 64) ? first - 64 : 0;
+        size_t golden_end = (golden_size - begin > 320) ? begin + 320 : golden_size;
+        size_t output_end = (output_size - begin > 320) ? begin + 320 : output_size;
+        int binary = ((golden_end > begin && memchr(golden + begin, '\0', golden_end - begin) != NULL) ||
+                (output_end > begin && memchr(output + begin, '\0', output_end - begin) != NULL));
+
+        TJames_AppendText(text, sizeof(text), &used,
+                "Output does not match golden file '%s' (%lu bytes expected, got %lu), first difference at byte %lu",
+                path, golden_size, output_size, first);
+        if(binary) {
+                TJames_AppendText(text, sizeof(text), &used, ":");
+                TJames_AppendHexWindow(text, sizeof(text), &used, golden, output, first, common);
+        } else {
+                size_t line_begin = first;
+                while(line_begin > 0 && golden[line_begin - 1] != '\n') {
+                        --line_begin;
+                }
+                size_t line_number = 1;
+                const unsigned char *cursor = golden;
+                while(cursor < golden + line_begin && (cursor = memchr(cursor, '\n', golden + line_begin - cursor)) != NULL) {
+                        line_number += 1;
+                        cursor += 1;
+                }
+                TJames_AppendText(text, sizeof(text), &used, ", line %lu column %lu:", line_number, first - line_begin + 1);
+                TJames_AppendLines(text, sizeof(text), &used, "-", golden, line_begin, golden_size,
+                        line_number, TJAMES_GOLDEN_CONTEXT_LINES);
+                TJames_AppendLines(text, sizeof(text), &used, "+", output, line_begin, output_size,
+                        line_number, TJAMES_GOLDEN_CONTEXT_LINES);
+        }
+        if(first == common) {
+                TJames_AppendText(text, sizeof(text), &used, "\n    The %s ends here.", (golden_size < output_size) ? "golden file" : "output");
+        }
+        TJames_SetTestFuncResult(FAILED_TEST);
+        TJames_PushError(NORMAL_ERROR, line, "%s", text);
+}
+
+// Compares `size` bytes against the golden file `name`. With --update-golden
+// a differing or missing file is rewritten instead. Returns 1 on a match.
+int TJames_MatchesGolden(const size_t line, const char *name, const void *data, const size_t size)
+{
+        char *path = TJames_GoldenPath(name);
+        if(path == NULL) {
+                TJames_SetTestFuncResult(FAILED_TEST);
+                TJames_PushError(NORMAL_ERROR, line, "Memory allocation failed, while comparing golden file '%s'!", name);
+                return 0;
+        }
+
+        const unsigned char *golden = NULL;
+        size_t golden_size = 0;
+        int missing = (TJames_MapGolden(path, &golden, &golden_size) != 0);
+        int error = errno;
+        size_t first = 0;
+        int matches = 0;
+        if(!missing) {
+                // The size settles most mismatches before any byte is read.
+                size_t common = (golden_size < size) ? golden_size : size;
+                first = BULK_KERNELS.find_mismatch(golden, data, 0, common);
+                matches = (first == common && golden_size == size);
+        }
+
+        if(!matches && GLOBAL_CORE_DATA.options.update_golden) {
+                if(TJames_WriteGolden(path, data, size) == 0) {
+                        TJames_PushError(WARNING_ERROR, line, "Updated golden file '%s'!", path);
+                        matches = 1;
+                } else {
+                        TJames_SetTestFuncResult(FAILED_TEST);
+                        TJames_PushError(NORMAL_ERROR, line, "Failed to write golden file '%s': %s!", path, strerror(errno));
+                }
+        } else if(missing) {
+                TJames_SetTestFuncResult(FAILED_TEST);
+                TJames_PushError(NORMAL_ERROR, line, "Failed to open golden file '%s': %s, run with --update-golden to create it!",
+                        path, strerror(error));
+        } else if(!matches) {
+                TJames_ReportGoldenMismatch(line, path, golden, golden_size, data, size, first);
+        }
+
+        if(golden != NULL) {
+                munmap((void*)golden, golden_size);
+        }
+        free(path);
+        return matches;
+}
+
+void TJames_DestroyBaseline(struct TJames_Baseline *baseline)
+{
+        for(size_t i = 0; i < baseline->entries.count; ++i) {
+                struct TJames_BaselineEntry *entry = LIST_EPTR(struct TJames_BaselineEntry, baseline->entries, i);
+                free(entry->group_name);
+                free(entry->func_name);
+                free(entry->samples);
+        }
+        TJames_DestroyList(&baseline->entries);
+        free(baseline->slots);
+
+        if(baseline->output != NULL) {
+                size_t length = strlen(baseline->output_path);
+                char *final_path = malloc(length + 1);
+                if(final_path != NULL) {
+                        // Drop the ".tmp" suffix.
+                        memcpy(final_path, baseline->output_path, length - 4);
+                        final_path[length - 4] = '\0';
+                }
+                if(fclose(baseline->output) != 0 || final_path == NULL || rename(baseline->output_path, final_path) != 0) {
+                        fprintf(stderr, "TJames Error: Failed to write the baseline file '%s'!\n", baseline->output_path);
+                }
+                free(final_path);
+        }
+        free(baseline->output_path);
+        memset(baseline, 0, sizeof(*baseline));
+}
+
+void TJames_Init()
+{
+        TJames_SelectBulkKernels();
+        GLOBAL_CORE_DATA.func_list = TJames_CreateList(sizeof(struct TJames_TestFunc));
+        GLOBAL_CORE_DATA.bench_list = TJames_CreateList(sizeof(struct TJames_BenchFunc));
+        GLOBAL_CORE_DATA.load_list = TJames_CreateList(sizeof(struct TJames_LoadFunc));
+        GLOBAL_CORE_DATA.table_list = TJames_CreateList(sizeof(struct TJames_Table*));
+        GLOBAL_CORE_DATA.property_chunks = TJames_CreateList(sizeof(struct TJames_Chunk*));
+        GLOBAL_CORE_DATA.fixtures = TJames_CreateList(sizeof(struct TJames_Fixture*));
+        GLOBAL_CORE_DATA.context_list = TJames_CreateList(sizeof(struct TJames_ExecContext*));
+        GLOBAL_CORE_DATA.free_contexts = NULL;
+        pthread_mutex_init(&GLOBAL_CORE_DATA.context_mutex, NULL);
+        GLOBAL_CORE_DATA.runs = NULL;
+        GLOBAL_CORE_DATA.repeat_samples = NULL;
+        pthread_mutex_init(&GLOBAL_CORE_DATA.run_mutex, NULL);
+        pthread_cond_init(&GLOBAL_CORE_DATA.run_cond, NULL);
+        GLOBAL_CORE_DATA.workers = NULL;
+        GLOBAL_CORE_DATA.worker_count = 0;
+        GLOBAL_CORE_DATA.watches = NULL;
+        GLOBAL_CORE_DATA.watch_count = 0;
+        pthread_mutex_init(&GLOBAL_CORE_DATA.watchdog_mutex, NULL);
+        pthread_cond_init(&GLOBAL_CORE_DATA.watchdog_cond, NULL);
+        GLOBAL_CORE_DATA.stop_watchdog = 0;
+        GLOBAL_CORE_DATA.run_start = 0;
+        pthread_mutex_init(&GLOBAL_CORE_DATA.report_mutex, NULL);
+        GLOBAL_CORE_DATA.options.jobs = 1;
+        GLOBAL_CORE_DATA.options.isolate = 0;
+        GLOBAL_CORE_DATA.options.run_benchmarks = 0;
+        GLOBAL_CORE_DATA.options.bench_samples = 25;
+        GLOBAL_CORE_DATA.options.bench_sample_time = 0.01;
+        GLOBAL_CORE_DATA.options.run_loads = 0;
+        GLOBAL_CORE_DATA.options.load_time = 0.2;
+        GLOBAL_CORE_DATA.options.slowest_count = 5;
+        GLOBAL_CORE_DATA.options.time_budget = 0.0;
+        GLOBAL_CORE_DATA.options.timeout = 0.0;
+        GLOBAL_CORE_DATA.options.track_allocs = 0;
+        GLOBAL_CORE_DATA.options.perf_counters = 0;
+        GLOBAL_CORE_DATA.options.baseline_path = NULL;
+        GLOBAL_CORE_DATA.options.save_baseline_path = NULL;
+        GLOBAL_CORE_DATA.options.regression_threshold = 0.05;
+        memset(&GLOBAL_CORE_DATA.baseline, 0, sizeof(GLOBAL_CORE_DATA.baseline));
+        GLOBAL_CORE_DATA.baseline.entries = TJames_CreateList(sizeof(struct TJames_BaselineEntry));
+        GLOBAL_CORE_DATA.options.reporter_name = "console";
+        GLOBAL_CORE_DATA.options.output_path = NULL;
+        GLOBAL_CORE_DATA.options.filters = TJames_CreateList(sizeof(struct TJames_Filter));
+        GLOBAL_CORE_DATA.options.excludes = TJames_CreateList(sizeof(struct TJames_Filter));
+        GLOBAL_CORE_DATA.options.list_tests = 0;
+        GLOBAL_CORE_DATA.options.shard_index = 0;
+        GLOBAL_CORE_DATA.options.shard_count = 1;
+        GLOBAL_CORE_DATA.options.timings_path = NULL;
+        GLOBAL_CORE_DATA.options.record_timings_path = NULL;
+        GLOBAL_CORE_DATA.options.seed = TJames_ClockNs(CLOCK_REALTIME) ^ ((unsigned long long)getpid() << 32);
+        GLOBAL_CORE_DATA.options.golden_dir = "golden";
+        GLOBAL_CORE_DATA.options.update_golden = 0;
+        GLOBAL_CORE_DATA.options.events_path = NULL;
+        GLOBAL_CORE_DATA.options.cache_path = NULL;
+        GLOBAL_CORE_DATA.options.history_path = NULL;
+        GLOBAL_CORE_DATA.options.fail_fast = 0;
+        GLOBAL_CORE_DATA.options.repeat_count = 0;
+        GLOBAL_CORE_DATA.options.soak_time = 0.0;
+        GLOBAL_CORE_DATA.events = NULL;
+        GLOBAL_CORE_DATA.events_size = 0;
+        GLOBAL_CORE_DATA.cache = NULL;
+        GLOBAL_CORE_DATA.cache_size = 0;
+        GLOBAL_CORE_DATA.cache_enabled = 0;
+        GLOBAL_CORE_DATA.history = NULL;
+        memset(&GLOBAL_CORE_DATA.index, 0, sizeof(GLOBAL_CORE_DATA.index));
+        GLOBAL_CORE_DATA.index.groups = TJames_CreateList(sizeof(struct TJames_IndexGroup));
+        GLOBAL_CORE_DATA.schedule = NULL;
+        GLOBAL_CORE_DATA.schedule_count = 0;
+        GLOBAL_CORE_DATA.reporter = NULL;
+        GLOBAL_CORE_DATA.reported_tests = 0;
+        GLOBAL_CORE_DATA.writer.stream = stdout;
+        GLOBAL_CORE_DATA.writer.used = 0;
+        TJames_SortStaticTests();
+        fprintf(stderr, "Initilized TJames!\n");
+}
+
+void TJames_Destroy()
+{
+        TJames_DestroyList(&GLOBAL_CORE_DATA.func_list);
+        free(GLOBAL_CORE_DATA.static_tests);
+        GLOBAL_CORE_DATA.static_tests = NULL;
+        TJames_DestroyList(&GLOBAL_CORE_DATA.bench_list);
+        TJames_DestroyList(&GLOBAL_CORE_DATA.load_list);
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.table_list.count; ++i) {
+                struct TJames_Table *table = LIST_E(struct TJames_Table*, GLOBAL_CORE_DATA.table_list, i);
+                for(size_t j = 0; j < table->chunk_count; ++j) {
+                        free(table->chunks[j].name);
+                }
+                free(table->chunks);
+                munmap((void*)table->data, table->size);
+                free(table);
+        }
+        TJames_DestroyList(&GLOBAL_CORE_DATA.table_list);
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.property_chunks.count; ++i) {
+                struct TJames_Chunk *chunk = LIST_E(struct TJames_Chunk*, GLOBAL_CORE_DATA.property_chunks, i);
+                free(chunk->name);
+                free(chunk);
+        }
+        TJames_DestroyList(&GLOBAL_CORE_DATA.property_chunks);
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.fixtures.count; ++i) {
+                struct TJames_Fixture *fixture = LIST_E(struct TJames_Fixture*, GLOBAL_CORE_DATA.fixtures, i);
+                TJames_TeardownFixture(fixture);
+                pthread_mutex_destroy(&fixture->mutex);
+                free(fixture);
+        }
+        TJames_DestroyList(&GLOBAL_CORE_DATA.fixtures);
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.context_list.count; ++i) {
+                struct TJames_ExecContext *context = LIST_E(struct TJames_ExecContext*, GLOBAL_CORE_DATA.context_list, i);
+                TJames_ClearErrorList(context);
+                TJames_DestroyList(&context->error_list);
+                TJames_DestroyArena(&context->arena);
+                TJAMES_RAW_FREE(context->allocs.entries);
+                free(context);
+        }
+        TJames_DestroyList(&GLOBAL_CORE_DATA.context_list);
+        GLOBAL_CORE_DATA.free_contexts = NULL;
+        pthread_mutex_destroy(&GLOBAL_CORE_DATA.context_mutex);
+        free(GLOBAL_CORE_DATA.runs);
+        free(GLOBAL_CORE_DATA.repeat_samples);
+        GLOBAL_CORE_DATA.repeat_samples = NULL;
+        free(GLOBAL_CORE_DATA.history);
+        GLOBAL_CORE_DATA.history = NULL;
+        GLOBAL_CORE_DATA.runs = NULL;
+        free(GLOBAL_CORE_DATA.schedule);
+        GLOBAL_CORE_DATA.schedule = NULL;
+        GLOBAL_CORE_DATA.schedule_count = 0;
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.index.groups.count; ++i) {
+                TJames_DestroyList(&LIST_EPTR(struct TJames_IndexGroup, GLOBAL_CORE_DATA.index.groups, i)->tests);
+        }
+        TJames_DestroyList(&GLOBAL_CORE_DATA.index.groups);
+        free(GLOBAL_CORE_DATA.index.group_slots);
+        free(GLOBAL_CORE_DATA.index.test_slots);
+        memset(&GLOBAL_CORE_DATA.index, 0, sizeof(GLOBAL_CORE_DATA.index));
+        TJames_DestroyList(&GLOBAL_CORE_DATA.options.filters);
+        TJames_DestroyList(&GLOBAL_CORE_DATA.options.excludes);
+        TJames_DestroyBaseline(&GLOBAL_CORE_DATA.baseline);
+        pthread_mutex_destroy(&GLOBAL_CORE_DATA.run_mutex);
+        pthread_cond_destroy(&GLOBAL_CORE_DATA.run_cond);
+        pthread_mutex_destroy(&GLOBAL_CORE_DATA.watchdog_mutex);
+        pthread_cond_destroy(&GLOBAL_CORE_DATA.watchdog_cond);
+        pthread_mutex_destroy(&GLOBAL_CORE_DATA.report_mutex);
+        TJames_FlushWriter(&GLOBAL_CORE_DATA.writer);
+        if(GLOBAL_CORE_DATA.writer.stream != stdout) {
+                fclose(GLOBAL_CORE_DATA.writer.stream);
+                GLOBAL_CORE_DATA.writer.stream = stdout;
+        }
+        GLOBAL_CORE_DATA.reporter = NULL;
+        fprintf(stderr, "Destroyed TJames!\n");
+}
+
+void TJames_DumpTestFunc(struct TJames_Writer *writer, const struct TJames_TestFuncData* func)
+{
+        TJames_WriterPrintf(writer, "%s: [GROUP: %s] [FUNC: %s] ", TJames_FileName(func), func->group_name, func->func_name);
+}
+
+void TJames_DumpLineTestFunc(struct TJames_Writer *writer, const struct TJames_TestFuncData* func)
+{
+        TJames_DumpTestFunc(writer, func);
+        TJames_WriterPrintf(writer, "\n");
+}
+
+const char *TJames_ErrorTypeString(const enum TJames_ErrorType type)
+{
+        switch(type)
+        {
+        case WARNING_ERROR:
+                return "WARNING";
+        case NORMAL_ERROR:
+                return "ERROR";
+        case CRITICAL_ERROR:
+                return "CRITICAL";
+        }
+        return "ERROR IN ERROR TYPE STRING";
+}
+
+const char *TJames_TestResultString(const enum TJames_TestResult result)
+{
+        switch(result)
+        {
+        case EMPTY_TEST:
+        case SUCCESSFUL_TEST:
+                return "success";
+        case FAILED_TEST:
+                return "failed";
+        case SKIPED_TEST:
+                return "skipped";
+        case CACHED_TEST:
+                return "cached";
+        }
+        return "failed";
+}
+
+// Cached tests passed on an earlier run, so they count as passed.
+int TJames_TestPassed(const enum TJames_TestResult result)
+{
+        return result == SUCCESSFUL_TEST || result == EMPTY_TEST || result == CACHED_TEST;
+}
+
+void TJames_ReportErrors(struct TJames_Writer *writer, const struct TJames_TestFuncData* func, const struct TJames_ExecContext *context)
+{
+        for(size_t j = 0; j < context->error_list.count; ++j) {
+                struct TJames_Error *error = LIST_EPTR(struct TJames_Error, context->error_list, j);
+                const char *error_type = TJames_ErrorTypeString(error->type);
+                TJames_WriterPrintf(writer, "%s:%lu (%s) [%s] %s\n", func->file, error->line, func->func_name, error_type, error->message);
+        }
+}
+
+void TJames_ReportTestFuncResult(struct TJames_Writer *writer, const enum TJames_TestResult result)
+{
+        switch(result)
+        {
+        default:
+        case FAILED_TEST:
+                TJames_WriterPrintf(writer, "- Failed!\n");
+                break;
+        case EMPTY_TEST:
+        case SUCCESSFUL_TEST:
+                TJames_WriterPrintf(writer, "- Success!\n");
+                break;
+        case SKIPED_TEST:
+                TJames_WriterPrintf(writer, "- Skipped!\n");
+                break;
+        case CACHED_TEST:
+                TJames_WriterPrintf(writer, "- Cached!\n");
+                break;
+        }
+}
+
+// *-------------------------*
+// |                         |
+// |   ALLOCATION TRACKING   |
+// |                         |
+// *-------------------------*
+
+size_t TJames_AllocSlot(const struct TJames_AllocTracker *tracker, const void *ptr)
+{
+        unsigned long long hash = (unsigned long long)(uintptr_t)ptr * 0x9e3779b97f4a7c15ull;
+        return (size_t)(hash >> 32) & (tracker->slot_count - 1);
+}
+
+int TJames_GrowAllocTable(struct TJames_AllocTracker *tracker)
+{
+        size_t new_count = (tracker->slot_count == 0) ? 256 : tracker->slot_count * 2;
+        struct TJames_AllocEntry *new_entries = TJAMES_RAW_CALLOC(new_count, sizeof(struct TJames_AllocEntry));
+        if(new_entries == NULL) {
+                return -1;
+        }
+        struct TJames_AllocEntry *old_entries = tracker->entries;
+        size_t old_count = tracker->slot_count;
+        tracker->entries = new_entries;
+        tracker->slot_count = new_count;
+        for(size_t i = 0; i < old_count; ++i) {
+                if(old_entries[i].ptr == NULL) {
+                        continue;
+                }
+                size_t slot = TJames_AllocSlot(tracker, old_entries[i].ptr);
+                while(new_entries[slot].ptr != NULL) {
+                        slot = (slot + 1) & (new_count - 1);
+                }
+                new_entries[slot] = old_entries[i];
+        }
+        TJAMES_RAW_FREE(old_entries);
+        return 0;
+}
+
+void TJames_TrackAlloc(struct TJames_AllocTracker *tracker, void *ptr, const size_t size)
+{
+        size_t ordinal = tracker->stats.allocations++;
+        tracker->stats.bytes += size;
+        if((tracker->live_count + 1) * 2 > tracker->slot_count && TJames_GrowAllocTable(tracker) != 0) {
+                // Without a entry the allocation can not be told apart from foreign memory.
+                return;
+        }
+
+        size_t slot = TJames_AllocSlot(tracker, ptr);
+        while(tracker->entries[slot].ptr != NULL) {
+                slot = (slot + 1) & (tracker->slot_count - 1);
+        }
+        tracker->entries[slot].ptr = ptr;
+        tracker->entries[slot].size = size;
+        tracker->entries[slot].ordinal = ordinal;
+        tracker->live_count += 1;
+        tracker->live_bytes += size;
+        if(tracker->live_bytes > tracker->stats.peak_bytes) {
+                tracker->stats.peak_bytes = tracker->live_bytes;
+        }
+}
+
+void TJames_UntrackAlloc(struct TJames_AllocTracker *tracker, void *ptr)
+{
+        if(tracker->live_count == 0) {
+                return;
+        }
+        size_t mask = tracker->slot_count - 1;
+        size_t slot = TJames_AllocSlot(tracker, ptr);
+        while(tracker->entries[slot].ptr != ptr) {
+                if(tracker->entries[slot].ptr == NULL) {
+                        return;
+                }
+                slot = (slot + 1) & mask;
+        }
+        tracker->live_count -= 1;
+        tracker->live_bytes -= tracker->entries[slot].size;
+
+        // Backward shift deletion, so lookups never need tombstones.
+        size_t hole = slot;
+        for(size_t next = (hole + 1) & mask; tracker->entries[next].ptr != NULL; next = (next + 1) & mask) {
+                size_t home = TJames_AllocSlot(tracker, tracker->entries[next].ptr);
+                if(((next - home) & mask) >= ((next - hole) & mask)) {
+                        tracker->entries[hole] = tracker->entries[next];
+                        hole = next;
+                }
+        }
+        tracker->entries[hole].ptr = NULL;
+}
+
+void TJames_InstallAllocHooks()
+{
+        ALLOC_HOOKS_INSTALLED = 1;
+}
+
+void *TJames_HookedAlloc(void *ptr, const size_t size)
+{
+        if(THREAD_ALLOCS != NULL && ptr != NULL) {
+                TJames_TrackAlloc(THREAD_ALLOCS, ptr, size);
+        }
+        return ptr;
+}
+
+void TJames_HookedRealloc(void *ptr, void *new_ptr, const size_t size)
+{
+        if(THREAD_ALLOCS == NULL || (new_ptr == NULL && size != 0)) {
+                return;
+        }
+        if(ptr != NULL) {
+                TJames_UntrackAlloc(THREAD_ALLOCS, ptr);
+        }
+        if(new_ptr != NULL) {
+                TJames_TrackAlloc(THREAD_ALLOCS, new_ptr, size);
+        }
+}
+
+void TJames_HookedFree(void *ptr)
+{
+        if(THREAD_ALLOCS != NULL && ptr != NULL) {
+                TJames_UntrackAlloc(THREAD_ALLOCS, ptr);
+        }
+}
+
+void TJames_ActivateAllocTracker(struct TJames_AllocTracker *tracker)
+{
+        tracker->active = 1;
+        tracker->stats.tracked = 1;
+        THREAD_ALLOCS = tracker;
+}
+
+void TJames_StartAllocTracking(struct TJames_ExecContext *context)
+{
+        struct TJames_AllocTracker *tracker = &context->allocs;
+        if(tracker->live_count > 0) {
+                memset(tracker->entries, 0, tracker->slot_count * sizeof(struct TJames_AllocEntry));
+        }
+        memset(&tracker->stats, 0, sizeof(tracker->stats));
+        tracker->live_count = 0;
+        tracker->live_bytes = 0;
+        tracker->active = 0;
+        tracker->max_allocs = SIZE_MAX;
+        tracker->check_leaks = 0;
+        if(GLOBAL_CORE_DATA.options.track_allocs) {
+                TJames_ActivateAllocTracker(tracker);
+        }
+}
+
+// Detaches the tracker, counts what leaked and checks the limits the test set.
+void TJames_StopAllocTracking(struct TJames_ExecContext *context)
+{
+        THREAD_ALLOCS = NULL;
+        struct TJames_AllocTracker *tracker = &context->allocs;
+        if(!tracker->active) {
+                return;
+        }
+
+        size_t checked_leaks = 0;
+        size_t checked_leaked_bytes = 0;
+        for(size_t i = 0; i < tracker->slot_count && tracker->stats.leaked_allocations < tracker->live_count; ++i) {
+                struct TJames_AllocEntry *entry = &tracker->entries[i];
+                if(entry->ptr == NULL) {
+                        continue;
+                }
+                tracker->stats.leaked_allocations += 1;
+                tracker->stats.leaked_bytes += entry->size;
+                if(entry->ordinal >= tracker->leaks_base) {
+                        checked_leaks += 1;
+                        checked_leaked_bytes += entry->size;
+                }
+        }
+
+        size_t allocations = tracker->stats.allocations - tracker->max_allocs_base;
+        if(tracker->max_allocs != SIZE_MAX && allocations > tracker->max_allocs) {
+                TJames_SetContextResult(context, FAILED_TEST);
+                TJames_PushContextError(context, NORMAL_ERROR, tracker->max_allocs_line,
+                        "Made %lu allocations, at most %lu are allowed", allocations, tracker->max_allocs);
+        }
+        if(tracker->check_leaks && checked_leaks > 0) {
+                TJames_SetContextResult(context, FAILED_TEST);
+                TJames_PushContextError(context, NORMAL_ERROR, tracker->leaks_line,
+                        "Leaked %lu allocations (%lu bytes)", checked_leaks, checked_leaked_bytes);
+        }
+}
+
+// Returns the tracker of the running test with tracking switched on, or NULL
+// if tjames_alloc_hooks is not linked in.
+struct TJames_AllocTracker *TJames_RequireAllocTracker(const size_t line)
+{
+        if(THREAD_CONTEXT == NULL) {
+                fprintf(stderr, "TJames Error: Allocation limits can only be set from inside a running test!\n");
+                return NULL;
+        }
+        if(!ALLOC_HOOKS_INSTALLED) {
+                TJames_PushConstError(WARNING_ERROR, line, "Allocation tracking needs tjames_alloc_hooks linked in");
+                return NULL;
+        }
+        struct TJames_AllocTracker *tracker = &THREAD_CONTEXT->allocs;
+        if(!tracker->active) {
+                TJames_ActivateAllocTracker(tracker);
+        }
+        return tracker;
+}
+
+void TJames_LimitAllocs(const size_t line, const size_t max_allocs)
+{
+        struct TJames_AllocTracker *tracker = TJames_RequireAllocTracker(line);
+        if(tracker != NULL) {
+                tracker->max_allocs = max_allocs;
+                tracker->max_allocs_line = line;
+                tracker->max_allocs_base = tracker->stats.allocations;
+        }
+}
+
+void TJames_ForbidLeaks(const size_t line)
+{
+        struct TJames_AllocTracker *tracker = TJames_RequireAllocTracker(line);
+        if(tracker != NULL) {
+                tracker->check_leaks = 1;
+                tracker->leaks_line = line;
+                tracker->leaks_base = tracker->stats.allocations;
+        }
+}
+
+// *--------------------------*
+// |                          |
+// |   PERFORMANCE COUNTERS   |
+// |                          |
+// *--------------------------*
+
+#ifdef TJAMES_PERF_COUNTERS
+int TJames_OpenPerfEvent(const unsigned type, const unsigned long long config, const int group_fd, const int exclude_kernel)
+{
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = (group_fd == -1);
+        attr.exclude_kernel = exclude_kernel;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return (int)syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC);
+}
+
+void TJames_AddPerfCounter(struct TJames_PerfGroup *group,
+        const enum TJames_PerfCounter counter,
+        const unsigned type,
+        const unsigned long long config)
+{
+        // Software events happen in the kernel, so they are counted there too.
+        // Where that is not allowed they fall back to user mode, except context
+        // switches, which would always read 0 there.
+        int fd = TJames_OpenPerfEvent(type, config, group->leader, type != PERF_TYPE_SOFTWARE);
+        if(fd < 0 && type == PERF_TYPE_SOFTWARE && config != PERF_COUNT_SW_CONTEXT_SWITCHES) {
+                fd = TJames_OpenPerfEvent(type, config, group->leader, 1);
+        }
+        if(fd < 0) {
+                return;
+        }
+        if(group->leader < 0) {
+                group->leader = fd;
+        }
+        group->fds[group->count] = fd;
+        group->order[group->count] = counter;
+        group->count += 1;
+}
+#endif
+
+// Opens the counters for the calling thread. Hardware counters are led by
+// cycles, if those are not available (e.g. in containers or VMs) the group
+// is led by task-clock and only has the software counters.
+void TJames_OpenPerfGroup(struct TJames_PerfGroup *group)
+{
+        group->leader = -1;
+        group->count = 0;
+#ifdef TJAMES_PERF_COUNTERS
+        TJames_AddPerfCounter(group, PERF_CYCLES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        if(group->leader >= 0) {
+                TJames_AddPerfCounter(group, PERF_INSTRUCTIONS, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+                TJames_AddPerfCounter(group, PERF_BRANCH_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+                TJames_AddPerfCounter(group, PERF_L1D_MISSES, PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                        (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+                TJames_AddPerfCounter(group, PERF_LLC_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        }
+        TJames_AddPerfCounter(group, PERF_TASK_CLOCK, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK);
+        TJames_AddPerfCounter(group, PERF_PAGE_FAULTS, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+        TJames_AddPerfCounter(group, PERF_CONTEXT_SWITCHES, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES);
+#endif
+}
+
+void TJames_ClosePerfGroup(struct TJames_PerfGroup *group)
+{
+        for(size_t i = 0; i < group->count; ++i) {
+                close(group->fds[i]);
+        }
+        group->leader = -1;
+        group->count = 0;
+}
+
+// Opens the counters of the calling thread if --perf-counters is given.
+void TJames_BeginThreadPerf(struct TJames_PerfGroup *group)
+{
+        group->leader = -1;
+        group->count = 0;
+        if(GLOBAL_CORE_DATA.options.perf_counters) {
+                TJames_OpenPerfGroup(group);
+        }
+        THREAD_PERF = (group->leader >= 0) ? group : NULL;
+}
+
+void TJames_EndThreadPerf(struct TJames_PerfGroup *group)
+{
+        THREAD_PERF = NULL;
+        TJames_ClosePerfGroup(group);
+}
+
+void TJames_StartPerfCounters(struct TJames_PerfGroup *group)
+{
+#ifdef TJAMES_PERF_COUNTERS
+        ioctl(group->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(group->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#else
+        (void)group;
+#endif
+}
+
+// Stops the counters and adds what they counted to `stats`. Counts are scaled
+// up if the kernel had to multiplex the group.
+void TJames_StopPerfCounters(struct TJames_PerfGroup *group, struct TJames_PerfStats *stats)
+{
+#ifdef TJAMES_PERF_COUNTERS
+        ioctl(group->leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        unsigned long long data[3 + PERF_COUNTER_COUNT];
+        ssize_t length = read(group->leader, data, sizeof(data));
+        if(length < (ssize_t)(3 * sizeof(unsigned long long)) || data[0] != group->count) {
+                return;
+        }
+        double scale = (data[2] > 0 && data[2] < data[1]) ? (double)data[1] / data[2] : 1.0;
+        for(size_t i = 0; i < group->count; ++i) {
+                stats->available |= 1u << group->order[i];
+                stats->values[group->order[i]] += data[3 + i] * scale;
+        }
+#else
+        (void)group;
+        (void)stats;
+#endif
+}
+
+// Returns the number of counters this process can open.
+size_t TJames_ProbePerfCounters()
+{
+        struct TJames_PerfGroup group;
+        TJames_OpenPerfGroup(&group);
+        size_t count = group.count;
+        TJames_ClosePerfGroup(&group);
+        return count;
+}
+
+// Returns the instructions per cycle, or 0 if either is missing.
+double TJames_PerfIpc(const struct TJames_PerfStats *stats)
+{
+        unsigned needed = (1u << PERF_CYCLES) | (1u << PERF_INSTRUCTIONS);
+        if((stats->available & needed) != needed || stats->values[PERF_CYCLES] <= 0.0) {
+                return 0.0;
+        }
+        return stats->values[PERF_INSTRUCTIONS] / stats->values[PERF_CYCLES];
+}
+
+// *------------------*
+// |                  |
+// |   EVENT STREAM   |
+// |                  |
+// *------------------*
+
+#define TJAMES_EVENTS_CAPACITY (1u << 16)
+
+// Emitting an event is a atomic increment and a few stores into the mapped
+// file, it never allocates or blocks. The mapping is shared, so isolated
+// children write into it as well.
+void TJames_EmitEvent(const enum TJames_EventKind kind,
+        const size_t test,
+        const unsigned long long *values,
+        const size_t value_count)
+{
+        struct TJames_EventHeader *header = GLOBAL_CORE_DATA.events;
+        if(header == NULL) {
+                return;
+        }
+        unsigned long long position = atomic_fetch_add_explicit(&header->head, 1, memory_order_relaxed);
+        struct TJames_Event *event = (struct TJames_Event*)(header + 1) + (position & (header->capacity - 1));
+        atomic_store_explicit(&event->sequence, 0, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        event->kind = kind;
+        event->test = (test == SIZE_MAX) ? UINT_MAX : (unsigned)test;
+        event->time_ns = TJames_ClockNs(CLOCK_MONOTONIC) - GLOBAL_CORE_DATA.run_start;
+        for(size_t i = 0; i < 5; ++i) {
+                event->values[i] = (i < value_count) ? values[i] : 0;
+        }
+        atomic_store_explicit(&event->sequence, position + 1, memory_order_release);
+}
+
+// Creates the event file next to `path` and moves it in place once the header
+// and name table are written, so a reader never sees a partial one.
+int TJames_OpenEvents(const char *path)
+{
+        size_t names_size = 0;
+        for(size_t i = 0; i < TJames_TestCount(); ++i) {
+                const struct TJames_TestFuncData *data = &TJames_GetTestFunc(i)->data;
+                names_size += strlen(data->group_name) + strlen(data->func_name) + 2;
+        }
+        size_t names_offset = sizeof(struct TJames_EventHeader) + TJAMES_EVENTS_CAPACITY * sizeof(struct TJames_Event);
+        size_t size = names_offset + names_size;
+
+        size_t length = strlen(path) + 5;
+        char *temp_path = malloc(length);
+        if(temp_path == NULL) {
+                fprintf(stderr, "TJames Error: Memory allocation failed, while creating the event file!\n");
+                return -1;
+        }
+        snprintf(temp_path, length, "%s.tmp", path);
+        int fd = open(temp_path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        void *data = MAP_FAILED;
+        if(fd >= 0 && ftruncate(fd, size) == 0) {
+                data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        if(fd >= 0) {
+                close(fd);
+        }
+        if(data == MAP_FAILED) {
+                fprintf(stderr, "TJames Error: Failed to create the event file '%s': %s!\n", path, strerror(errno));
+                unlink(temp_path);
+                free(temp_path);
+                return -1;
+        }
+
+        struct TJames_EventHeader *header = data;
+        header->version = TJAMES_EVENTS_VERSION;
+        header->test_count = TJames_TestCount();
+        header->capacity = TJAMES_EVENTS_CAPACITY;
+        header->names_offset = names_offset;
+        header->names_size = names_size;
+        header->pid = getpid();
+        atomic_init(&header->head, 0);
+        char *names = (char*)data + names_offset;
+        for(size_t i = 0; i < TJames_TestCount(); ++i) {
+                const struct TJames_TestFuncData *func = &TJames_GetTestFunc(i)->data;
+                size_t group_length = strlen(func->group_name) + 1;
+                size_t name_length = strlen(func->func_name) + 1;
+                memcpy(names, func->group_name, group_length);
+                memcpy(names + group_length, func->func_name, name_length);
+                names += group_length + name_length;
+        }
+        atomic_store_explicit(&header->magic, TJAMES_EVENTS_MAGIC, memory_order_release);
+
+        if(rename(temp_path, path) != 0) {
+                fprintf(stderr, "TJames Error: Failed to create the event file '%s': %s!\n", path, strerror(errno));
+                munmap(data, size);
+                unlink(temp_path);
+                free(temp_path);
+                return -1;
+        }
+        free(temp_path);
+        GLOBAL_CORE_DATA.events = header;
+        GLOBAL_CORE_DATA.events_size = size;
+        return 0;
+}
+
+void TJames_CloseEvents()
+{
+        if(GLOBAL_CORE_DATA.events != NULL) {
+                munmap(GLOBAL_CORE_DATA.events, GLOBAL_CORE_DATA.events_size);
+                GLOBAL_CORE_DATA.events = NULL;
+        }
+}
+
+// Publishes the result of a test together with its errors, as soon as it is
+// known rather than when the test is reported in schedule order.
+void TJames_EmitTestEnd(const size_t index, const struct TJames_ExecContext *context)
+{
+        if(GLOBAL_CORE_DATA.events == NULL) {
+                return;
+        }
+        for(size_t i = 0; i < context->error_list.count; ++i) {
+                const struct TJames_Error *error = LIST_EPTR(struct TJames_Error, context->error_list, i);
+                unsigned long long values[] = { error->line, error->type };
+                TJames_EmitEvent(TEST_ERROR_EVENT, index, values, 2);
+        }
+        const struct TJames_PerfStats *perf = &context->perf;
+        double instructions = (perf->available & (1u << PERF_INSTRUCTIONS)) ? perf->values[PERF_INSTRUCTIONS] : 0.0;
+        unsigned long long values[] = {
+                context->last_test_result,
+                (unsigned long long)(context->wall_time * 1e9),
+                (unsigned long long)(context->cpu_time * 1e9),
+                context->allocs.stats.allocations,
+                (unsigned long long)instructions
+        };
+        TJames_EmitEvent(TEST_END_EVENT, index, values, 5);
+}
+
+// *-----------------*
+// |                 |
+// |   TABLE TESTS   |
+// |                 |
+// *-----------------*
+
+// How the results of the rows or cases of a chunk combine into the chunk
+// result: it fails if any failed, otherwise it passes if any passed.
+static const int RESULT_RANK[] = { [EMPTY_TEST] = 0, [SKIPED_TEST] = 1, [SUCCESSFUL_TEST] = 2, [FAILED_TEST] = 3, [CACHED_TEST] = 2 };
+
+// Runs the table function on every row of the chunk.
+void TJames_RunTableChunk(const struct TJames_Chunk *chunk, struct TJames_ExecContext *context)
+{
+        const char *cursor = chunk->table->data + chunk->begin;
+        const char *end = chunk->table->data + chunk->end;
+        enum TJames_TestResult chunk_result = EMPTY_TEST;
+
+        struct TJames_Row row;
+        row.index = chunk->first_row;
+        while(cursor < end) {
+                const char *line_end = memchr(cursor, '\n', end - cursor);
+                if(line_end == NULL) {
+                        line_end = end;
+                }
+                row.data = cursor;
+                row.length = line_end - cursor;
+                if(row.length > 0 && cursor[row.length - 1] == '\r') {
+                        row.length -= 1;
+                }
+
+                context->row = row.index;
+                context->last_test_result = EMPTY_TEST;
+                chunk->table->func_ptr(&row);
+                TJames_CollectPassedChecks(context);
+                if(RESULT_RANK[context->last_test_result] > RESULT_RANK[chunk_result]) {
+                        chunk_result = context->last_test_result;
+                }
+
+                row.index += 1;
+                cursor = (line_end < end) ? line_end + 1 : end;
+        }
+        context->row = SIZE_MAX;
+        context->last_test_result = chunk_result;
+}
+
+// *--------------------*
+// |                    |
+// |   PROPERTY TESTS   |
+// |                    |
+// *--------------------*
+
+// Runs a shrinking attempt may take before the smallest failing case found so
+// far is reported.
+#define TJAMES_PROPERTY_SHRINK_RUNS 1024
+
+// xoshiro256** state, seeded through splitmix64.
+struct TJames_Rng
+{
+        unsigned long long state[4];
+};
+
+// The arguments of the case being run, in buffers allocated once per chunk.
+struct TJames_PropertyCase
+{
+        struct TJames_Value *values;
+        char **buffers; // per argument, max_length + 1 bytes
+        char *scratch; // a copy of the buffer being shrunk
+};
+
+unsigned long long TJames_SplitMix(unsigned long long *state)
+{
+        unsigned long long z = (*state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+}
+
+// Every case has a stream of its own, derived from the seed and its number
+// only, so a case is generated the same no matter which chunk or thread runs it.
+void TJames_SeedRng(struct TJames_Rng *rng, const unsigned long long seed, const size_t number)
+{
+        unsigned long long state = seed ^ (number * 0xD1B54A32D192ED03ull);
+        for(size_t i = 0; i < 4; ++i) {
+                rng->state[i] = TJames_SplitMix(&state);
+        }
+}
+
+static inline unsigned long long TJames_RotateLeft(const unsigned long long value, const int bits)
+{
+        return (value << bits) | (value >> (64 - bits));
+}
+
+static inline unsigned long long TJames_NextRandom(struct TJames_Rng *rng)
+{
+        unsigned long long *s = rng->state;
+        unsigned long long result = TJames_RotateLeft(s[1] * 5, 7) * 9;
+        unsigned long long t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = TJames_RotateLeft(s[3], 45);
+        return result;
+}
+
+// The value shrinking moves a integer towards: 0, or the bound closest to it.
+long long TJames_IntTarget(const struct TJames_Gen *gen)
+{
+        if(gen->min > 0) {
+                return gen->min;
+        }
+        return (gen->max < 0) ? gen->max : 0;
+}
+
+double TJames_FloatTarget(const struct TJames_Gen *gen)
+{
+        if(gen->min_float > 0.0) {
+                return gen->min_float;
+        }
+        return (gen->max_float < 0.0) ? gen->max_float : 0.0;
+}
+
+// One value in eight is a edge of its range, where bugs gather.
+void TJames_GenerateValue(const struct TJames_Gen *gen, struct TJames_Rng *rng, struct TJames_Value *value, char *buffer)
+{
+        unsigned long long bits = TJames_NextRandom(rng);
+        int edge = (bits & 7) == 0;
+        unsigned long long pick = bits >> 3;
+        value->i = 0;
+        value->f = 0.0;
+        value->data = NULL;
+        value->length = 0;
+
+        switch(gen->kind)
+        {
+        case INT_GEN: {
+                unsigned long long span = (unsigned long long)gen->max - (unsigned long long)gen->min;
+                if(edge) {
+                        long long edges[] = { gen->min, gen->max, TJames_IntTarget(gen) };
+                        value->i = edges[pick % 3];
+                } else if(span == ULLONG_MAX) {
+                        value->i = (long long)TJames_NextRandom(rng);
+                } else {
+                        value->i = (long long)((unsigned long long)gen->min + TJames_NextRandom(rng) % (span + 1));
+                }
+                return;
+        }
+        case FLOAT_GEN:
+                if(edge) {
+                        double edges[] = { gen->min_float, gen->max_float, TJames_FloatTarget(gen) };
+                        value->f = edges[pick % 3];
+                } else {
+                        double unit = (TJames_NextRandom(rng) >> 11) * 0x1.0p-53;
+                        value->f = gen->min_float + unit * (gen->max_float - gen->min_float);
+                }
+                return;
+        case STRING_GEN:
+        case BYTES_GEN: {
+                size_t length = (edge) ? ((pick & 1) ? gen->max_length : 0) : pick % (gen->max_length + 1);
+                if(gen->kind == BYTES_GEN) {
+                        for(size_t i = 0; i < length; i += 8) {
+                                unsigned long long random = TJames_NextRandom(rng);
+                                memcpy(buffer + i, &random, (length - i < 8) ? length - i : 8);
+                        }
+                } else if(gen->alphabet != NULL) {
+                        size_t alphabet_length = strlen(gen->alphabet);
+                        for(size_t i = 0; i < length; ++i) {
+                                buffer[i] = gen->alphabet[TJames_NextRandom(rng) % alphabet_length];
+                        }
+                } else {
+                        for(size_t i = 0; i < length; ++i) {
+                                buffer[i] = ' ' + TJames_NextRandom(rng) % 95;
+                        }
+                }
+                buffer[length] = '\0';
+                value->data = buffer;
+                value->length = length;
+                return;
+        }
+        }
+}
+
+void TJames_GenerateCase(const struct TJames_Property *property,
+        const unsigned long long seed,
+        const size_t number,
+        struct TJames_PropertyCase *current)
+{
+        struct TJames_Rng rng;
+        TJames_SeedRng(&rng, seed, number);
+        for(size_t i = 0; i < property->gen_count; ++i) {
+                TJames_GenerateValue(&property->gens[i], &rng, &current->values[i], current->buffers[i]);
+        }
+}
+
+void TJames_FreePropertyCase(struct TJames_PropertyCase *current)
+{
+        free(current->values);
+        free(current->buffers);
+        free(current->scratch);
+}
+
+int TJames_AllocPropertyCase(const struct TJames_Property *property, struct TJames_PropertyCase *current)
+{
+        size_t buffer_size = 0;
+        size_t largest = 0;
+        for(size_t i = 0; i < property->gen_count; ++i) {
+                buffer_size += property->gens[i].max_length + 1;
+                if(property->gens[i].max_length + 1 > largest) {
+                        largest = property->gens[i].max_length + 1;
+                }
+        }
+        // The buffers share one block behind the pointers to them.
+        current->values = calloc(property->gen_count + 1, sizeof(struct TJames_Value));
+        current->buffers = malloc((property->gen_count + 1) * sizeof(char*) + buffer_size);
+        current->scratch = malloc(largest);
+        if(current->values == NULL || current->buffers == NULL || current->scratch == NULL) {
+                TJames_FreePropertyCase(current);
+                return -1;
+        }
+        char *buffer = (char*)(current->buffers + property->gen_count + 1);
+        for(size_t i = 0; i < property->gen_count; ++i) {
+                current->buffers[i] = buffer;
+                buffer += property->gens[i].max_length + 1;
+        }
+        return 0;
+}
+
+// Runs the property on a shrinking candidate, with whatever it reports
+// dropped. Returns 1 if the candidate still fails.
+int TJames_PropertyFails(const struct TJames_Property *property,
+        const struct TJames_PropertyCase *current,
+        struct TJames_ExecContext *context,
+        size_t *budget)
+{
+        size_t error_count = context->error_list.count;
+        int stream_fd = context->stream_fd;
+        context->stream_fd = -1;
+        context->last_test_result = EMPTY_TEST;
+        property->func_ptr(current->values);
+        TJames_PassedChecks = 0;
+        context->stream_fd = stream_fd;
+        context->error_list.count = error_count;
+        *budget -= 1;
+        return context->last_test_result == FAILED_TEST;
+}
+
+// Midpoint of two integers, without overflowing.
+static inline long long TJames_IntMidpoint(const long long a, const long long b)
+{
+        return a / 2 + b / 2 + (a % 2 + b % 2) / 2;
+}
+
+// Moves a numeric argument towards its target: to the target itself if that
+// still fails, otherwise by bisecting between the closest passing and the
+// closest failing value. Returns 1 if the argument got smaller.
+int TJames_ShrinkNumber(const struct TJames_Property *property,
+        struct TJames_PropertyCase *current,
+        const size_t index,
+        struct TJames_ExecContext *context,
+        size_t *budget)
+{
+        const struct TJames_Gen *gen = &property->gens[index];
+        struct TJames_Value *value = &current->values[index];
+        if(gen->kind == INT_GEN) {
+                long long original = value->i;
+                long long failing = original;
+                long long passing = TJames_IntTarget(gen);
+                if(failing == passing) {
+                        return 0;
+                }
+                value->i = passing;
+                if(TJames_PropertyFails(property, current, context, budget)) {
+                        return 1;
+                }
+                while(*budget > 0) {
+                        long long middle = TJames_IntMidpoint(passing, failing);
+                        if(middle == passing || middle == failing) {
+                                break;
+                        }
+                        value->i = middle;
+                        if(TJames_PropertyFails(property, current, context, budget)) {
+                                failing = middle;
+                        } else {
+                                passing = middle;
+                        }
+                }
+                value->i = failing;
+                return failing != original;
+        }
+
+        double original = value->f;
+        double failing = original;
+        double passing = TJames_FloatTarget(gen);
+        if(failing == passing) {
+                return 0;
+        }
+        value->f = passing;
+        if(TJames_PropertyFails(property, current, context, budget)) {
+                return 1;
+        }
+        // Bisecting doubles down to neighbours takes over a thousand runs,
+        // a few dozen get close enough to read.
+        for(size_t step = 0; step < 64 && *budget > 0; ++step) {
+                double middle = passing + (failing - passing) / 2.0;
+                if(middle == passing || middle == failing) {
+                        break;
+                }
+                value->f = middle;
+                if(TJames_PropertyFails(property, current, context, budget)) {
+                        failing = middle;
+                } else {
+                        passing = middle;
+                }
+        }
+        value->f = trunc(failing);
+        if(*budget == 0 || value->f == failing || value->f < gen->min_float || value->f > gen->max_float ||
+                !TJames_PropertyFails(property, current, context, budget)) {
+                value->f = failing;
+        }
+        return value->f != original;
+}
+
+// Shortens a string or byte argument by cutting out ever smaller slices, then
+// replaces what is left with the simplest element one at a time.
+int TJames_ShrinkBuffer(const struct TJames_Property *property,
+        struct TJames_PropertyCase *current,
+        const size_t index,
+        struct TJames_ExecContext *context,
+        size_t *budget)
+{
+        const struct TJames_Gen *gen = &property->gens[index];
+        struct TJames_Value *value = &current->values[index];
+        char *data = current->buffers[index];
+        char *scratch = current->scratch;
+        int shrunk = 0;
+
+        for(size_t size = value->length; size > 0 && *budget > 0; size /= 2) {
+                size_t start = 0;
+                while(start + size <= value->length && *budget > 0) {
+                        size_t length = value->length;
+                        memcpy(scratch, data, length);
+                        memmove(data + start, data + start + size, length - start - size);
+                        value->length = length - size;
+                        data[value->length] = '\0';
+                        if(TJames_PropertyFails(property, current, context, budget)) {
+                                shrunk = 1;
+                                continue;
+                        }
+                        memcpy(data, scratch, length);
+                        value->length = length;
+                        data[length] = '\0';
+                        start += size;
+                }
+        }
+
+        char simplest = '\0';
+        if(gen->kind == STRING_GEN) {
+                simplest = (gen->alphabet != NULL) ? gen->alphabet[0] : 'a';
+        }
+        for(size_t i = 0; i < value->length && *budget > 0; ++i) {
+                if(data[i] == simplest) {
+                        continue;
+                }
+                char original = data[i];
+                data[i] = simplest;
+                if(TJames_PropertyFails(property, current, context, budget)) {
+                        shrunk = 1;
+                } else {
+                        data[i] = original;
+                }
+        }
+        return shrunk;
+}
+
+// Shrinks the arguments of a failing case in turn, until none of them gets
+// smaller or the runs are used up. Returns the number of runs it took.
+size_t TJames_ShrinkCase(const struct TJames_Property *property,
+        struct TJames_PropertyCase *current,
+        struct TJames_ExecContext *context)
+{
+        size_t budget = TJAMES_PROPERTY_SHRINK_RUNS;
+        int progress = 1;
+        while(progress && budget > 0) {
+                progress = 0;
+                for(size_t i = 0; i < property->gen_count && budget > 0; ++i) {
+                        int shrunk = (property->gens[i].kind == INT_GEN || property->gens[i].kind == FLOAT_GEN)
+                                ? TJames_ShrinkNumber(property, current, i, context, &budget)
+                                : TJames_ShrinkBuffer(property, current, i, context, &budget);
+                        if(shrunk) {
+                                progress = 1;
+                        }
+                }
+        }
+        return TJAMES_PROPERTY_SHRINK_RUNS - budget;
+}
+
+// Writes a argument the way it would be written in C, long strings and
+// buffers are cut off.
+void TJames_FormatValue(const struct TJames_Gen *gen, const struct TJames_Value *value, char *out, const size_t size)
+{
+        static const size_t SHOWN_BYTES = 64;
+        switch(gen->kind)
+        {
+        case INT_GEN:
+                snprintf(out, size, "%lld", value->i);
+                return;
+        case FLOAT_GEN:
+                snprintf(out, size, "%.17g", value->f);
+                return;
+        case STRING_GEN:
+        case BYTES_GEN: {
+                size_t used = 0;
+                size_t shown = (value->length < SHOWN_BYTES) ? value->length : SHOWN_BYTES;
+                const unsigned char *data = (const unsigned char*)value->data;
+                used += snprintf(out + used, size - used, "%s", (gen->kind == STRING_GEN) ? "\"" : "{");
+                for(size_t i = 0; i < shown && used < size; ++i) {
+                        if(gen->kind == BYTES_GEN) {
+                                used += snprintf(out + used, size - used, (i > 0) ? ", 0x%02x" : "0x%02x", data[i]);
+                        } else if(data[i] == '"' || data[i] == '\\') {
+                                used += snprintf(out + used, size - used, "\\%c", data[i]);
+                        } else if(data[i] < ' ' || data[i] > '~') {
+                                used += snprintf(out + used, size - used, "\\x%02x", data[i]);
+                        } else {
+                                used += snprintf(out + used, size - used, "%c", data[i]);
+                        }
+                }
+                if(used < size) {
+                        snprintf(out + used, size - used, "%s%s (%lu bytes)",
+                                (shown < value->length) ? "..." : "",
+                                (gen->kind == STRING_GEN) ? "\"" : "}",
+                                value->length);
+                }
+                return;
+        }
+        }
+}
+
+// Reports the shrunk counterexample, then runs the property on it once more so
+// its own errors are reported too.
+void TJames_ReportCounterexample(const struct TJames_Property *property,
+        const struct TJames_PropertyCase *current,
+        const size_t number,
+        const size_t runs,
+        struct TJames_ExecContext *context)
+{
+        struct TJames_AllocTracker *tracker = THREAD_ALLOCS;
+        THREAD_ALLOCS = NULL;
+        const char *arguments = "";
+        for(size_t i = 0; i < property->gen_count; ++i) {
+                char text[512];
+                TJames_FormatValue(&property->gens[i], &current->values[i], text, sizeof(text));
+                arguments = TJames_ArenaPrintf(&context->arena, "%s\n        values[%lu] = %s", arguments, i, text);
+        }
+        TJames_PushContextError(context, NORMAL_ERROR, 0,
+                "Property falsified by case %lu of --seed %llu, shrunk in %lu runs to:%s",
+                number, context->seed, runs, arguments);
+        THREAD_ALLOCS = tracker;
+
+        context->last_test_result = EMPTY_TEST;
+        property->func_ptr(current->values);
+        TJames_PassedChecks = 0;
+        if(context->last_test_result != FAILED_TEST) {
+                THREAD_ALLOCS = NULL;
+                TJames_PushContextError(context, WARNING_ERROR, 0,
+                        "The shrunk case passed when run again, the property is not deterministic");
+                THREAD_ALLOCS = tracker;
+        }
+        context->last_test_result = FAILED_TEST;
+}
+
+// Runs the property on every case of the chunk and stops at the first one
+// that fails, which is shrunk and reported.
+void TJames_RunPropertyChunk(const struct TJames_Chunk *chunk, struct TJames_ExecContext *context)
+{
+        const struct TJames_Property *property = chunk->property;
+        struct TJames_PropertyCase current;
+
+        // Only the allocations of the property itself are the test's.
+        struct TJames_AllocTracker *tracker = THREAD_ALLOCS;
+        THREAD_ALLOCS = NULL;
+        if(TJames_AllocPropertyCase(property, &current) != 0) {
+                TJames_PushContextError(context, CRITICAL_ERROR, 0, "Memory allocation failed, while generating cases");
+                THREAD_ALLOCS = tracker;
+                context->last_test_result = FAILED_TEST;
+                return;
+        }
+        THREAD_ALLOCS = tracker;
+
+        enum TJames_TestResult chunk_result = EMPTY_TEST;
+        for(size_t number = chunk->begin; number < chunk->end; ++number) {
+                TJames_GenerateCase(property, context->seed, number, &current);
+                context->last_test_result = EMPTY_TEST;
+                property->func_ptr(current.values);
+                TJames_CollectPassedChecks(context);
+                if(context->last_test_result == FAILED_TEST) {
+                        size_t runs = TJames_ShrinkCase(property, &current, context);
+                        TJames_ReportCounterexample(property, &current, number, runs, context);
+                        chunk_result = FAILED_TEST;
+                        break;
+                }
+                if(RESULT_RANK[context->last_test_result] > RESULT_RANK[chunk_result]) {
+                        chunk_result = context->last_test_result;
+                }
+        }
+
+        THREAD_ALLOCS = NULL;
+        TJames_FreePropertyCase(&current);
+        THREAD_ALLOCS = tracker;
+        context->last_test_result = chunk_result;
+}
+
+// Returns the timeout of a test in seconds, 0 if it may run forever.
+double TJames_TestTimeout(const struct TJames_TestFunc *func)
+{
+        if(func->data.timeout_ms > 0) {
+                return func->data.timeout_ms / 1000.0;
+        }
+        return GLOBAL_CORE_DATA.options.timeout;
+}
+
+// Reports a test of the result cache as cached without running it.
+void TJames_SkipCachedTest(const size_t index, struct TJames_ExecContext *context)
+{
+        context->wall_time = 0.0;
+        context->cpu_time = 0.0;
+        memset(&context->allocs.stats, 0, sizeof(context->allocs.stats));
+        memset(&context->perf, 0, sizeof(context->perf));
+        TJames_SetContextResult(context, CACHED_TEST);
+        TJames_PushContextError(context, WARNING_ERROR, TJames_GetTestFunc(index)->data.added_on_line,
+                "Cached, passed before with fingerprint %016llx", GLOBAL_CORE_DATA.runs[index].fingerprint);
+        TJames_EmitEvent(TEST_BEGIN_EVENT, index, NULL, 0);
+        TJames_EmitTestEnd(index, context);
+}
+
+void TJames_ExecuteTestFunc(const size_t index, struct TJames_ExecContext *context)
+{
+        const struct TJames_TestFunc *func = TJames_GetTestFunc(index);
+        context->last_test_result = EMPTY_TEST;
+        TJames_ClearErrorList(context);
+        if(GLOBAL_CORE_DATA.runs[index].cached) {
+                TJames_SkipCachedTest(index, context);
+                return;
+        }
+
+        THREAD_CONTEXT = context;
+        TJames_PassedChecks = 0;
+        TJames_EmitEvent(TEST_BEGIN_EVENT, index, NULL, 0);
+        struct TJames_Fixture *fixture = GLOBAL_CORE_DATA.runs[index].fixture;
+        int ready = (fixture == NULL) || TJames_EnterFixture(fixture, context);
+
+        struct TJames_Watch *watch = THREAD_WATCH;
+        double timeout = TJames_TestTimeout(func);
+        if(watch != NULL && timeout > 0.0) {
+                unsigned long long now = TJames_ClockNs(CLOCK_MONOTONIC);
+                watch->index = index;
+                watch->start = now;
+                watch->deadline = now + (unsigned long long)(timeout * 1e9);
+        }
+
+        struct TJames_PerfGroup *perf = THREAD_PERF;
+        memset(&context->perf, 0, sizeof(context->perf));
+        if(ready) {
+                if(perf != NULL) {
+                        TJames_StartPerfCounters(perf);
+                }
+                TJames_StartAllocTracking(context);
+        }
+
+        // The instrumentation stays outside of the clocks, and the CPU interval
+        // inside the wall interval, so the CPU time never exceeds the wall time.
+        unsigned long long wall_start = TJames_ClockNs(CLOCK_MONOTONIC);
+        unsigned long long cpu_start = TJames_ClockNs(CLOCK_THREAD_CPUTIME_ID);
+        if(ready) {
+                if(func->chunk != NULL && func->chunk->kind == TABLE_CHUNK) {
+                        TJames_RunTableChunk(func->chunk, context);
+                } else if(func->chunk != NULL) {
+                        TJames_RunPropertyChunk(func->chunk, context);
+                } else {
+                        func->func_ptr();
+                        TJames_CollectPassedChecks(context);
+                }
+        }
+        unsigned long long cpu_end = TJames_ClockNs(CLOCK_THREAD_CPUTIME_ID);
+        unsigned long long wall_end = TJames_ClockNs(CLOCK_MONOTONIC);
+
+        if(ready) {
+                TJames_StopAllocTracking(context);
+                if(perf != NULL) {
+                        TJames_StopPerfCounters(perf, &context->perf);
+                }
+        }
+        if(watch != NULL) {
+                watch->deadline = 0;
+        }
+
+        context->wall_time = (wall_end - wall_start) / 1e9;
+        context->cpu_time = (cpu_end - cpu_start) / 1e9;
+        if(fixture != NULL) {
+                TJames_LeaveFixture(fixture, context, ready);
+        }
+        THREAD_CONTEXT = NULL;
+        // A isolated child may still die, its parent publishes the result.
+        if(context->stream_fd < 0) {
+                TJames_EmitTestEnd(index, context);
+        }
+}
+
+// Reports a executed test, records its result and timing in the run and
+// hands its context back to the pool. Returns 1 if the test passed.
+int TJames_FinishTestFunc(const size_t index, struct TJames_ExecContext *context)
+{
+        const struct TJames_TestFunc *func = TJames_GetTestFunc(index);
+        struct TJames_TestRun *run = &GLOBAL_CORE_DATA.runs[index];
+        TJames_FormatDeferredErrors(context);
+
+        double time_budget = GLOBAL_CORE_DATA.options.time_budget;
+        if(time_budget > 0.0 && context->wall_time > time_budget) {
+                run->over_budget = 1;
+                TJames_PushContextError(context, WARNING_ERROR, 0,
+                        "Test took %.3f ms, exceeding the time budget of %.3f ms",
+                        context->wall_time * 1e3, time_budget * 1e3);
+        }
+
+        if(context->last_test_result == EMPTY_TEST) {
+                TJames_PushContextError(context, WARNING_ERROR, 0, "Empty Test");
+        }
+
+        run->result = context->last_test_result;
+        run->wall_time = context->wall_time;
+        run->cpu_time = context->cpu_time;
+        run->allocs = context->allocs.stats;
+        run->perf = context->perf;
+
+        GLOBAL_CORE_DATA.reported_tests += 1;
+        GLOBAL_CORE_DATA.reporter->end_test(&GLOBAL_CORE_DATA.writer, GLOBAL_CORE_DATA.reported_tests,
+                &func->data, run, context);
+
+        int passed = TJames_TestPassed(run->result);
+        TJames_ReleaseContext(context);
+        return passed;
+}
+
+// Hands a executed test to the reporter. The watchdog takes over the reporter
+// when it aborts the run, so this is serialized with it.
+int TJames_ReportTestFunc(const size_t index, struct TJames_ExecContext *context)
+{
+        const struct TJames_TestFunc *func = TJames_GetTestFunc(index);
+        pthread_mutex_lock(&GLOBAL_CORE_DATA.report_mutex);
+        GLOBAL_CORE_DATA.reporter->begin_test(&GLOBAL_CORE_DATA.writer, &func->data);
+        int passed = TJames_FinishTestFunc(index, context);
+        pthread_mutex_unlock(&GLOBAL_CORE_DATA.report_mutex);
+        return passed;
+}
+
+// Returns 1 if the test passed, 0 if it failed and -1 if it could not run.
+int TJames_RunTestFunc(const size_t index)
+{
+        struct TJames_ExecContext *context = TJames_AcquireContext();
+        if(context == NULL) {
+                return -1;
+        }
+
+        TJames_ExecuteTestFunc(index, context);
+        TJames_ReleaseFixture(index);
+
+        return TJames_ReportTestFunc(index, context);
+}
+
+// Drops the tests that were not reported from the schedule, so the summaries
+// only cover what was reported. Returns how many tests were dropped.
+size_t TJames_DropUnreportedTests()
+{
+        size_t scheduled_tests = GLOBAL_CORE_DATA.schedule_count;
+        GLOBAL_CORE_DATA.schedule_count = GLOBAL_CORE_DATA.reported_tests;
+        for(size_t i = GLOBAL_CORE_DATA.reported_tests; i < scheduled_tests; ++i) {
+                GLOBAL_CORE_DATA.runs[GLOBAL_CORE_DATA.schedule[i]].scheduled = 0;
+        }
+        return scheduled_tests - GLOBAL_CORE_DATA.reported_tests;
+}
+
+// *--------------*
+// |              |
+// |   WATCHDOG   |
+// |              |
+// *--------------*
+
+// A test that overran its timeout in this process can not be stopped, so the
+// watchdog reports everything that finished before it in schedule order, up
+// to the first test that is still running, then the timed out test itself and
+// the summary, and ends the process. The tests still running count as not run.
+void TJames_AbortTimedOutTest(const size_t timed_out_index, const double elapsed)
+{
+        pthread_mutex_lock(&GLOBAL_CORE_DATA.report_mutex);
+
+        for(size_t i = GLOBAL_CORE_DATA.reported_tests; i < GLOBAL_CORE_DATA.schedule_count; ++i) {
+                size_t index = GLOBAL_CORE_DATA.schedule[i];
+                if(index == timed_out_index) {
+                        break;
+                }
+                pthread_mutex_lock(&GLOBAL_CORE_DATA.run_mutex);
+                struct TJames_ExecContext *context = GLOBAL_CORE_DATA.runs[index].context;
+                pthread_mutex_unlock(&GLOBAL_CORE_DATA.run_mutex);
+                if(context == NULL) {
+                        break;
+                }
+                GLOBAL_CORE_DATA.reporter->begin_test(&GLOBAL_CORE_DATA.writer, &TJames_GetTestFunc(index)->data);
+                TJames_FinishTestFunc(index, context);
+        }
+
+        struct TJames_RunSummary summary;
+        summary.failed_tests = 0;
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.reported_tests; ++i) {
+                enum TJames_TestResult result = GLOBAL_CORE_DATA.runs[GLOBAL_CORE_DATA.schedule[i]].result;
+                if(!TJames_TestPassed(result)) {
+                        summary.failed_tests += 1;
+                }
+        }
+
+        const struct TJames_TestFunc *func = TJames_GetTestFunc(timed_out_index);
+        struct TJames_ExecContext *context = TJames_AcquireContext();
+        if(context != NULL) {
+                TJames_SetContextResult(context, FAILED_TEST);
+                TJames_PushContextError(context, CRITICAL_ERROR, 0,
+                        "Test timed out after %.3f ms, exceeding its timeout of %.3f ms",
+                        elapsed * 1e3, TJames_TestTimeout(func) * 1e3);
+                context->wall_time = elapsed;
+                TJames_EmitTestEnd(timed_out_index, context);
+                GLOBAL_CORE_DATA.reporter->begin_test(&GLOBAL_CORE_DATA.writer, &func->data);
+                TJames_FinishTestFunc(timed_out_index, context);
+                summary.failed_tests += 1;
+        }
+
+        // The process ends right after, so the schedule is left alone, the
+        // workers still read it.
+        summary.test_count = GLOBAL_CORE_DATA.reported_tests;
+        summary.not_run_tests = GLOBAL_CORE_DATA.schedule_count - GLOBAL_CORE_DATA.reported_tests;
+        summary.wall_time = (TJames_ClockNs(CLOCK_MONOTONIC) - GLOBAL_CORE_DATA.run_start) / 1e9;
+        GLOBAL_CORE_DATA.reporter->end_run(&GLOBAL_CORE_DATA.writer, &summary);
+        TJames_FlushWriter(&GLOBAL_CORE_DATA.writer);
+        unsigned long long values[] = { summary.failed_tests, (unsigned long long)(summary.wall_time * 1e9) };
+        TJames_EmitEvent(RUN_END_EVENT, SIZE_MAX, values, 2);
+
+        fprintf(stderr, "TJames Error: Test '%s' timed out, aborting the run with %lu of %lu tests not run!\n",
+                func->data.func_name, summary.not_run_tests, GLOBAL_CORE_DATA.schedule_count);
+        fflush(NULL);
+        // The timed out test is still running, so nothing may be torn down.
+        _exit(EXIT_FAILURE);
+}
+
+void *TJames_WatchdogMain(void *arg)
+{
+        unsigned long long interval = *(unsigned long long*)arg;
+
+        pthread_mutex_lock(&GLOBAL_CORE_DATA.watchdog_mutex);
+        while(!GLOBAL_CORE_DATA.stop_watchdog) {
+                struct timespec wake;
+                clock_gettime(CLOCK_REALTIME, &wake);
+                unsigned long long wake_ns = wake.tv_nsec + interval;
+                wake.tv_sec += wake_ns / 1000000000ull;
+                wake.tv_nsec = wake_ns % 1000000000ull;
+                pthread_cond_timedwait(&GLOBAL_CORE_DATA.watchdog_cond, &GLOBAL_CORE_DATA.watchdog_mutex, &wake);
+
+                unsigned long long now = TJames_ClockNs(CLOCK_MONOTONIC);
+                for(size_t i = 0; i < GLOBAL_CORE_DATA.watch_count; ++i) {
+                        struct TJames_Watch *watch = &GLOBAL_CORE_DATA.watches[i];
+                        unsigned long long deadline = watch->deadline;
+                        if(deadline == 0 || now < deadline) {
+                                continue;
+                        }
+                        size_t index = watch->index;
+                        unsigned long long start = watch->start;
+                        // The thread might have moved on to the next test in between.
+                        if(watch->deadline == deadline) {
+                                TJames_AbortTimedOutTest(index, (now - start) / 1e9);
+                        }
+                }
+        }
+        pthread_mutex_unlock(&GLOBAL_CORE_DATA.watchdog_mutex);
+        return NULL;
+}
+
+// Starts a watchdog over `watch_count` threads if any scheduled test has a
+// timeout. It checks the running tests every tenth of the shortest timeout.
+void TJames_StartWatchdog(const size_t watch_count)
+{
+        double shortest = 0.0;
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.schedule_count; ++i) {
+                double timeout = TJames_TestTimeout(TJames_GetTestFunc(GLOBAL_CORE_DATA.schedule[i]));
+                if(timeout > 0.0 && (shortest == 0.0 || timeout < shortest)) {
+                        shortest = timeout;
+                }
+        }
+        if(shortest == 0.0) {
+                return;
+        }
+
+        GLOBAL_CORE_DATA.watches = calloc(watch_count, sizeof(struct TJames_Watch));
+        if(GLOBAL_CORE_DATA.watches == NULL) {
+                fprintf(stderr, "TJames Error: Memory allocation failed, while starting the watchdog!\n");
+                return;
+        }
+        GLOBAL_CORE_DATA.watch_count = watch_count;
+        GLOBAL_CORE_DATA.stop_watchdog = 0;
+
+        static unsigned long long interval;
+        interval = (unsigned long long)(shortest * 1e8);
+        if(interval < 1000000ull) {
+                interval = 1000000ull;
+        } else if(interval > 100000000ull) {
+                interval = 100000000ull;
+        }
+        if(pthread_create(&GLOBAL_CORE_DATA.watchdog, NULL, TJames_WatchdogMain, &interval) != 0) {
+                fprintf(stderr, "TJames Error: Failed to start the watchdog thread!\n");
+                free(GLOBAL_CORE_DATA.watches);
+                GLOBAL_CORE_DATA.watches = NULL;
+                GLOBAL_CORE_DATA.watch_count = 0;
+        }
+}
+
+void TJames_StopWatchdog()
+{
+        if(GLOBAL_CORE_DATA.watches == NULL) {
+                return;
+        }
+        pthread_mutex_lock(&GLOBAL_CORE_DATA.watchdog_mutex);
+        GLOBAL_CORE_DATA.stop_watchdog = 1;
+        pthread_cond_signal(&GLOBAL_CORE_DATA.watchdog_cond);
+        pthread_mutex_unlock(&GLOBAL_CORE_DATA.watchdog_mutex);
+        pthread_join(GLOBAL_CORE_DATA.watchdog, NULL);
+
+        free(GLOBAL_CORE_DATA.watches);
+        GLOBAL_CORE_DATA.watches = NULL;
+        GLOBAL_CORE_DATA.watch_count = 0;
+}
+
+// Points the calling thread at its watch slot, if there is a watchdog.
+void TJames_SetThreadWatch(const size_t slot)
+{
+        THREAD_WATCH = (slot < GLOBAL_CORE_DATA.watch_count) ? &GLOBAL_CORE_DATA.watches[slot] : NULL;
+}
+
+// *-------------------*
+// |                   |
+// |   WORKER THREADS  |
+// |                   |
+// *-------------------*
+
+// Takes the next schedule position from the front of the workers own queue.
+int TJames_PopWork(struct TJames_Worker *worker, size_t *position)
+{
+        int found = 0;
+        pthread_mutex_lock(&worker->queue.mutex);
+        if(worker->queue.begin < worker->queue.end) {
+                *position = worker->queue.begin++;
+                found = 1;
+        }
+        pthread_mutex_unlock(&worker->queue.mutex);
+        return found;
+}
+
+// Steals the back half of the first non empty queue of another worker.
+int TJames_StealWork(struct TJames_Worker *worker)
+{
+        for(size_t i = 1; i < GLOBAL_CORE_DATA.worker_count; ++i) {
+                struct TJames_Worker *victim = &GLOBAL_CORE_DATA.workers[(worker->id + i) % GLOBAL_CORE_DATA.worker_count];
+
+                pthread_mutex_lock(&victim->queue.mutex);
+                size_t available = victim->queue.end - victim->queue.begin;
+                size_t stolen_begin = victim->queue.end - (available + 1) / 2;
+                size_t stolen_end = victim->queue.end;
+                victim->queue.end = stolen_begin;
+                pthread_mutex_unlock(&victim->queue.mutex);
+
+                if(available == 0) {
+                        continue;
+                }
+
+                pthread_mutex_lock(&worker->queue.mutex);
+                worker->queue.begin = stolen_begin;
+                worker->queue.end = stolen_end;
+                pthread_mutex_unlock(&worker->queue.mutex);
+                return 1;
+        }
+        return 0;
+}
+
+// Lowers the stop position of a --fail-fast run to `position`.
+void TJames_StopAtPosition(const size_t position)
+{
+        size_t current = atomic_load(&GLOBAL_CORE_DATA.stop_position);
+        while(position < current && !atomic_compare_exchange_weak(&GLOBAL_CORE_DATA.stop_position, &current, position)) {
+        }
+}
+
+// Stops the run before `position`, as no execution context was left for its
+// test. Everything before it is still reported, the rest counts as not run.
+void TJames_AbortAtPosition(const size_t position)
+{
+        size_t current = atomic_load(&GLOBAL_CORE_DATA.abort_position);
+        while(position < current && !atomic_compare_exchange_weak(&GLOBAL_CORE_DATA.abort_position, &current, position)) {
+        }
+        // The reporter might be waiting for exactly that test.
+        pthread_mutex_lock(&GLOBAL_CORE_DATA.run_mutex);
+        pthread_cond_broadcast(&GLOBAL_CORE_DATA.run_cond);
+        pthread_mutex_unlock(&GLOBAL_CORE_DATA.run_mutex);
+}
+
+void *TJames_WorkerMain(void *arg)
+{
+        struct TJames_Worker *worker = arg;
+        size_t position;
+        struct TJames_PerfGroup perf;
+        TJames_SetThreadWatch(worker->id);
+        TJames_BeginThreadPerf(&perf);
+
+        for(;;) {
+                if(!TJames_PopWork(worker, &position)) {
+                        // No test ever creates new work, so once every queue is
+                        // empty the worker is done.
+                        if(!TJames_StealWork(worker)) {
+                                break;
+                        }
+                        continue;
+                }
+
+                // Everything after a failure is dropped with --fail-fast, the
+                // reporter stops there.
+                if(position > atomic_load(&GLOBAL_CORE_DATA.stop_position) ||
+                        position >= atomic_load(&GLOBAL_CORE_DATA.abort_position)) {
+                        continue;
+                }
+                size_t index = GLOBAL_CORE_DATA.schedule[position];
+                struct TJames_ExecContext *context = TJames_AcquireContext();
+                if(context == NULL) {
+                        TJames_AbortAtPosition(position);
+                        continue;
+                }
+                TJames_ExecuteTestFunc(index, context);
+                TJames_ReleaseFixture(index);
+                if(GLOBAL_CORE_DATA.options.fail_fast && context->last_test_result == FAILED_TEST) {
+                        TJames_StopAtPosition(position);
+                }
+
+                pthread_mutex_lock(&GLOBAL_CORE_DATA.run_mutex);
+                GLOBAL_CORE_DATA.runs[index].context = context;
+                pthread_cond_broadcast(&GLOBAL_CORE_DATA.run_cond);
+                pthread_mutex_unlock(&GLOBAL_CORE_DATA.run_mutex);
+        }
+        TJames_EndThreadPerf(&perf);
+        TJames_SetThreadWatch(SIZE_MAX);
+        return NULL;
+}
+
+size_t TJames_RunSerial()
+{
+        size_t failed_tests = 0;
+        struct TJames_PerfGroup perf;
+        TJames_SetThreadWatch(0);
+        TJames_BeginThreadPerf(&perf);
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.schedule_count; ++i)
+        {
+                size_t index = GLOBAL_CORE_DATA.schedule[i];
+                int result = TJames_RunTestFunc(index);
+                if(result < 0) {
+                        TJames_AbortAtPosition(i);
+                        break;
+                }
+                if(!result){
+                        failed_tests += 1;
+                }
+                if(GLOBAL_CORE_DATA.options.fail_fast && GLOBAL_CORE_DATA.runs[index].result == FAILED_TEST) {
+                        break;
+                }
+        }
+        TJames_EndThreadPerf(&perf);
+        TJames_SetThreadWatch(SIZE_MAX);
+        return failed_tests;
+}
+
+// Runs the tests on a pool of worker threads. Every worker starts with a
+// contiguous slice of the schedule and steals from the others once it runs
+// dry, while this thread reports the finished tests in schedule order.
+size_t TJames_RunParallel()
+{
+        size_t test_count = GLOBAL_CORE_DATA.schedule_count;
+        size_t worker_count = GLOBAL_CORE_DATA.options.jobs;
+        if(worker_count > test_count) {
+                worker_count = test_count;
+        }
+
+        GLOBAL_CORE_DATA.workers = calloc(worker_count, sizeof(struct TJames_Worker));
+        if(GLOBAL_CORE_DATA.workers == NULL) {
+                fprintf(stderr, "TJames Error: Memory allocation failed, while starting the worker threads!\n");
+                return TJames_RunSerial();
+        }
+        GLOBAL_CORE_DATA.worker_count = worker_count;
+        atomic_store(&GLOBAL_CORE_DATA.stop_position, SIZE_MAX);
+
+        for(size_t i = 0; i < worker_count; ++i) {
+                struct TJames_Worker *worker = &GLOBAL_CORE_DATA.workers[i];
+                worker->id = i;
+                worker->queue.begin = test_count * i / worker_count;
+                worker->queue.end = test_count * (i + 1) / worker_count;
+                pthread_mutex_init(&worker->queue.mutex, NULL);
+        }
+
+        size_t started_workers = 0;
+        for(; started_workers < worker_count; ++started_workers) {
+                struct TJames_Worker *worker = &GLOBAL_CORE_DATA.workers[started_workers];
+                if(pthread_create(&worker->thread, NULL, TJames_WorkerMain, worker) != 0) {
+                        fprintf(stderr, "TJames Error: Failed to start worker thread %lu!\n", started_workers);
+                        break;
+                }
+        }
+        if(started_workers == 0) {
+                // Nothing is running yet, so the queues can be drained right here.
+                TJames_WorkerMain(&GLOBAL_CORE_DATA.workers[0]);
+        }
+
+        size_t failed_tests = 0;
+        for(size_t i = 0; i < test_count; ++i) {
+                size_t index = GLOBAL_CORE_DATA.schedule[i];
+                pthread_mutex_lock(&GLOBAL_CORE_DATA.run_mutex);
+                while(GLOBAL_CORE_DATA.runs[index].context == NULL && i < atomic_load(&GLOBAL_CORE_DATA.abort_position)) {
+                        pthread_cond_wait(&GLOBAL_CORE_DATA.run_cond, &GLOBAL_CORE_DATA.run_mutex);
+                }
+                struct TJames_ExecContext *context = GLOBAL_CORE_DATA.runs[index].context;
+                pthread_mutex_unlock(&GLOBAL_CORE_DATA.run_mutex);
+                if(context == NULL) {
+                        break;
+                }
+
+                if(!TJames_ReportTestFunc(index, context)) {
+                        failed_tests += 1;
+                }
+                if(GLOBAL_CORE_DATA.options.fail_fast && GLOBAL_CORE_DATA.runs[index].result == FAILED_TEST) {
+                        TJames_StopAtPosition(i);
+                        break;
+                }
+        }
+
+        for(size_t i = 0; i < started_workers; ++i) {
+                pthread_join(GLOBAL_CORE_DATA.workers[i].thread, NULL);
+        }
+        for(size_t i = 0; i < worker_count; ++i) {
+                pthread_mutex_destroy(&GLOBAL_CORE_DATA.workers[i].queue.mutex);
+        }
+        free(GLOBAL_CORE_DATA.workers);
+        GLOBAL_CORE_DATA.workers = NULL;
+        GLOBAL_CORE_DATA.worker_count = 0;
+        return failed_tests;
+}
+
+// *----------------------*
+// |                      |
+// |   ISOLATED PROCESSES |
+// |                      |
+// *----------------------*
+
+// Runs in the forked child: executes the test while every pushed error is
+// streamed to the parent right away, so nothing is lost if the test crashes.
+void TJames_ChildMain(const size_t index, struct TJames_ExecContext *context, const int fd)
+{
+        context->stream_fd = fd;
+        struct TJames_PerfGroup perf;
+        TJames_BeginThreadPerf(&perf);
+        TJames_ExecuteTestFunc(index, context);
+        TJames_EndThreadPerf(&perf);
+
+        struct TJames_ChildRecord record;
+        if(context->allocs.stats.tracked) {
+                record.kind = CHILD_ALLOC_RECORD;
+                record.value = 0;
+                record.line = 0;
+                record.length = sizeof(struct TJames_AllocStats);
+                record.wall_time = 0.0;
+                record.cpu_time = 0.0;
+                TJames_WriteChildRecord(fd, &record, (const char*)&context->allocs.stats);
+        }
+        if(context->perf.available != 0) {
+                record.kind = CHILD_PERF_RECORD;
+                record.value = 0;
+                record.line = 0;
+                record.length = sizeof(struct TJames_PerfStats);
+                record.wall_time = 0.0;
+                record.cpu_time = 0.0;
+                TJames_WriteChildRecord(fd, &record, (const char*)&context->perf);
+        }
+
+        record.kind = CHILD_RESULT_RECORD;
+        record.value = context->last_test_result;
+        record.line = 0;
+        record.length = 0;
+        record.wall_time = context->wall_time;
+        record.cpu_time = context->cpu_time;
+        int status = TJames_WriteChildRecord(fd, &record, NULL);
+
+        fflush(NULL);
+        _exit(status == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+// Returns 0 once the test runs in its process, 1 if it was cached and -1 if
+// it failed before it could run. The context of the child is only left NULL
+// if none could be acquired.
+int TJames_SpawnChild(struct TJames_Child *child, const size_t index)
+{
+        const struct TJames_TestFunc *func = TJames_GetTestFunc(index);
+
+        child->index = index;
+        child->has_result = 0;
+        child->timed_out = 0;
+        child->pid = -1;
+        child->fd = -1;
+        TJames_ClearList(&child->buffer);
+        child->context = TJames_AcquireContext();
+        if(child->context == NULL) {
+                return -1;
+        }
+        if(GLOBAL_CORE_DATA.runs[index].cached) {
+                TJames_SkipCachedTest(index, child->context);
+                return 1;
+        }
+
+        int fds[2];
+        if(pipe(fds) != 0) {
+                TJames_SetContextResult(child->context, FAILED_TEST);
+                TJames_PushContextError(child->context, CRITICAL_ERROR, 0,
+                        "Failed to create a pipe for the test process: %s", strerror(errno));
+                return -1;
+        }
+
+        // Built here, every process of the group inherits the same state. There
+        // are no other threads to race with.
+        struct TJames_Fixture *fixture = GLOBAL_CORE_DATA.runs[index].fixture;
+        if(fixture != NULL && !fixture->built) {
+                TJames_BuildFixture(fixture);
+        }
+
+        // Anything still buffered would otherwise be written a second time by the child.
+        fflush(NULL);
+        child->spawn_time = TJames_ClockNs(CLOCK_MONOTONIC);
+        double timeout = TJames_TestTimeout(func);
+        child->deadline = (timeout > 0.0) ? child->spawn_time + (unsigned long long)(timeout * 1e9) : 0;
+
+        pid_t pid = fork();
+        if(pid < 0) {
+                close(fds[0]);
+                close(fds[1]);
+                TJames_SetContextResult(child->context, FAILED_TEST);
+                TJames_PushContextError(child->context, CRITICAL_ERROR, 0,
+                        "Failed to fork the test process: %s", strerror(errno));
+                return -1;
+        }
+        if(pid == 0) {
+                close(fds[0]);
+                TJames_ChildMain(index, child->context, fds[1]);
+        }
+
+        close(fds[1]);
+        child->pid = pid;
+        child->fd = fds[0];
+        return 0;
+}
+
+// Moves every complete record out of the childs receive buffer into its context.
+void TJames_ParseChildRecords(struct TJames_Child *child)
+{
+        size_t offset = 0;
+        char *data = child->buffer.data;
+
+        while(child->buffer.count - offset >= sizeof(struct TJames_ChildRecord)) {
+                struct TJames_ChildRecord record;
+                memcpy(&record, data + offset, sizeof(record));
+                if(child->buffer.count - offset - sizeof(record) < record.length) {
+                        break;
+                }
+                const char *message = data + offset + sizeof(record);
+
+                switch(record.kind)
+                {
+                case CHILD_ERROR_RECORD:
+                        TJames_PushContextError(child->context, (enum TJames_ErrorType)record.value, record.line,
+                                "%.*s", (int)record.length, message);
+                        break;
+                case CHILD_RESULT_RECORD:
+                        child->context->last_test_result = (enum TJames_TestResult)record.value;
+                        child->context->wall_time = record.wall_time;
+                        child->context->cpu_time = record.cpu_time;
+                        child->has_result = 1;
+                        break;
+                case CHILD_ALLOC_RECORD:
+                        if(record.length == sizeof(struct TJames_AllocStats)) {
+                                memcpy(&child->context->allocs.stats, message, sizeof(struct TJames_AllocStats));
+                        }
+                        break;
+                case CHILD_PERF_RECORD:
+                        if(record.length == sizeof(struct TJames_PerfStats)) {
+                                memcpy(&child->context->perf, message, sizeof(struct TJames_PerfStats));
+                        }
+                        break;
+                }
+                offset += sizeof(record) + record.length;
+        }
+
+        if(offset > 0) {
+                memmove(data, data + offset, child->buffer.count - offset);
+                child->buffer.count -= offset;
+        }
+}
+
+// Reaps a child whose pipe was closed and turns anything but a clean exit
+// into a critical error of its test.
+void TJames_ReapChild(struct TJames_Child *child)
+{
+        int status = 0;
+        while(waitpid(child->pid, &status, 0) < 0 && errno == EINTR) {
+        }
+        close(child->fd);
+        child->fd = -1;
+
+        struct TJames_ExecContext *context = child->context;
+        if(!child->has_result) {
+                // The test never reported its own timing, so the lifetime of the process has to do.
+                context->wall_time = (TJames_ClockNs(CLOCK_MONOTONIC) - child->spawn_time) / 1e9;
+        }
+        if(child->timed_out) {
+                TJames_SetContextResult(context, FAILED_TEST);
+                TJames_PushContextError(context, CRITICAL_ERROR, 0,
+                        "Test timed out after %.3f ms, exceeding its timeout of %.3f ms, the process was killed",
+                        context->wall_time * 1e3, TJames_TestTimeout(TJames_GetTestFunc(child->index)) * 1e3);
+        } else if(WIFSIGNALED(status)) {
+                TJames_SetContextResult(context, FAILED_TEST);
+                TJames_PushContextError(context, CRITICAL_ERROR, 0, "Test process was killed by signal %d (%s)",
+                        WTERMSIG(status), strsignal(WTERMSIG(status)));
+        } else if(WIFEXITED(status) && WEXITSTATUS(status) != 0) {
+                TJames_SetContextResult(context, FAILED_TEST);
+                TJames_PushContextError(context, CRITICAL_ERROR, 0, "Test process exited with code %d",
+                        WEXITSTATUS(status));
+        } else if(!child->has_result) {
+                TJames_SetContextResult(context, FAILED_TEST);
+                TJames_PushContextError(context, CRITICAL_ERROR, 0, "Test process exited before the test finished");
+        }
+        TJames_EmitTestEnd(child->index, context);
+}
+
+// Runs every test in its own forked process with up to `jobs` processes alive
+// at once. Results are reported in schedule order as they become available.
+size_t TJames_RunIsolated()
+{
+        size_t test_count = GLOBAL_CORE_DATA.schedule_count;
+        size_t child_count = GLOBAL_CORE_DATA.options.jobs;
+        if(child_count > test_count) {
+                child_count = test_count;
+        }
+
+        struct TJames_Child *children = calloc(child_count, sizeof(struct TJames_Child));
+        struct pollfd *poll_fds = calloc(child_count, sizeof(struct pollfd));
+        size_t *poll_children = calloc(child_count, sizeof(size_t));
+        if(children == NULL || poll_fds == NULL || poll_children == NULL) {
+                fprintf(stderr, "TJames Error: Memory allocation failed, while starting the test processes!\n");
+                free(children);
+                free(poll_fds);
+                free(poll_children);
+                return TJames_RunSerial();
+        }
+        for(size_t i = 0; i < child_count; ++i) {
+                children[i].pid = -1;
+                children[i].fd = -1;
+                children[i].buffer = TJames_CreateList(sizeof(char));
+        }
+
+        size_t failed_tests = 0;
+        size_t next_spawn = 0;
+        size_t next_report = 0;
+        int stopping = 0; // a test failed with --fail-fast or no context was left, no more are started
+        int stopped = 0; // and once it is reported, no more are reported
+        while(next_report < test_count) {
+                for(size_t i = 0; i < child_count && next_spawn < test_count && !stopping; ++i) {
+                        struct TJames_Child *child = &children[i];
+                        if(child->context != NULL) {
+                                continue;
+                        }
+                        size_t index = GLOBAL_CORE_DATA.schedule[next_spawn];
+                        if(TJames_SpawnChild(child, index) != 0) {
+                                if(child->context == NULL) {
+                                        // The running tests are still waited for and reported.
+                                        TJames_AbortAtPosition(next_spawn);
+                                        stopping = 1;
+                                        break;
+                                }
+                                TJames_ReleaseFixture(index);
+                                GLOBAL_CORE_DATA.runs[index].context = child->context;
+                                child->context = NULL;
+                        }
+                        ++next_spawn;
+                }
+
+                size_t poll_count = 0;
+                int poll_timeout = -1;
+                unsigned long long now = TJames_ClockNs(CLOCK_MONOTONIC);
+                for(size_t i = 0; i < child_count; ++i) {
+                        struct TJames_Child *child = &children[i];
+                        if(child->context != NULL && child->deadline != 0 && !child->timed_out) {
+                                if(now >= child->deadline) {
+                                        // Killing closes the pipe, so the child is reaped like any other.
+                                        kill(child->pid, SIGKILL);
+                                        child->timed_out = 1;
+                                } else {
+                                        int remaining = (int)((child->deadline - now + 999999) / 1000000);
+                                        if(poll_timeout < 0 || remaining < poll_timeout) {
+                                                poll_timeout = remaining;
+                                        }
+                                }
+                        }
+                        if(children[i].context != NULL) {
+                                poll_fds[poll_count].fd = children[i].fd;
+                                poll_fds[poll_count].events = POLLIN;
+                                poll_fds[poll_count].revents = 0;
+                                poll_children[poll_count] = i;
+                                ++poll_count;
+                        }
+                }
+                if(poll_count == 0 && stopping) {
+                        break;
+                }
+
+                if(poll_count > 0 && poll(poll_fds, poll_count, poll_timeout) < 0 && errno != EINTR) {
+                        fprintf(stderr, "TJames Error: Waiting for the test processes failed: %s\n", strerror(errno));
+                        break;
+                }
+
+                for(size_t i = 0; i < poll_count; ++i) {
+                        if(poll_fds[i].revents == 0) {
+                                continue;
+                        }
+                        struct TJames_Child *child = &children[poll_children[i]];
+
+                        char chunk[4096];
+                        ssize_t received = read(child->fd, chunk, sizeof(chunk));
+                        if(received < 0 && errno == EINTR) {
+                                continue;
+                        }
+                        if(received > 0) {
+                                TJames_AddRangeToList(&child->buffer, chunk, received);
+                                TJames_ParseChildRecords(child);
+                                continue;
+                        }
+
+                        TJames_ReapChild(child);
+                        TJames_ReleaseFixture(child->index);
+                        if(GLOBAL_CORE_DATA.options.fail_fast && child->context->last_test_result == FAILED_TEST) {
+                                stopping = 1;
+                        }
+                        GLOBAL_CORE_DATA.runs[child->index].context = child->context;
+                        child->context = NULL;
+                }
+
+                // With --fail-fast nothing after the first failure is reported,
+                // the running tests are only waited for.
+                while(next_report < test_count && next_report < atomic_load(&GLOBAL_CORE_DATA.abort_position) && !stopped) {
+                        size_t index = GLOBAL_CORE_DATA.schedule[next_report];
+                        if(GLOBAL_CORE_DATA.runs[index].context == NULL) {
+                                break;
+                        }
+                        if(!TJames_ReportTestFunc(index, GLOBAL_CORE_DATA.runs[index].context)) {
+                                failed_tests += 1;
+                        }
+                        if(GLOBAL_CORE_DATA.options.fail_fast && GLOBAL_CORE_DATA.runs[index].result == FAILED_TEST) {
+                                stopping = 1;
+                                stopped = 1;
+                        }
+                        ++next_report;
+                }
+        }
+
+        for(size_t i = 0; i < child_count; ++i) {
+                TJames_DestroyList(&children[i].buffer);
+        }
+        free(children);
+        free(poll_fds);
+        free(poll_children);
+        return failed_tests;
+}
+
+// *---------------------------*
+// |                           |
+// |   TEST INDEX & SELECTION  |
+// |                           |
+// *---------------------------*
+
+unsigned long long TJames_HashString(unsigned long long hash, const char *string)
+{
+        // FNV-1a
+        for(; *string != '\0'; ++string) {
+                hash ^= (unsigned char)*string;
+                hash *= 0x100000001b3ull;
+        }
+        return hash;
+}
+
+unsigned long long TJames_HashGroup(const char *group_name)
+{
+        return TJames_HashString(0xcbf29ce484222325ull, group_name);
+}
+
+unsigned long long TJames_HashTest(const char *group_name, const char *func_name)
+{
+        unsigned long long hash = TJames_HashGroup(group_name);
+        hash ^= '/';
+        hash *= 0x100000001b3ull;
+        return TJames_HashString(hash, func_name);
+}
+
+// Doubles the slot array and reinserts every entry, `hash_of` maps a stored
+// position back to its hash.
+int TJames_GrowSlots(size_t **slots, size_t *slot_count, unsigned long long (*hash_of)(const size_t position))
+{
+        size_t new_count = (*slot_count == 0) ? 64 : *slot_count * 2;
+        size_t *new_slots = calloc(new_count, sizeof(size_t));
+        if(new_slots == NULL) {
+                fprintf(stderr, "TJames Error: Memory allocation failed, while growing the test index!\n");
+                return -1;
+        }
+        for(size_t i = 0; i < *slot_count; ++i) {
+                if((*slots)[i] == 0) {
+                        continue;
+                }
+                size_t slot = hash_of((*slots)[i] - 1) & (new_count - 1);
+                while(new_slots[slot] != 0) {
+                        slot = (slot + 1) & (new_count - 1);
+                }
+                new_slots[slot] = (*slots)[i];
+        }
+        free(*slots);
+        *slots = new_slots;
+        *slot_count = new_count;
+        return 0;
+}
+
+unsigned long long TJames_GroupPositionHash(const size_t position)
+{
+        return LIST_EPTR(struct TJames_IndexGroup, GLOBAL_CORE_DATA.index.groups, position)->hash;
+}
+
+unsigned long long TJames_TestPositionHash(const size_t position)
+{
+        const struct TJames_TestFunc *func = TJames_GetTestFunc(position);
+        return TJames_HashTest(func->data.group_name, func->data.func_name);
+}
+
+struct TJames_IndexGroup *TJames_FindIndexGroup(const char *group_name)
+{
+        struct TJames_TestIndex *index = &GLOBAL_CORE_DATA.index;
+        if(index->group_slot_count == 0) {
+                return NULL;
+        }
+        size_t slot = TJames_HashGroup(group_name) & (index->group_slot_count - 1);
+        while(index->group_slots[slot] != 0) {
+                struct TJames_IndexGroup *group = LIST_EPTR(struct TJames_IndexGroup, index->groups, index->group_slots[slot] - 1);
+                if(strcmp(group->group_name, group_name) == 0) {
+                        return group;
+                }
+                slot = (slot + 1) & (index->group_slot_count - 1);
+        }
+        return NULL;
+}
+
+int TJames_IndexTest(const size_t test_index)
+{
+        struct TJames_TestIndex *index = &GLOBAL_CORE_DATA.index;
+        const struct TJames_TestFunc *func = TJames_GetTestFunc(test_index);
+
+        struct TJames_IndexGroup *group = TJames_FindIndexGroup(func->data.group_name);
+        if(group == NULL) {
+                if((index->groups.count + 1) * 2 > index->group_slot_count &&
+                        TJames_GrowSlots(&index->group_slots, &index->group_slot_count, TJames_GroupPositionHash) != 0) {
+                        return -1;
+                }
+                struct TJames_IndexGroup new_group;
+                new_group.group_name = func->data.group_name;
+                new_group.hash = TJames_HashGroup(func->data.group_name);
+                new_group.tests = TJames_CreateList(sizeof(size_t));
+                if(TJames_AddToList(&index->groups, &new_group) != 0) {
+                        return -1;
+                }
+
+                size_t slot = new_group.hash & (index->group_slot_count - 1);
+                while(index->group_slots[slot] != 0) {
+                        slot = (slot + 1) & (index->group_slot_count - 1);
+                }
+                index->group_slots[slot] = index->groups.count;
+                group = LIST_EPTR(struct TJames_IndexGroup, index->groups, index->groups.count - 1);
+        }
+        if(TJames_AddToList(&group->tests, &test_index) != 0) {
+                return -1;
+        }
+
+        if((index->indexed_tests + 1) * 2 > index->test_slot_count &&
+                TJames_GrowSlots(&index->test_slots, &index->test_slot_count, TJames_TestPositionHash) != 0) {
+                return -1;
+        }
+        size_t slot = TJames_TestPositionHash(test_index) & (index->test_slot_count - 1);
+        while(index->test_slots[slot] != 0) {
+                slot = (slot + 1) & (index->test_slot_count - 1);
+        }
+        index->test_slots[slot] = test_index + 1;
+        index->indexed_tests += 1;
+        return 0;
+}
+
+// Tests from the tjames_tests section have no registration call, so they are
+// indexed on first use.
+void TJames_EnsureIndex()
+{
+        if(GLOBAL_CORE_DATA.index.indexed_static) {
+                return;
+        }
+        GLOBAL_CORE_DATA.index.indexed_static = 1;
+        for(size_t i = 0; i < TJames_StaticTestCount(); ++i) {
+                TJames_IndexTest(i);
+        }
+}
+
+// Returns the index of the test, or SIZE_MAX if there is no such test.
+size_t TJames_FindTest(const char *group_name, const char *func_name)
+{
+        TJames_EnsureIndex();
+        struct TJames_TestIndex *index = &GLOBAL_CORE_DATA.index;
+        if(index->test_slot_count == 0) {
+                return SIZE_MAX;
+        }
+        size_t slot = TJames_HashTest(group_name, func_name) & (index->test_slot_count - 1);
+        while(index->test_slots[slot] != 0) {
+                const struct TJames_TestFunc *func = TJames_GetTestFunc(index->test_slots[slot] - 1);
+                if(strcmp(func->data.group_name, group_name) == 0 && strcmp(func->data.func_name, func_name) == 0) {
+                        return index->test_slots[slot] - 1;
+                }
+                slot = (slot + 1) & (index->test_slot_count - 1);
+        }
+        return SIZE_MAX;
+}
+
+// '*' matches any run of characters and '?' any single one. A pattern without
+// either matches every string containing it.
+int TJames_MatchPattern(const char *pattern, const size_t length, const char *string)
+{
+        if(memchr(pattern, '*', length) == NULL && memchr(pattern, '?', length) == NULL) {
+                size_t string_length = strlen(string);
+                for(size_t i = 0; i + length <= string_length; ++i) {
+                        if(memcmp(string + i, pattern, length) == 0) {
+                                return 1;
+                        }
+                }
+                return 0;
+        }
+
+        size_t p = 0;
+        const char *s = string;
+        size_t star = SIZE_MAX;
+        const char *star_string = NULL;
+        while(*s != '\0') {
+                if(p < length && (pattern[p] == '?' || pattern[p] == *s)) {
+                        ++p;
+                        ++s;
+                } else if(p < length && pattern[p] == '*') {
+                        star = p++;
+                        star_string = s;
+                } else if(star != SIZE_MAX) {
+                        p = star + 1;
+                        s = ++star_string;
+                } else {
+                        return 0;
+                }
+        }
+        while(p < length && pattern[p] == '*') {
+                ++p;
+        }
+        return p == length;
+}
+
+int TJames_FilterMatches(const struct TJames_Filter *filter, const struct TJames_TestFuncData *func)
+{
+        if(filter->group != NULL) {
+                return TJames_MatchPattern(filter->group, filter->group_length, func->group_name) &&
+                        TJames_MatchPattern(filter->func, filter->func_length, func->func_name);
+        }
+        return TJames_MatchPattern(filter->func, filter->func_length, func->group_name) ||
+                TJames_MatchPattern(filter->func, filter->func_length, func->func_name);
+}
+
+int TJames_AnyFilterMatches(const struct TJames_List *filters, const struct TJames_TestFuncData *func)
+{
+        for(size_t i = 0; i < filters->count; ++i) {
+                if(TJames_FilterMatches(LIST_EPTR(struct TJames_Filter, (*filters), i), func)) {
+                        return 1;
+                }
+        }
+        return 0;
+}
+
+// Decides for a whole group at once: 1 if every test of the group matches one
+// of the filters, 0 if none can and -1 if the tests have to be checked one by one.
+int TJames_GroupFilterDecision(const struct TJames_List *filters, const char *group_name)
+{
+        int decision = 0;
+        for(size_t i = 0; i < filters->count; ++i) {
+                const struct TJames_Filter *filter = LIST_EPTR(struct TJames_Filter, (*filters), i);
+                if(filter->group == NULL) {
+                        if(TJames_MatchPattern(filter->func, filter->func_length, group_name)) {
+                                return 1;
+                        }
+                        decision = -1;
+                } else if(TJames_MatchPattern(filter->group, filter->group_length, group_name)) {
+                        if(filter->func_length == 1 && filter->func[0] == '*') {
+                                return 1;
+                        }
+                        decision = -1;
+                }
+        }
+        return decision;
+}
+
+int TJames_CompareSize(const void *a, const void *b)
+{
+        size_t x = *(const size_t*)a;
+        size_t y = *(const size_t*)b;
+        return (x > y) - (x < y);
+}
+
+// Fills the schedule with every test that passes --filter and --exclude, in
+// registration order. Groups are decided through the index first, so the tests
+// of unrelated groups are never looked at.
+int TJames_SelectTests()
+{
+        TJames_EnsureIndex();
+        struct TJames_List *filters = &GLOBAL_CORE_DATA.options.filters;
+        struct TJames_List *excludes = &GLOBAL_CORE_DATA.options.excludes;
+
+        free(GLOBAL_CORE_DATA.schedule);
+        GLOBAL_CORE_DATA.schedule_count = 0;
+        GLOBAL_CORE_DATA.schedule = malloc((TJames_TestCount() + 1) * sizeof(size_t));
+        if(GLOBAL_CORE_DATA.schedule == NULL) {
+                fprintf(stderr, "TJames Error: Memory allocation failed, while selecting the tests!\n");
+                return -1;
+        }
+
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.index.groups.count; ++i) {
+                struct TJames_IndexGroup *group = LIST_EPTR(struct TJames_IndexGroup, GLOBAL_CORE_DATA.index.groups, i);
+                int include = (filters->count == 0) ? 1 : TJames_GroupFilterDecision(filters, group->group_name);
+                int exclude = TJames_GroupFilterDecision(excludes, group->group_name);
+                if(include == 0 || exclude == 1) {
+                        continue;
+                }
+
+                for(size_t j = 0; j < group->tests.count; ++j) {
+                        size_t index = LIST_E(size_t, group->tests, j);
+                        const struct TJames_TestFunc *func = TJames_GetTestFunc(index);
+                        if(include == -1 && !TJames_AnyFilterMatches(filters, &func->data)) {
+                                continue;
+                        }
+                        if(exclude == -1 && TJames_AnyFilterMatches(excludes, &func->data)) {
+                                continue;
+                        }
+                        GLOBAL_CORE_DATA.schedule[GLOBAL_CORE_DATA.schedule_count++] = index;
+                }
+        }
+
+        qsort(GLOBAL_CORE_DATA.schedule, GLOBAL_CORE_DATA.schedule_count, sizeof(size_t), TJames_CompareSize);
+        return 0;
+}
+
+// Splits a comma separated list of patterns into `filters`.
+int TJames_ParseFilters(struct TJames_List *filters, const char *patterns)
+{
+        while(*patterns != '\0') {
+                const char *end = strchr(patterns, ',');
+                if(end == NULL) {
+                        end = patterns + strlen(patterns);
+                }
+
+                if(end > patterns) {
+                        struct TJames_Filter filter;
+                        const char *slash = memchr(patterns, '/', end - patterns);
+                        if(slash != NULL) {
+                                filter.group = patterns;
+                                filter.group_length = slash - patterns;
+                                filter.func = slash + 1;
+                                filter.func_length = end - slash - 1;
+                        } else {
+                                filter.group = NULL;
+                                filter.group_length = 0;
+                                filter.func = patterns;
+                                filter.func_length = end - patterns;
+                        }
+                        if(TJames_AddToList(filters, &filter) != 0) {
+                                return -1;
+                        }
+                }
+                patterns = (*end == ',') ? end + 1 : end;
+        }
+        return 0;
+}
+
+// *--------------*
+// |              |
+// |   SHARDING   |
+// |              |
+// *--------------*
+
+// Reads a timings file into `durations`, indexed by test. Every line holds a
+// group name, a function name and a wall time in seconds, separated by tabs.
+// Later lines win, so the files of several shards can simply be concatenated.
+// Tests without a line are left at -1.
+int TJames_LoadTimings(const char *path, double *durations)
+{
+        FILE *stream = fopen(path, "r");
+        if(stream == NULL) {
+                fprintf(stderr, "TJames Error: Failed to open timings file '%s', balancing by test count!\n", path);
+                return -1;
+        }
+
+        char *line = NULL;
+        size_t line_capacity = 0;
+        while(getline(&line, &line_capacity, stream) > 0) {
+                char *func_name = strchr(line, '\t');
+                char *duration = (func_name != NULL) ? strchr(func_name + 1, '\t') : NULL;
+                if(duration == NULL) {
+                        continue;
+                }
+                *func_name++ = '\0';
+                *duration++ = '\0';
+
+                size_t index = TJames_FindTest(line, func_name);
+                if(index != SIZE_MAX) {
+                        durations[index] = strtod(duration, NULL);
+                }
+        }
+        free(line);
+        fclose(stream);
+        return 0;
+}
+
+// Writes the timings to a temporary file first, so a interrupted run never
+// leaves a truncated file for the next one to balance by.
+int TJames_RecordTimings(const char *path)
+{
+        size_t length = strlen(path) + 5;
+        char *temp_path = malloc(length);
+        FILE *stream = NULL;
+        if(temp_path != NULL) {
+                snprintf(temp_path, length, "%s.tmp", path);
+                stream = fopen(temp_path, "w");
+        }
+        if(stream == NULL) {
+                fprintf(stderr, "TJames Error: Failed to open timings file '%s' for writing!\n", path);
+                free(temp_path);
+                return -1;
+        }
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.schedule_count; ++i) {
+                size_t index = GLOBAL_CORE_DATA.schedule[i];
+                if(GLOBAL_CORE_DATA.runs[index].cached) {
+                        continue;
+                }
+                const struct TJames_TestFunc *func = TJames_GetTestFunc(index);
+                fprintf(stream, "%s\t%s\t%.9f\n", func->data.group_name, func->data.func_name,
+                        GLOBAL_CORE_DATA.runs[index].wall_time);
+        }
+        int failed = fclose(stream) != 0 || rename(temp_path, path) != 0;
+        if(failed) {
+                fprintf(stderr, "TJames Error: Failed to write timings file '%s'!\n", path);
+        }
+        free(temp_path);
+        return failed ? -1 : 0;
+}
+
+static const double *SHARD_DURATIONS;
+
+// Longest first, ties broken by registration order so every shard computes
+// the same assignment.
+int TJames_CompareShardOrder(const void *a, const void *b)
+{
+        size_t x = *(const size_t*)a;
+        size_t y = *(const size_t*)b;
+        if(SHARD_DURATIONS[x] != SHARD_DURATIONS[y]) {
+                return (SHARD_DURATIONS[x] < SHARD_DURATIONS[y]) ? 1 : -1;
+        }
+        return (x > y) - (x < y);
+}
+
+// Narrows the schedule to the tests of --shard-index. The tests are assigned
+// longest first to the currently lightest shard, using the durations of the
+// timings file. Tests without a recorded duration count as the mean of the
+// recorded ones.
+int TJames_ShardTests()
+{
+        size_t shard_count = GLOBAL_CORE_DATA.options.shard_count;
+        if(shard_count <= 1) {
+                return 0;
+        }
+
+        double *durations = malloc((TJames_TestCount() + 1) * sizeof(double));
+        double *loads = calloc(shard_count, sizeof(double));
+        if(durations == NULL || loads == NULL) {
+                fprintf(stderr, "TJames Error: Memory allocation failed, while sharding the tests!\n");
+                free(durations);
+                free(loads);
+                return -1;
+        }
+        for(size_t i = 0; i < TJames_TestCount(); ++i) {
+                durations[i] = -1.0;
+        }
+        if(GLOBAL_CORE_DATA.options.timings_path != NULL) {
+                TJames_LoadTimings(GLOBAL_CORE_DATA.options.timings_path, durations);
+        }
+
+        double known_time = 0.0;
+        size_t known_count = 0;
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.schedule_count; ++i) {
+                double duration = durations[GLOBAL_CORE_DATA.schedule[i]];
+                if(duration >= 0.0) {
+                        known_time += duration;
+                        known_count += 1;
+                }
+        }
+        double default_duration = (known_count > 0) ? known_time / known_count : 1.0;
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.schedule_count; ++i) {
+                size_t index = GLOBAL_CORE_DATA.schedule[i];
+                if(durations[index] < 0.0) {
+                        durations[index] = default_duration;
+                }
+        }
+
+        SHARD_DURATIONS = durations;
+        qsort(GLOBAL_CORE_DATA.schedule, GLOBAL_CORE_DATA.schedule_count, sizeof(size_t), TJames_CompareShardOrder);
+
+        size_t kept = 0;
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.schedule_count; ++i) {
+                size_t lightest = 0;
+                for(size_t shard = 1; shard < shard_count; ++shard) {
+                        if(loads[shard] < loads[lightest]) {
+                                lightest = shard;
+                        }
+                }
+                size_t index = GLOBAL_CORE_DATA.schedule[i];
+                loads[lightest] += durations[index];
+                if(lightest == GLOBAL_CORE_DATA.options.shard_index) {
+                        GLOBAL_CORE_DATA.schedule[kept++] = index;
+                }
+        }
+        GLOBAL_CORE_DATA.schedule_count = kept;
+        qsort(GLOBAL_CORE_DATA.schedule, GLOBAL_CORE_DATA.schedule_count, sizeof(size_t), TJames_CompareSize);
+
+        SHARD_DURATIONS = NULL;
+        free(durations);
+        free(loads);
+        return 0;
+}
+
+// *------------------*
+// |                  |
+// |   TEST HISTORY   |
+// |                  |
+// *------------------*
+
+// Reads a history file into GLOBAL_CORE_DATA.history. Every line holds a group
+// name, a function name, the wall time of the last run in seconds, the recent
+// results and their flakiness, separated by tabs. A missing file is a empty
+// history.
+int TJames_LoadHistory(const char *path)
+{
+        GLOBAL_CORE_DATA.history = calloc(TJames_TestCount() + 1, sizeof(struct TJames_History));
+        if(GLOBAL_CORE_DATA.history == NULL) {
+                fprintf(stderr, "TJames Error: Memory allocation failed, while loading the test history!\n");
+                return -1;
+        }
+        for(size_t i = 0; i < TJames_TestCount(); ++i) {
+                GLOBAL_CORE_DATA.history[i].duration = -1.0;
+        }
+
+        FILE *stream = fopen(path, "r");
+        if(stream == NULL) {
+                if(errno != ENOENT) {
+                        fprintf(stderr, "TJames Error: Failed to open history file '%s'!\n", path);
+                }
+                return 0;
+        }
+        char *line = NULL;
+        size_t line_capacity = 0;
+        while(getline(&line, &line_capacity, stream) > 0) {
+                char *fields[4] = { line, NULL, NULL, NULL };
+                for(size_t i = 1; i < 4 && fields[i - 1] != NULL; ++i) {
+                        fields[i] = strchr(fields[i - 1], '\t');
+                        if(fields[i] != NULL) {
+                                *fields[i]++ = '\0';
+                        }
+                }
+                if(fields[3] == NULL) {
+                        continue;
+                }
+                size_t index = TJames_FindTest(fields[0], fields[1]);
+                if(index == SIZE_MAX) {
+                        continue;
+                }
+                struct TJames_History *history = &GLOBAL_CORE_DATA.history[index];
+                history->duration = strtod(fields[2], NULL);
+                size_t length = strspn(fields[3], "PF");
+                if(length > TJAMES_HISTORY_LENGTH) {
+                        length = TJAMES_HISTORY_LENGTH;
+                }
+                memcpy(history->results, fields[3], length);
+                history->results[length] = '\0';
+        }
+        free(line);
+        fclose(stream);
+        return 0;
+}
+
+// Runs since the last failure, TJAMES_HISTORY_LENGTH if there was none.
+size_t TJames_FailureAge(const struct TJames_History *history)
+{
+        const char *failure = strchr(history->results, 'F');
+        return (failure != NULL) ? (size_t)(failure - history->results) : TJAMES_HISTORY_LENGTH;
+}
+
+// Fraction of the recent runs whose result differs from the run before.
+double TJames_Flakiness(const struct TJames_History *history)
+{
+        size_t length = strlen(history->results);
+        size_t flips = 0;
+        for(size_t i = 1; i < length; ++i) {
+                flips += history->results[i] != history->results[i - 1];
+        }
+        return (length > 1) ? (double)flips / (length - 1) : 0.0;
+}
+
+// Most recently failed first, the rest shortest first. Tests without a
+// history count as the shortest, ties keep the registration order.
+int TJames_CompareHistoryOrder(const void *a, const void *b)
+{
+        size_t x = *(const size_t*)a;
+        size_t y = *(const size_t*)b;
+        const struct TJames_History *history_x = &GLOBAL_CORE_DATA.history[x];
+        const struct TJames_History *history_y = &GLOBAL_CORE_DATA.history[y];
+        size_t age_x = TJames_FailureAge(history_x);
+        size_t age_y = TJames_FailureAge(history_y);
+        if(age_x != age_y) {
+                return (age_x > age_y) - (age_x < age_y);
+        }
+        if(history_x->duration != history_y->duration) {
+                return (history_x->duration > history_y->duration) ? 1 : -1;
+        }
+        return (x > y) - (x < y);
+}
+
+void TJames_OrderByHistory()
+{
+        qsort(GLOBAL_CORE_DATA.schedule, GLOBAL_CORE_DATA.schedule_count, sizeof(size_t), TJames_CompareHistoryOrder);
+}
+
+// Adds the result and time of every test that ran to the history and writes
+// it. Skipped tests, including cached ones, keep their history.
+int TJames_SaveHistory(const char *path)
+{
+        for(size_t i = 0; i < TJames_TestCount(); ++i) {
+                const struct TJames_TestRun *run = &GLOBAL_CORE_DATA.runs[i];
+                struct TJames_History *history = &GLOBAL_CORE_DATA.history[i];
+                if(!run->scheduled || run->result == SKIPED_TEST || run->result == CACHED_TEST) {
+                        continue;
+                }
+                memmove(history->results + 1, history->results, TJAMES_HISTORY_LENGTH - 1);
+                history->results[0] = (run->result == FAILED_TEST) ? 'F' : 'P';
+                history->results[TJAMES_HISTORY_LENGTH] = '\0';
+                history->duration = run->wall_time;
+        }
+
+        size_t length = strlen(path) + 5;
+        char *temp_path = malloc(length);
+        FILE *stream = NULL;
+        if(temp_path != NULL) {
+                snprintf(temp_path, length, "%s.tmp", path);
+                stream = fopen(temp_path, "w");
+        }
+        if(stream == NULL) {
+                fprintf(stderr, "TJames Error: Failed to open history file '%s' for writing!\n", path);
+                free(temp_path);
+                return -1;
+        }
+        for(size_t i = 0; i < TJames_TestCount(); ++i) {
+                const struct TJames_History *history = &GLOBAL_CORE_DATA.history[i];
+                if(history->results[0] == '\0') {
+                        continue;
+                }
+                const struct TJames_TestFunc *func = TJames_GetTestFunc(i);
+                fprintf(stream, "%s\t%s\t%.9f\t%s\t%.2f\n", func->data.group_name, func->data.func_name,
+                        history->duration, history->results, TJames_Flakiness(history));
+        }
+        int failed = fclose(stream) != 0 || rename(temp_path, path) != 0;
+        if(failed) {
+                fprintf(stderr, "TJames Error: Failed to write history file '%s'!\n", path);
+        }
+        free(temp_path);
+        return failed ? -1 : 0;
+}
+
+// *------------------*
+// |                  |
+// |   RESULT CACHE   |
+// |                  |
+// *------------------*
+
+// The cache file is a header followed by the sorted fingerprints of every test
+// that passed. A test is fingerprinted by the machine code of its function,
+// of every function that code calls directly and of its fixture hooks, along
+// with its registration data and inputs. The initial .rodata and .data of the
+// executable and the build IDs of the loaded libraries are part of every
+// fingerprint, since tests read that data and call into those libraries.
+// Calls through pointers are not followed.
+#define TJAMES_CACHE_MAGIC 0x3145484341434A54ull // "TJCACHE1"
+
+struct TJames_CacheHeader
+{
+        unsigned long long magic;
+        unsigned long long count;
+};
+
+struct TJames_CodeSymbol
+{
+        uintptr_t address;
+        size_t size;
+        unsigned long long hash;
+        int state; // 0 not hashed yet, 1 being hashed, 2 hashed
+};
+
+struct TJames_CodeRange
+{
+        uintptr_t begin;
+        uintptr_t end;
+};
+
+#define TJAMES_MAX_PLT_RANGES 4
+
+struct TJames_CodeIndex
+{
+        struct TJames_CodeSymbol *symbols; // sorted by address
+        size_t count;
+        struct TJames_CodeRange code; // executable segments of the binary
+        struct TJames_CodeRange plt[TJAMES_MAX_PLT_RANGES]; // stubs of calls into libraries
+        size_t plt_count;
+        unsigned long long shared_hash; // of the initial data and the loaded libraries
+};
+
+unsigned long long TJames_HashBytes(unsigned long long hash, const void *data, const size_t size)
+{
+        const unsigned char *bytes = data;
+        for(size_t i = 0; i < size; ++i) {
+                hash ^= bytes[i];
+                hash *= 0x100000001b3ull;
+        }
+        return hash;
+}
+
+unsigned long long TJames_HashNumber(const unsigned long long hash, const unsigned long long number)
+{
+        return TJames_HashBytes(hash, &number, sizeof(number));
+}
+
+// Hashes a string together with its length, so neighbouring strings can not
+// trade characters. NULL hashes like "".
+unsigned long long TJames_HashField(const unsigned long long hash, const char *string)
+{
+        if(string == NULL) {
+                string = "";
+        }
+        return TJames_HashString(TJames_HashNumber(hash, strlen(string)), string);
+}
+
+int TJames_CompareCodeSymbol(const void *a, const void *b)
+{
+        uintptr_t x = ((const struct TJames_CodeSymbol*)a)->address;
+        uintptr_t y = ((const struct TJames_CodeSymbol*)b)->address;
+        return (x > y) - (x < y);
+}
+
+int TJames_CompareFingerprint(const void *a, const void *b)
+{
+        unsigned long long x = *(const unsigned long long*)a;
+        unsigned long long y = *(const unsigned long long*)b;
+        return (x > y) - (x < y);
+}
+
+#ifdef TJAMES_CODE_SYMBOLS
+// Hashes the build ID of a loaded library, or its file if it has none. The
+// executable is skipped, its code and data are hashed on their own, while its
+// build ID would change with any edit.
+int TJames_HashLoadedObject(struct dl_phdr_info *info, size_t size, void *data)
+{
+        (void)size;
+        unsigned long long *hash = data;
+        if(info->dlpi_name == NULL || info->dlpi_name[0] == '\0') {
+                return 0;
+        }
+        int found = 0;
+        for(size_t i = 0; i < info->dlpi_phnum; ++i) {
+                const ElfW(Phdr) *header = &info->dlpi_phdr[i];
+                if(header->p_type != PT_NOTE) {
+                        continue;
+                }
+                size_t align = (header->p_align == 8) ? 8 : 4;
+                const unsigned char *note = (const unsigned char*)(info->dlpi_addr + header->p_vaddr);
+                const unsigned char *end = note + header->p_memsz;
+                while(note + sizeof(ElfW(Nhdr)) <= end) {
+                        const ElfW(Nhdr) *entry = (const ElfW(Nhdr)*)note;
+                        const unsigned char *name = note + sizeof(ElfW(Nhdr));
+                        const unsigned char *desc = name + ((entry->n_namesz + align - 1) & ~(align - 1));
+                        if(desc + entry->n_descsz > end) {
+                                break;
+                        }
+                        if(entry->n_type == NT_GNU_BUILD_ID && entry->n_namesz == 4 && memcmp(name, "GNU", 4) == 0) {
+                                *hash = TJames_HashBytes(*hash, desc, entry->n_descsz);
+                                found = 1;
+                        }
+                        note = desc + ((entry->n_descsz + align - 1) & ~(align - 1));
+                }
+        }
+        struct stat file;
+        if(!found) {
+                *hash = TJames_HashField(*hash, info->dlpi_name);
+        }
+        if(!found && stat(info->dlpi_name, &file) == 0) {
+                *hash = TJames_HashNumber(*hash, file.st_ino);
+                *hash = TJames_HashNumber(*hash, file.st_size);
+                *hash = TJames_HashNumber(*hash, file.st_mtim.tv_sec);
+                *hash = TJames_HashNumber(*hash, file.st_mtim.tv_nsec);
+        }
+        return 0;
+}
+#endif
+
+// Reads the function symbols of the running executable from its symbol table
+// and relocates them to where it is loaded, along with the ranges of its code
+// and call stubs. Hashes its initial data and the loaded libraries. Returns -1
+// if there is no symbol table.
+int TJames_LoadCodeSymbols(struct TJames_CodeIndex *index)
+{
+        index->symbols = NULL;
+        index->count = 0;
+        index->code.begin = UINTPTR_MAX;
+        index->code.end = 0;
+        index->plt_count = 0;
+        index->shared_hash = 0xcbf29ce484222325ull;
+#ifdef TJAMES_CODE_SYMBOLS
+        const Elf64_Phdr *program_headers = (const Elf64_Phdr*)getauxval(AT_PHDR);
+        size_t program_header_count = getauxval(AT_PHNUM);
+        uintptr_t base = 0;
+        int found_base = 0;
+        for(size_t i = 0; program_headers != NULL && i < program_header_count; ++i) {
+                if(program_headers[i].p_type == PT_PHDR) {
+                        base = (uintptr_t)program_headers - program_headers[i].p_vaddr;
+                        found_base = 1;
+                }
+        }
+        for(size_t i = 0; found_base && i < program_header_count; ++i) {
+                const Elf64_Phdr *segment = &program_headers[i];
+                if(segment->p_type == PT_LOAD && (segment->p_flags & PF_X)) {
+                        if(base + segment->p_vaddr < index->code.begin) {
+                                index->code.begin = base + segment->p_vaddr;
+                        }
+                        if(base + segment->p_vaddr + segment->p_memsz > index->code.end) {
+                                index->code.end = base + segment->p_vaddr + segment->p_memsz;
+                        }
+                }
+        }
+
+        int fd = open("/proc/self/exe", O_RDONLY | O_CLOEXEC);
+        struct stat info;
+        if(!found_base || fd < 0 || fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(Elf64_Ehdr)) {
+                if(fd >= 0) {
+                        close(fd);
+                }
+                return -1;
+        }
+        const unsigned char *data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if(data == MAP_FAILED) {
+                return -1;
+        }
+
+        size_t size = info.st_size;
+        const Elf64_Ehdr *header = (const Elf64_Ehdr*)data;
+        if(memcmp(header->e_ident, ELFMAG, SELFMAG) != 0 || header->e_ident[EI_CLASS] != ELFCLASS64 ||
+                header->e_shoff + header->e_shnum * sizeof(Elf64_Shdr) > size) {
+                munmap((void*)data, size);
+                return -1;
+        }
+        const Elf64_Shdr *sections = (const Elf64_Shdr*)(data + header->e_shoff);
+        const Elf64_Shdr *names = (header->e_shstrndx < header->e_shnum) ? &sections[header->e_shstrndx] : NULL;
+        for(size_t i = 0; names != NULL && names->sh_offset + names->sh_size <= size && i < header->e_shnum; ++i) {
+                if(sections[i].sh_name >= names->sh_size) {
+                        continue;
+                }
+                const char *name = (const char*)(data + names->sh_offset + sections[i].sh_name);
+                if(strnlen(name, names->sh_size - sections[i].sh_name) == names->sh_size - sections[i].sh_name) {
+                        continue;
+                }
+                if((strcmp(name, ".rodata") == 0 || strcmp(name, ".data") == 0) &&
+                        sections[i].sh_type == SHT_PROGBITS && sections[i].sh_offset + sections[i].sh_size <= size) {
+                        index->shared_hash = TJames_HashField(index->shared_hash, name);
+                        index->shared_hash = TJames_HashBytes(index->shared_hash, data + sections[i].sh_offset,
+                                sections[i].sh_size);
+                } else if(strncmp(name, ".plt", 4) == 0 && index->plt_count < TJAMES_MAX_PLT_RANGES) {
+                        index->plt[index->plt_count].begin = base + sections[i].sh_addr;
+                        index->plt[index->plt_count].end = base + sections[i].sh_addr + sections[i].sh_size;
+                        index->plt_count += 1;
+                }
+        }
+        dl_iterate_phdr(TJames_HashLoadedObject, &index->shared_hash);
+
+        struct TJames_List symbols = TJames_CreateList(sizeof(struct TJames_CodeSymbol));
+        for(size_t i = 0; i < header->e_shnum; ++i) {
+                if(sections[i].sh_type != SHT_SYMTAB || sections[i].sh_offset + sections[i].sh_size > size) {
+                        continue;
+                }
+                const Elf64_Sym *entries = (const Elf64_Sym*)(data + sections[i].sh_offset);
+                size_t entry_count = sections[i].sh_size / sizeof(Elf64_Sym);
+                for(size_t j = 0; j < entry_count; ++j) {
+                        // Functions without a size are kept, calls to them make
+                        // a test uncacheable.
+                        if(ELF64_ST_TYPE(entries[j].st_info) != STT_FUNC || entries[j].st_shndx == SHN_UNDEF) {
+                                continue;
+                        }
+                        struct TJames_CodeSymbol symbol;
+                        symbol.address = base + entries[j].st_value;
+                        symbol.size = entries[j].st_size;
+                        symbol.hash = 0;
+                        symbol.state = 0;
+                        if(TJames_AddToList(&symbols, &symbol) != 0) {
+                                break;
+                        }
+                }
+        }
+        munmap((void*)data, size);
+        if(symbols.count == 0) {
+                TJames_DestroyList(&symbols);
+                return -1;
+        }
+
+        // Aliases share their code, one symbol per address is enough.
+        qsort(symbols.data, symbols.count, sizeof(struct TJames_CodeSymbol), TJames_CompareCodeSymbol);
+        struct TJames_CodeSymbol *sorted = symbols.data;
+        size_t count = 1;
+        for(size_t i = 1; i < symbols.count; ++i) {
+                if(sorted[i].address != sorted[count - 1].address) {
+                        sorted[count++] = sorted[i];
+                } else if(sorted[i].size > sorted[count - 1].size) {
+                        sorted[count - 1].size = sorted[i].size;
+                }
+        }
+        index->symbols = sorted;
+        index->count = count;
+        return 0;
+#else
+        return -1;
+#endif
+}
+
+// Returns the index of the first symbol at or after `address`.
+size_t TJames_LowerCodeSymbol(const struct TJames_CodeIndex *index, const uintptr_t address)
+{
+        size_t low = 0;
+        size_t high = index->count;
+        while(low < high) {
+                size_t middle = low + (high - low) / 2;
+                if(index->symbols[middle].address < address) {
+                        low = middle + 1;
+                } else {
+                        high = middle;
+                }
+        }
+        return low;
+}
+
+struct TJames_CodeSymbol *TJames_FindCodeSymbol(const struct TJames_CodeIndex *index, const uintptr_t address)
+{
+        size_t low = TJames_LowerCodeSymbol(index, address);
+        return (low < index->count && index->symbols[low].address == address) ? &index->symbols[low] : NULL;
+}
+
+// Whether `address` lies past the start of a function with a size.
+int TJames_InsideCodeSymbol(const struct TJames_CodeIndex *index, const uintptr_t address)
+{
+        size_t low = TJames_LowerCodeSymbol(index, address);
+        return low > 0 && address < index->symbols[low - 1].address + index->symbols[low - 1].size;
+}
+
+int TJames_InCodeRange(const struct TJames_CodeRange *range, const uintptr_t address)
+{
+        return address >= range->begin && address < range->end;
+}
+
+// Hashes the code of `symbol`. Direct calls and jumps on x86-64 hash their
+// target's code in place of its distance, so a change to a callee changes the
+// hash of its callers, but merely moving code around does not. Calls into
+// libraries hash their stub, the libraries are covered by their build IDs.
+// Returns 0 if the code calls or jumps into code without a symbol or a size,
+// which can not be followed.
+unsigned long long TJames_HashCode(const struct TJames_CodeIndex *index, struct TJames_CodeSymbol *symbol)
+{
+        if(symbol->size == 0) {
+                return 0;
+        }
+        if(symbol->state == 2) {
+                return symbol->hash;
+        }
+        if(symbol->state == 1) {
+                // Recursion, the caller already covers this code.
+                return symbol->size;
+        }
+        symbol->state = 1;
+
+        const unsigned char *code = (const unsigned char*)symbol->address;
+        unsigned long long hash = 0xcbf29ce484222325ull;
+        size_t hashed = 0;
+#ifdef __x86_64__
+        for(size_t i = 0; i + 5 <= symbol->size; ++i) {
+                if(code[i] != 0xE8 && code[i] != 0xE9) {
+                        continue;
+                }
+                int32_t distance;
+                memcpy(&distance, code + i + 1, sizeof(distance));
+                uintptr_t address = symbol->address + i + 5 + distance;
+                struct TJames_CodeSymbol *target = TJames_FindCodeSymbol(index, address);
+                unsigned long long target_hash = 0;
+                for(size_t j = 0; target == NULL && j < index->plt_count; ++j) {
+                        if(TJames_InCodeRange(&index->plt[j], address)) {
+                                target_hash = TJames_HashNumber(0xcbf29ce484222325ull + j, address - index->plt[j].begin);
+                        }
+                }
+                if(target != NULL) {
+                        target_hash = TJames_HashCode(index, target);
+                } else if(target_hash == 0) {
+                        // Jumps within the function are hashed as they are. The
+                        // bytes may just as well be part of another instruction,
+                        // if they lead into the middle of a function or out of
+                        // the code. Anywhere else is code without a symbol.
+                        if(TJames_InsideCodeSymbol(index, address) || !TJames_InCodeRange(&index->code, address)) {
+                                continue;
+                        }
+                }
+                if(target_hash == 0) {
+                        symbol->hash = 0;
+                        symbol->state = 2;
+                        return 0;
+                }
+                hash = TJames_HashBytes(hash, code + hashed, i + 1 - hashed);
+                hash = TJames_HashNumber(hash, target_hash);
+                i += 4;
+                hashed = i + 1;
+        }
+#endif
+        hash = TJames_HashBytes(hash, code + hashed, symbol->size - hashed);
+        if(hash == 0) {
+                hash = 1;
+        }
+
+        symbol->hash = hash;
+        symbol->state = 2;
+        return hash;
+}
+
+// Returns 0 for code without a symbol or calling code without one, which can not
+// be fingerprinted.
+unsigned long long TJames_FingerprintCode(const struct TJames_CodeIndex *index, const void *function)
+{
+        if(function == NULL) {
+                return 0xcbf29ce484222325ull;
+        }
+        struct TJames_CodeSymbol *symbol = TJames_FindCodeSymbol(index, (uintptr_t)function);
+        return (symbol != NULL) ? TJames_HashCode(index, symbol) : 0;
+}
+
+// Returns 0 if the test can not be cached.
+unsigned long long TJames_FingerprintTest(const struct TJames_CodeIndex *index, const size_t test)
+{
+        const struct TJames_TestFunc *func = TJames_GetTestFunc(test);
+        const struct TJames_Chunk *chunk = func->chunk;
+        const struct TJames_Fixture *fixture = GLOBAL_CORE_DATA.runs[test].fixture;
+        const void *code[5] = { (const void*)func->func_ptr, NULL, NULL, NULL, NULL };
+        if(chunk != NULL && chunk->kind == TABLE_CHUNK) {
+                code[0] = (const void*)chunk->table->func_ptr;
+        } else if(chunk != NULL) {
+                code[0] = (const void*)chunk->property->func_ptr;
+        }
+        if(fixture != NULL) {
+                code[1] = (const void*)fixture->group_setup;
+                code[2] = (const void*)fixture->group_teardown;
+                code[3] = (const void*)fixture->test_setup;
+                code[4] = (const void*)fixture->test_teardown;
+        }
+
+        unsigned long long hash = index->shared_hash;
+        for(size_t i = 0; i < 5; ++i) {
+                unsigned long long code_hash = TJames_FingerprintCode(index, code[i]);
+                if(code_hash == 0) {
+                        return 0;
+                }
+                hash = TJames_HashNumber(hash, code_hash);
+        }
+        hash = TJames_HashField(hash, func->data.group_name);
+        hash = TJames_HashField(hash, func->data.func_name);
+        hash = TJames_HashField(hash, func->data.file);
+        hash = TJames_HashNumber(hash, func->data.added_on_line);
+        hash = TJames_HashNumber(hash, func->data.timeout_ms);
+        hash = TJames_HashBytes(hash, &GLOBAL_CORE_DATA.options.timeout, sizeof(GLOBAL_CORE_DATA.options.timeout));
+        hash = TJames_HashNumber(hash, GLOBAL_CORE_DATA.options.track_allocs);
+
+        if(chunk != NULL && chunk->kind == TABLE_CHUNK) {
+                hash = TJames_HashNumber(hash, chunk->first_row);
+                hash = TJames_HashBytes(hash, chunk->table->data + chunk->begin, chunk->end - chunk->begin);
+        } else if(chunk != NULL) {
+                // The cases depend on the seed, random seeds never hit the cache.
+                hash = TJames_HashNumber(hash, GLOBAL_CORE_DATA.options.seed);
+                hash = TJames_HashNumber(hash, chunk->begin);
+                hash = TJames_HashNumber(hash, chunk->end);
+                for(size_t i = 0; i < chunk->property->gen_count; ++i) {
+                        const struct TJames_Gen *gen = &chunk->property->gens[i];
+                        hash = TJames_HashNumber(hash, gen->kind);
+                        hash = TJames_HashNumber(hash, gen->min);
+                        hash = TJames_HashNumber(hash, gen->max);
+                        hash = TJames_HashBytes(hash, &gen->min_float, sizeof(gen->min_float));
+                        hash = TJames_HashBytes(hash, &gen->max_float, sizeof(gen->max_float));
+                        hash = TJames_HashNumber(hash, gen->max_length);
+                        hash = TJames_HashField(hash, gen->alphabet);
+                }
+        }
+        return (hash != 0) ? hash : 1;
+}
+
+// Binary search in the mapped cache file.
+int TJames_IsCached(const unsigned long long fingerprint)
+{
+        const struct TJames_CacheHeader *header = GLOBAL_CORE_DATA.cache;
+        if(header == NULL || fingerprint == 0) {
+                return 0;
+        }
+        const unsigned long long *entries = (const unsigned long long*)(header + 1);
+        return bsearch(&fingerprint, entries, header->count, sizeof(unsigned long long), TJames_CompareFingerprint) != NULL;
+}
+
+// Fingerprints every registered test, so tests outside of this run keep their
+// entries, and marks the scheduled ones that passed before.
+void TJames_PrepareCache(const char *path)
+{
+        struct TJames_CodeIndex index;
+        if(TJames_LoadCodeSymbols(&index) != 0) {
+                fprintf(stderr, "TJames Error: The result cache needs the symbol table of the test binary, running every test!\n");
+                return;
+        }
+        for(size_t i = 0; i < TJames_TestCount(); ++i) {
+                GLOBAL_CORE_DATA.runs[i].fingerprint = TJames_FingerprintTest(&index, i);
+        }
+        free(index.symbols);
+        GLOBAL_CORE_DATA.cache_enabled = 1;
+
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        struct stat info;
+        if(fd < 0 || fstat(fd, &info) != 0) {
+                // No cache yet, it is created after the run.
+                if(fd >= 0) {
+                        close(fd);
+                }
+                return;
+        }
+        void *data = MAP_FAILED;
+        if((size_t)info.st_size >= sizeof(struct TJames_CacheHeader)) {
+                data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+        const struct TJames_CacheHeader *header = data;
+        if(data == MAP_FAILED || header->magic != TJAMES_CACHE_MAGIC ||
+                header->count > (info.st_size - sizeof(struct TJames_CacheHeader)) / sizeof(unsigned long long)) {
+                fprintf(stderr, "TJames Error: Ignoring the invalid result cache '%s'!\n", path);
+                if(data != MAP_FAILED) {
+                        munmap(data, info.st_size);
+                }
+                return;
+        }
+        GLOBAL_CORE_DATA.cache = header;
+        GLOBAL_CORE_DATA.cache_size = info.st_size;
+
+        // Golden files can only be updated by running their tests, and
+        // repeated runs exist to run them.
+        if(GLOBAL_CORE_DATA.options.update_golden ||
+                GLOBAL_CORE_DATA.options.repeat_count > 0 || GLOBAL_CORE_DATA.options.soak_time > 0.0) {
+                return;
+        }
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.schedule_count; ++i) {
+                struct TJames_TestRun *run = &GLOBAL_CORE_DATA.runs[GLOBAL_CORE_DATA.schedule[i]];
+                run->cached = TJames_IsCached(run->fingerprint);
+        }
+}
+
+// Writes the fingerprints of the tests that passed in this run, together with
+// those of earlier runs that still belong to a registered test and were not
+// run again.
+void TJames_SaveCache(const char *path)
+{
+        if(!GLOBAL_CORE_DATA.cache_enabled) {
+                return;
+        }
+        size_t count = 0;
+        unsigned long long *entries = malloc((TJames_TestCount() + 1) * sizeof(unsigned long long));
+        for(size_t i = 0; entries != NULL && i < TJames_TestCount(); ++i) {
+                const struct TJames_TestRun *run = &GLOBAL_CORE_DATA.runs[i];
+                int passed = TJames_TestPassed(run->result);
+                if(run->fingerprint == 0) {
+                        continue;
+                }
+                if((run->scheduled && !run->cached) ? passed : TJames_IsCached(run->fingerprint)) {
+                        entries[count++] = run->fingerprint;
+                }
+        }
+        if(GLOBAL_CORE_DATA.cache != NULL) {
+                munmap((void*)GLOBAL_CORE_DATA.cache, GLOBAL_CORE_DATA.cache_size);
+                GLOBAL_CORE_DATA.cache = NULL;
+        }
+        if(entries == NULL) {
+                fprintf(stderr, "TJames Error: Memory allocation failed, while saving the result cache!\n");
+                return;
+        }
+        qsort(entries, count, sizeof(unsigned long long), TJames_CompareFingerprint);
+        size_t unique = 0;
+        for(size_t i = 0; i < count; ++i) {
+                if(unique == 0 || entries[i] != entries[unique - 1]) {
+                        entries[unique++] = entries[i];
+                }
+        }
+
+        struct TJames_CacheHeader header;
+        header.magic = TJAMES_CACHE_MAGIC;
+        header.count = unique;
+        size_t length = strlen(path) + 5;
+        char *temp_path = malloc(length);
+        FILE *stream = NULL;
+        if(temp_path != NULL) {
+                snprintf(temp_path, length, "%s.tmp", path);
+                stream = fopen(temp_path, "wb");
+        }
+        if(stream == NULL || fwrite(&header, sizeof(header), 1, stream) != 1 ||
+                fwrite(entries, sizeof(unsigned long long), unique, stream) != unique ||
+                fclose(stream) != 0 || rename(temp_path, path) != 0) {
+                fprintf(stderr, "TJames Error: Failed to write the result cache '%s'!\n", path);
+        }
+        free(temp_path);
+        free(entries);
+}
+
+// *------------------*
+// |                  |
+// |   TIME SUMMARY   |
+// |                  |
+// *------------------*
+
+void TJames_ReportGroupTimes(struct TJames_Writer *writer)
+{
+        TJames_WriterPrintf(writer, "\nTime per group:\n");
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.index.groups.count; ++i) {
+                struct TJames_IndexGroup *group = LIST_EPTR(struct TJames_IndexGroup, GLOBAL_CORE_DATA.index.groups, i);
+                struct TJames_GroupTime time = { group->group_name, 0.0, 0.0, 0 };
+                for(size_t j = 0; j < group->tests.count; ++j) {
+                        struct TJames_TestRun *run = &GLOBAL_CORE_DATA.runs[LIST_E(size_t, group->tests, j)];
+                        if(!run->scheduled || run->cached) {
+                                continue;
+                        }
+                        time.wall_time += run->wall_time;
+                        time.cpu_time += run->cpu_time;
+                        time.test_count += 1;
+                }
+                if(time.test_count > 0) {
+                        TJames_WriterPrintf(writer, "    %s: %.3f ms wall, %.3f ms cpu (%lu tests)\n",
+                                time.group_name, time.wall_time * 1e3, time.cpu_time * 1e3, time.test_count);
+                }
+        }
+}
+
+void TJames_ReportSlowestTests(struct TJames_Writer *writer)
+{
+        size_t test_count = GLOBAL_CORE_DATA.schedule_count;
+        size_t slowest_count = GLOBAL_CORE_DATA.options.slowest_count;
+        if(slowest_count > test_count) {
+                slowest_count = test_count;
+        }
+        if(slowest_count == 0) {
+                return;
+        }
+
+        size_t *slowest = malloc(slowest_count * sizeof(size_t));
+        if(slowest == NULL) {
+                return;
+        }
+
+        // Insertion into a small sorted array, the list is only ever a handful long.
+        size_t found = 0;
+        for(size_t i = 0; i < test_count; ++i) {
+                size_t index = GLOBAL_CORE_DATA.schedule[i];
+                if(GLOBAL_CORE_DATA.runs[index].cached) {
+                        continue;
+                }
+                double wall_time = GLOBAL_CORE_DATA.runs[index].wall_time;
+                size_t position = found;
+                while(position > 0 && GLOBAL_CORE_DATA.runs[slowest[position - 1]].wall_time < wall_time) {
+                        --position;
+                }
+                if(position >= slowest_count) {
+                        continue;
+                }
+                size_t last = (found < slowest_count) ? found : slowest_count - 1;
+                memmove(slowest + position + 1, slowest + position, (last - position) * sizeof(size_t));
+                slowest[position] = index;
+                if(found < slowest_count) {
+                        ++found;
+                }
+        }
+
+        TJames_WriterPrintf(writer, "\nSlowest tests:\n");
+        for(size_t i = 0; i < found; ++i) {
+                const struct TJames_TestFunc *func = TJames_GetTestFunc(slowest[i]);
+                struct TJames_TestRun *run = &GLOBAL_CORE_DATA.runs[slowest[i]];
+                TJames_WriterPrintf(writer, "    %lu. ", i + 1);
+                TJames_DumpTestFunc(writer, &func->data);
+                TJames_WriterPrintf(writer, "%.3f ms wall, %.3f ms cpu%s\n", run->wall_time * 1e3, run->cpu_time * 1e3,
+                        run->over_budget ? " (over budget)" : "");
+        }
+        free(slowest);
+}
+
+void TJames_ReportTimes(struct TJames_Writer *writer, const double run_wall_time)
+{
+        double test_wall_time = 0.0;
+        double test_cpu_time = 0.0;
+        size_t over_budget = 0;
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.schedule_count; ++i) {
+                struct TJames_TestRun *run = &GLOBAL_CORE_DATA.runs[GLOBAL_CORE_DATA.schedule[i]];
+                test_wall_time += run->wall_time;
+                test_cpu_time += run->cpu_time;
+                over_budget += run->over_budget;
+        }
+
+        TJames_WriterPrintf(writer, "Total time: %.3f ms wall, tests took %.3f ms wall and %.3f ms cpu\n",
+                run_wall_time * 1e3, test_wall_time * 1e3, test_cpu_time * 1e3);
+        if(GLOBAL_CORE_DATA.options.time_budget > 0.0) {
+                TJames_WriterPrintf(writer, "%lu tests exceeded the time budget of %.3f ms\n",
+                        over_budget, GLOBAL_CORE_DATA.options.time_budget * 1e3);
+        }
+
+        TJames_ReportGroupTimes(writer);
+        TJames_ReportSlowestTests(writer);
+}
+
+// *---------------*
+// |               |
+// |   REPORTERS   |
+// |               |
+// *---------------*
+
+void TJames_WriteJsonString(struct TJames_Writer *writer, const char *string)
+{
+        if(string == NULL) {
+                TJames_WriterWrite(writer, "null", 4);
+                return;
+        }
+        TJames_WriterWrite(writer, "\"", 1);
+        const char *run = string;
+        for(const char *c = string; *c != '\0'; ++c) {
+                unsigned char character = *c;
+                if(character >= 0x20 && character != '"' && character != '\\') {
+                        continue;
+                }
+                TJames_WriterWrite(writer, run, c - run);
+                run = c + 1;
+                switch(character)
+                {
+                case '"':  TJames_WriterWrite(writer, "\\\"", 2); break;
+                case '\\': TJames_WriterWrite(writer, "\\\\", 2); break;
+                case '\n': TJames_WriterWrite(writer, "\\n", 2); break;
+                case '\t': TJames_WriterWrite(writer, "\\t", 2); break;
+                default:   TJames_WriterPrintf(writer, "\\u%04x", character); break;
+                }
+        }
+        TJames_WriterWrite(writer, run, strlen(run));
+        TJames_WriterWrite(writer, "\"", 1);
+}
+
+void TJames_WriteXmlString(struct TJames_Writer *writer, const char *string)
+{
+        const char *run = string;
+        for(const char *c = string; c != NULL && *c != '\0'; ++c) {
+                const char *entity = NULL;
+                switch(*c)
+                {
+                case '<':  entity = "&lt;"; break;
+                case '>':  entity = "&gt;"; break;
+                case '&':  entity = "&amp;"; break;
+                case '"':  entity = "&quot;"; break;
+                case '\'': entity = "&apos;"; break;
+                default:
+                        continue;
+                }
+                TJames_WriterWrite(writer, run, c - run);
+                TJames_WriterWrite(writer, entity, strlen(entity));
+                run = c + 1;
+        }
+        if(run != NULL) {
+                TJames_WriterWrite(writer, run, strlen(run));
+        }
+}
+
+void TJames_NoBeginRun(struct TJames_Writer *writer, const size_t test_count)
+{
+        (void)writer;
+        (void)test_count;
+}
+
+void TJames_NoBeginTest(struct TJames_Writer *writer, const struct TJames_TestFuncData *func)
+{
+        (void)writer;
+        (void)func;
+}
+
+void TJames_NoBench(struct TJames_Writer *writer,
+        const struct TJames_TestFuncData *func,
+        const struct TJames_BenchStats *stats,
+        const struct TJames_ExecContext *context)
+{
+        (void)writer;
+        (void)func;
+        (void)stats;
+        (void)context;
+}
+
+void TJames_NoLoad(struct TJames_Writer *writer,
+        const struct TJames_TestFuncData *func,
+        const struct TJames_LoadStats *steps,
+        const size_t step_count,
+        const struct TJames_ExecContext *context)
+{
+        (void)writer;
+        (void)func;
+        (void)steps;
+        (void)step_count;
+        (void)context;
+}
+
+// Console
+
+void TJames_ConsoleBeginTest(struct TJames_Writer *writer, const struct TJames_TestFuncData *func)
+{
+        TJames_WriterPrintf(writer, "\n");
+        TJames_DumpTestFunc(writer, func);
+}
+
+// Writes every available counter in one line, `unit` is appended to each value.
+void TJames_WritePerfStats(struct TJames_Writer *writer, const struct TJames_PerfStats *stats, const char *unit)
+{
+        if(stats->available == 0) {
+                return;
+        }
+        TJames_WriterPrintf(writer, "   ");
+        for(size_t i = 0; i < PERF_COUNTER_COUNT; ++i) {
+                if(stats->available & (1u << i)) {
+                        TJames_WriterPrintf(writer, " %s %.6g%s", PERF_COUNTER_NAMES[i], stats->values[i], unit);
+                }
+        }
+        double ipc = TJames_PerfIpc(stats);
+        if(ipc > 0.0) {
+                TJames_WriterPrintf(writer, " IPC %.2f", ipc);
+        }
+        TJames_WriterPrintf(writer, "\n");
+}
+
+void TJames_ConsoleEndTest(struct TJames_Writer *writer,
+        const size_t position,
+        const struct TJames_TestFuncData *func,
+        const struct TJames_TestRun *run,
+        const struct TJames_ExecContext *context)
+{
+        (void)position;
+        TJames_ReportTestFuncResult(writer, run->result);
+        if(run->allocs.tracked) {
+                TJames_WriterPrintf(writer, "    %lu allocations, %lu bytes, peak %lu bytes, leaked %lu allocations (%lu bytes)\n",
+                        run->allocs.allocations, run->allocs.bytes, run->allocs.peak_bytes,
+                        run->allocs.leaked_allocations, run->allocs.leaked_bytes);
+        }
+        TJames_WritePerfStats(writer, &run->perf, "");
+        TJames_ReportErrors(writer, func, context);
+}
+
+// Appended to the summary line if the run was aborted or stopped early.
+void TJames_WriteNotRun(struct TJames_Writer *writer, const struct TJames_RunSummary *summary)
+{
+        if(summary->not_run_tests > 0) {
+                TJames_WriterPrintf(writer, ", %lu tests not run", summary->not_run_tests);
+        }
+        TJames_WriterPrintf(writer, "\n");
+}
+
+void TJames_ConsoleEndRun(struct TJames_Writer *writer, const struct TJames_RunSummary *summary)
+{
+        TJames_WriterPrintf(writer, "\nRun a total of %lu tests, with a successrate of %lu/%lu",
+                summary->test_count, summary->test_count - summary->failed_tests, summary->test_count);
+        TJames_WriteNotRun(writer, summary);
+        TJames_ReportTimes(writer, summary->wall_time);
+}
+
+void TJames_ConsoleBench(struct TJames_Writer *writer,
+        const struct TJames_TestFuncData *func,
+        const struct TJames_BenchStats *stats,
+        const struct TJames_ExecContext *context)
+{
+        double ops_per_second = (stats->median > 0.0) ? 1e9 / stats->median : 0.0;
+        TJames_WriterPrintf(writer, "\n%s: [GROUP: %s] [BENCH: %s] ", TJames_FileName(func), func->group_name, func->func_name);
+        TJames_WriterPrintf(writer, "%.2f ns/op, %.0f ops/s\n", stats->median, ops_per_second);
+        TJames_WriterPrintf(writer, "    min %.2f ns, median %.2f ns, p99 %.2f ns, MAD %.2f ns (%lu samples x %lu iterations, %lu outliers)\n",
+                stats->min, stats->median, stats->p99, stats->mad,
+                stats->samples, stats->iterations, stats->outliers);
+        TJames_WritePerfStats(writer, &stats->perf, "/op");
+        TJames_ReportErrors(writer, func, context);
+}
+
+void TJames_ConsoleLoad(struct TJames_Writer *writer,
+        const struct TJames_TestFuncData *func,
+        const struct TJames_LoadStats *steps,
+        const size_t step_count,
+        const struct TJames_ExecContext *context)
+{
+        TJames_WriterPrintf(writer, "\n%s: [GROUP: %s] [LOAD: %s]\n", TJames_FileName(func), func->group_name, func->func_name);
+        for(size_t i = 0; i < step_count; ++i) {
+                const struct TJames_LoadStats *step = &steps[i];
+                TJames_WriterPrintf(writer, "    %3lu threads: %.0f calls/s, %.0f%% efficiency, "
+                        "p50 %.0f ns, p99 %.0f ns, p99.9 %.0f ns, max %.0f ns\n",
+                        step->threads, step->calls_per_second, step->efficiency * 100.0,
+                        step->p50, step->p99, step->p999, step->max);
+        }
+        TJames_ReportErrors(writer, func, context);
+}
+
+void TJames_ConsoleRepeat(struct TJames_Writer *writer,
+        const size_t position,
+        const struct TJames_TestFuncData *func,
+        const struct TJames_RepeatStats *stats,
+        const struct TJames_ExecContext *context)
+{
+        (void)position;
+        const char *verdict = (stats->failures > 0) ? ((stats->flaky) ? "Flaky" : "Failed") :
+                (stats->regressed) ? "Regressed" : (stats->skips == stats->runs) ? "Skipped" : "Success";
+        TJames_WriterPrintf(writer, "\n%s: [GROUP: %s] [FUNC: %s] - %s! %lu of %lu runs failed, %lu skipped\n",
+                TJames_FileName(func), func->group_name, func->func_name, verdict,
+                stats->failures, stats->runs, stats->skips);
+        TJames_WriterPrintf(writer, "    mean %.0f ns, stddev %.0f ns, p50 %.0f ns, p99 %.0f ns, max %.0f ns%s\n",
+                stats->mean, stats->stddev, stats->p50, stats->p99, stats->max,
+                (stats->high_variance) ? " - High variance!" : "");
+        TJames_ReportErrors(writer, func, context);
+}
+
+// Quiet, only failed tests and the final result
+
+void TJames_QuietEndTest(struct TJames_Writer *writer,
+        const size_t position,
+        const struct TJames_TestFuncData *func,
+        const struct TJames_TestRun *run,
+        const struct TJames_ExecContext *context)
+{
+        if(run->result != FAILED_TEST) {
+                return;
+        }
+        TJames_ConsoleBeginTest(writer, func);
+        TJames_ConsoleEndTest(writer, position, func, run, context);
+}
+
+void TJames_QuietEndRun(struct TJames_Writer *writer, const struct TJames_RunSummary *summary)
+{
+        TJames_WriterPrintf(writer, "\nRun a total of %lu tests, with a successrate of %lu/%lu",
+                summary->test_count, summary->test_count - summary->failed_tests, summary->test_count);
+        TJames_WriteNotRun(writer, summary);
+}
+
+void TJames_QuietRepeat(struct TJames_Writer *writer,
+        const size_t position,
+        const struct TJames_TestFuncData *func,
+        const struct TJames_RepeatStats *stats,
+        const struct TJames_ExecContext *context)
+{
+        if(stats->failures > 0 || stats->regressed || stats->high_variance) {
+                TJames_ConsoleRepeat(writer, position, func, stats, context);
+        }
+}
+
+// JUnit XML
+
+void TJames_JUnitBeginRun(struct TJames_Writer *writer, const size_t test_count)
+{
+        TJames_WriterPrintf(writer, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+        TJames_WriterPrintf(writer, "<testsuite name=\"TJames\" tests=\"%lu\">\n", test_count);
+}
+
+void TJames_JUnitEndTest(struct TJames_Writer *writer,
+        const size_t position,
+        const struct TJames_TestFuncData *func,
+        const struct TJames_TestRun *run,
+        const struct TJames_ExecContext *context)
+{
+        (void)position;
+        TJames_WriterPrintf(writer, "  <testcase classname=\"");
+        TJames_WriteXmlString(writer, func->group_name);
+        TJames_WriterPrintf(writer, "\" name=\"");
+        TJames_WriteXmlString(writer, func->func_name);
+        TJames_WriterPrintf(writer, "\" file=\"");
+        TJames_WriteXmlString(writer, func->file);
+        TJames_WriterPrintf(writer, "\" line=\"%lu\" time=\"%.6f\">\n", func->added_on_line, run->wall_time);
+
+        if(run->result == SKIPED_TEST) {
+                TJames_WriterPrintf(writer, "    <skipped/>\n");
+        } else if(run->result == FAILED_TEST) {
+                TJames_WriterPrintf(writer, "    <failure message=\"");
+                for(size_t i = 0; i < context->error_list.count; ++i) {
+                        struct TJames_Error *error = LIST_EPTR(struct TJames_Error, context->error_list, i);
+                        if(error->type != WARNING_ERROR) {
+                                TJames_WriteXmlString(writer, error->message);
+                                break;
+                        }
+                }
+                TJames_WriterPrintf(writer, "\" type=\"failure\">");
+                for(size_t i = 0; i < context->error_list.count; ++i) {
+                        struct TJames_Error *error = LIST_EPTR(struct TJames_Error, context->error_list, i);
+                        if(error->type != WARNING_ERROR) {
+                                TJames_WriterPrintf(writer, "%s:%lu [%s] ", func->file, error->line, TJames_ErrorTypeString(error->type));
+                                TJames_WriteXmlString(writer, error->message);
+                                TJames_WriterPrintf(writer, "\n");
+                        }
+                }
+                TJames_WriterPrintf(writer, "</failure>\n");
+        }
+
+        int has_warnings = 0;
+        for(size_t i = 0; i < context->error_list.count; ++i) {
+                struct TJames_Error *error = LIST_EPTR(struct TJames_Error, context->error_list, i);
+                if(error->type != WARNING_ERROR) {
+                        continue;
+                }
+                if(!has_warnings) {
+                        TJames_WriterPrintf(writer, "    <system-out>");
+                        has_warnings = 1;
+                }
+                TJames_WriterPrintf(writer, "%s:%lu [WARNING] ", func->file, error->line);
+                TJames_WriteXmlString(writer, error->message);
+                TJames_WriterPrintf(writer, "\n");
+        }
+        if(has_warnings) {
+                TJames_WriterPrintf(writer, "</system-out>\n");
+        }
+        TJames_WriterPrintf(writer, "  </testcase>\n");
+}
+
+// A repeated test is a single testcase, failed if any of its runs failed.
+void TJames_JUnitRepeat(struct TJames_Writer *writer,
+        const size_t position,
+        const struct TJames_TestFuncData *func,
+        const struct TJames_RepeatStats *stats,
+        const struct TJames_ExecContext *context)
+{
+        struct TJames_TestRun run;
+        memset(&run, 0, sizeof(run));
+        run.result = (stats->failures > 0 || stats->regressed) ? FAILED_TEST :
+                (stats->skips == stats->runs) ? SKIPED_TEST : SUCCESSFUL_TEST;
+        run.wall_time = stats->mean / 1e9;
+        TJames_JUnitEndTest(writer, position, func, &run, context);
+}
+
+void TJames_JUnitEndRun(struct TJames_Writer *writer, const struct TJames_RunSummary *summary)
+{
+        (void)summary;
+        TJames_WriterPrintf(writer, "</testsuite>\n");
+}
+
+// JSON lines, one object per test and benchmark followed by a summary object
+
+void TJames_JsonWriteFunc(struct TJames_Writer *writer, const char *type, const struct TJames_TestFuncData *func)
+{
+        TJames_WriterPrintf(writer, "{\"type\":\"%s\",\"group\":", type);
+        TJames_WriteJsonString(writer, func->group_name);
+        TJames_WriterPrintf(writer, ",\"name\":");
+        TJames_WriteJsonString(writer, func->func_name);
+        TJames_WriterPrintf(writer, ",\"file\":");
+        TJames_WriteJsonString(writer, func->file);
+        TJames_WriterPrintf(writer, ",\"line\":%lu", func->added_on_line);
+}
+
+void TJames_JsonWriteErrors(struct TJames_Writer *writer, const struct TJames_ExecContext *context)
+{
+        TJames_WriterPrintf(writer, ",\"errors\":[");
+        for(size_t i = 0; i < context->error_list.count; ++i) {
+                struct TJames_Error *error = LIST_EPTR(struct TJames_Error, context->error_list, i);
+                TJames_WriterPrintf(writer, "%s{\"type\":\"%s\",\"line\":%lu,\"message\":",
+                        (i > 0) ? "," : "", TJames_ErrorTypeString(error->type), error->line);
+                TJames_WriteJsonString(writer, error->message);
+                TJames_WriterPrintf(writer, "}");
+        }
+        TJames_WriterPrintf(writer, "]");
+}
+
+void TJames_JsonWritePerfStats(struct TJames_Writer *writer, const struct TJames_PerfStats *stats)
+{
+        if(stats->available == 0) {
+                return;
+        }
+        TJames_WriterPrintf(writer, ",\"perf\":{");
+        const char *separator = "";
+        for(size_t i = 0; i < PERF_COUNTER_COUNT; ++i) {
+                if(stats->available & (1u << i)) {
+                        TJames_WriterPrintf(writer, "%s\"%s\":%.4f", separator, PERF_COUNTER_NAMES[i], stats->values[i]);
+                        separator = ",";
+                }
+        }
+        double ipc = TJames_PerfIpc(stats);
+        if(ipc > 0.0) {
+                TJames_WriterPrintf(writer, ",\"ipc\":%.4f", ipc);
+        }
+        TJames_WriterPrintf(writer, "}");
+}
+
+void TJames_JsonEndTest(struct TJames_Writer *writer,
+        const size_t position,
+        const struct TJames_TestFuncData *func,
+        const struct TJames_TestRun *run,
+        const struct TJames_ExecContext *context)
+{
+        (void)position;
+        TJames_JsonWriteFunc(writer, "test", func);
+        TJames_WriterPrintf(writer, ",\"result\":\"%s\",\"wall_ms\":%.6f,\"cpu_ms\":%.6f",
+                TJames_TestResultString(run->result), run->wall_time * 1e3, run->cpu_time * 1e3);
+        if(run->allocs.tracked) {
+                TJames_WriterPrintf(writer, ",\"allocations\":%lu,\"alloc_bytes\":%lu,\"peak_bytes\":%lu,"
+                        "\"leaked_allocations\":%lu,\"leaked_bytes\":%lu",
+                        run->allocs.allocations, run->allocs.bytes, run->allocs.peak_bytes,
+                        run->allocs.leaked_allocations, run->allocs.leaked_bytes);
+        }
+        TJames_JsonWritePerfStats(writer, &run->perf);
+        TJames_JsonWriteErrors(writer, context);
+        TJames_WriterPrintf(writer, "}\n");
+}
+
+void TJames_JsonEndRun(struct TJames_Writer *writer, const struct TJames_RunSummary *summary)
+{
+        TJames_WriterPrintf(writer, "{\"type\":\"summary\",\"tests\":%lu,\"failed\":%lu,\"not_run\":%lu,\"wall_ms\":%.6f}\n",
+                summary->test_count, summary->failed_tests, summary->not_run_tests, summary->wall_time * 1e3);
+}
+
+void TJames_JsonBench(struct TJames_Writer *writer,
+        const struct TJames_TestFuncData *func,
+        const struct TJames_BenchStats *stats,
+        const struct TJames_ExecContext *context)
+{
+        TJames_JsonWriteFunc(writer, "bench", func);
+        TJames_WriterPrintf(writer, ",\"ns_per_op\":%.4f,\"ops_per_s\":%.2f,\"min_ns\":%.4f,\"median_ns\":%.4f,"
+                "\"p99_ns\":%.4f,\"mad_ns\":%.4f,\"samples\":%lu,\"iterations\":%lu,\"outliers\":%lu",
+                stats->median, (stats->median > 0.0) ? 1e9 / stats->median : 0.0,
+                stats->min, stats->median, stats->p99, stats->mad,
+                stats->samples, stats->iterations, stats->outliers);
+        TJames_JsonWritePerfStats(writer, &stats->perf);
+        TJames_JsonWriteErrors(writer, context);
+        TJames_WriterPrintf(writer, "}\n");
+}
+
+void TJames_JsonLoad(struct TJames_Writer *writer,
+        const struct TJames_TestFuncData *func,
+        const struct TJames_LoadStats *steps,
+        const size_t step_count,
+        const struct TJames_ExecContext *context)
+{
+        TJames_JsonWriteFunc(writer, "load", func);
+        TJames_WriterPrintf(writer, ",\"steps\":[");
+        for(size_t i = 0; i < step_count; ++i) {
+                const struct TJames_LoadStats *step = &steps[i];
+                TJames_WriterPrintf(writer, "%s{\"threads\":%lu,\"calls\":%lu,\"seconds\":%.6f,\"calls_per_s\":%.2f,"
+                        "\"efficiency\":%.4f,\"p50_ns\":%.0f,\"p99_ns\":%.0f,\"p999_ns\":%.0f,\"max_ns\":%.0f}",
+                        (i > 0) ? "," : "", step->threads, step->calls, step->seconds, step->calls_per_second,
+                        step->efficiency, step->p50, step->p99, step->p999, step->max);
+        }
+        TJames_WriterPrintf(writer, "]");
+        TJames_JsonWriteErrors(writer, context);
+        TJames_WriterPrintf(writer, "}\n");
+}
+
+void TJames_JsonRepeat(struct TJames_Writer *writer,
+        const size_t position,
+        const struct TJames_TestFuncData *func,
+        const struct TJames_RepeatStats *stats,
+        const struct TJames_ExecContext *context)
+{
+        (void)position;
+        TJames_JsonWriteFunc(writer, "repeat", func);
+        TJames_WriterPrintf(writer, ",\"runs\":%lu,\"failures\":%lu,\"skips\":%lu,\"flaky\":%s,"
+                "\"mean_ns\":%.0f,\"stddev_ns\":%.0f,\"p50_ns\":%.0f,\"p99_ns\":%.0f,\"max_ns\":%.0f,\"high_variance\":%s,\"regressed\":%s",
+                stats->runs, stats->failures, stats->skips, (stats->flaky) ? "true" : "false",
+                stats->mean, stats->stddev, stats->p50, stats->p99, stats->max, (stats->high_variance) ? "true" : "false",
+                (stats->regressed) ? "true" : "false");
+        TJames_JsonWriteErrors(writer, context);
+        TJames_WriterPrintf(writer, "}\n");
+}
+
+// TAP version 13
+
+void TJames_TapBeginRun(struct TJames_Writer *writer, const size_t test_count)
+{
+        TJames_WriterPrintf(writer, "TAP version 13\n1..%lu\n", test_count);
+}
+
+void TJames_TapEndTest(struct TJames_Writer *writer,
+        const size_t position,
+        const struct TJames_TestFuncData *func,
+        const struct TJames_TestRun *run,
+        const struct TJames_ExecContext *context)
+{
+        TJames_WriterPrintf(writer, "%s %lu - %s/%s%s\n", (run->result == FAILED_TEST) ? "not ok" : "ok",
+                position, func->group_name, func->func_name, (run->result == SKIPED_TEST) ? " # SKIP" : "");
+        for(size_t i = 0; i < context->error_list.count; ++i) {
+                struct TJames_Error *error = LIST_EPTR(struct TJames_Error, context->error_list, i);
+                TJames_WriterPrintf(writer, "# %s:%lu [%s] %s\n", func->file, error->line,
+                        TJames_ErrorTypeString(error->type), error->message);
+        }
+}
+
+void TJames_TapEndRun(struct TJames_Writer *writer, const struct TJames_RunSummary *summary)
+{
+        TJames_WriterPrintf(writer, "# Run a total of %lu tests, with a successrate of %lu/%lu",
+                summary->test_count, summary->test_count - summary->failed_tests, summary->test_count);
+        TJames_WriteNotRun(writer, summary);
+}
+
+void TJames_TapBench(struct TJames_Writer *writer,
+        const struct TJames_TestFuncData *func,
+        const struct TJames_BenchStats *stats,
+        const struct TJames_ExecContext *context)
+{
+        (void)context;
+        TJames_WriterPrintf(writer, "# bench %s/%s: %.2f ns/op, p99 %.2f ns, MAD %.2f ns\n",
+                func->group_name, func->func_name, stats->median, stats->p99, stats->mad);
+}
+
+void TJames_TapLoad(struct TJames_Writer *writer,
+        const struct TJames_TestFuncData *func,
+        const struct TJames_LoadStats *steps,
+        const size_t step_count,
+        const struct TJames_ExecContext *context)
+{
+        (void)context;
+        for(size_t i = 0; i < step_count; ++i) {
+                TJames_WriterPrintf(writer, "# load %s/%s: %lu threads, %.0f calls/s, p99 %.0f ns\n",
+                        func->group_name, func->func_name, steps[i].threads, steps[i].calls_per_second, steps[i].p99);
+        }
+}
+
+void TJames_TapRepeat(struct TJames_Writer *writer,
+        const size_t position,
+        const struct TJames_TestFuncData *func,
+        const struct TJames_RepeatStats *stats,
+        const struct TJames_ExecContext *context)
+{
+        TJames_WriterPrintf(writer, "%s %lu - %s/%s # %s%lu of %lu runs failed%s, p50 %.0f ns, p99 %.0f ns%s\n",
+                (stats->failures > 0 || stats->regressed) ? "not ok" : "ok", position, func->group_name, func->func_name,
+                (stats->failures == 0 && stats->skips == stats->runs) ? "SKIP " : "",
+                stats->failures, stats->runs, (stats->flaky) ? " (flaky)" : "", stats->p50, stats->p99,
+                (stats->high_variance) ? ", high variance" : "");
+        for(size_t i = 0; i < context->error_list.count; ++i) {
+                struct TJames_Error *error = LIST_EPTR(struct TJames_Error, context->error_list, i);
+                TJames_WriterPrintf(writer, "# %s:%lu [%s] %s\n", func->file, error->line,
+                        TJames_ErrorTypeString(error->type), error->message);
+        }
+}
+
+static const struct TJames_Reporter REPORTERS[] =
+{
+        { "console", TJames_NoBeginRun,    TJames_ConsoleBeginTest, TJames_ConsoleEndTest, TJames_ConsoleEndRun, TJames_ConsoleBench, TJames_ConsoleLoad, TJames_ConsoleRepeat },
+        { "quiet",   TJames_NoBeginRun,    TJames_NoBeginTest,      TJames_QuietEndTest,   TJames_QuietEndRun,   TJames_ConsoleBench, TJames_ConsoleLoad, TJames_QuietRepeat   },
+        { "junit",   TJames_JUnitBeginRun, TJames_NoBeginTest,      TJames_JUnitEndTest,   TJames_JUnitEndRun,   TJames_NoBench,      TJames_NoLoad,      TJames_JUnitRepeat   },
+        { "json",    TJames_NoBeginRun,    TJames_NoBeginTest,      TJames_JsonEndTest,    TJames_JsonEndRun,    TJames_JsonBench,    TJames_JsonLoad,    TJames_JsonRepeat    },
+        { "tap",     TJames_TapBeginRun,   TJames_NoBeginTest,      TJames_TapEndTest,     TJames_TapEndRun,     TJames_TapBench,     TJames_TapLoad,     TJames_TapRepeat     },
+};
+
+const struct TJames_Reporter *TJames_FindReporter(const char *name)
+{
+        for(size_t i = 0; i < sizeof(REPORTERS) / sizeof(REPORTERS[0]); ++i) {
+                if(strcmp(REPORTERS[i].name, name) == 0) {
+                        return &REPORTERS[i];
+                }
+        }
+        return NULL;
+}
+
+// Picks the reporter and opens the output file, once per run.
+void TJames_StartOutput()
+{
+        if(GLOBAL_CORE_DATA.reporter != NULL) {
+                return;
+        }
+        GLOBAL_CORE_DATA.reporter = TJames_FindReporter(GLOBAL_CORE_DATA.options.reporter_name);
+        if(GLOBAL_CORE_DATA.options.output_path != NULL) {
+                FILE *stream = fopen(GLOBAL_CORE_DATA.options.output_path, "w");
+                if(stream == NULL) {
+                        fprintf(stderr, "TJames Error: Failed to open output file '%s', writing to stdout!\n",
+                                GLOBAL_CORE_DATA.options.output_path);
+                } else {
+                        GLOBAL_CORE_DATA.writer.stream = stream;
+                }
+        }
+}
+
+// *------------------*
+// |                  |
+// |   BENCHMARKING   |
+// |                  |
+// *------------------*
+
+unsigned long long TJames_TimeBench(const struct TJames_BenchFunc *bench, const size_t iterations)
+{
+        unsigned long long start = TJames_ClockNs(CLOCK_MONOTONIC);
+        bench->func_ptr(iterations);
+        TJAMES_CLOBBER_MEMORY();
+        return TJames_ClockNs(CLOCK_MONOTONIC) - start;
+}
+
+// Grows the iteration count until a single sample takes at least the
+// configured sample time. This doubles as the warm up of the benchmark.
+size_t TJames_CalibrateBench(const struct TJames_BenchFunc *bench)
+{
+        double target = GLOBAL_CORE_DATA.options.bench_sample_time * 1e9;
+        size_t iterations = 1;
+
+        for(;;) {
+                double elapsed = (double)TJames_TimeBench(bench, iterations);
+                if(elapsed >= target) {
+                        return iterations;
+                }
+
+                double next = (elapsed > 0.0) ? iterations * target * 1.1 / elapsed : iterations * 10.0;
+                if(next > iterations * 100.0) {
+                        next = iterations * 100.0;
+                }
+                if(next <= iterations) {
+                        next = iterations + 1;
+                }
+                iterations = (size_t)next;
+        }
+}
+
+int TJames_CompareDouble(const void *a, const void *b)
+{
+        double x = *(const double*)a;
+        double y = *(const double*)b;
+        return (x > y) - (x < y);
+}
+
+// Expects `values` to be sorted.
+double TJames_Percentile(const double *values, const size_t count, const double percentile)
+{
+        if(count == 0) {
+                return 0.0;
+        }
+        double rank = percentile / 100.0 * (count - 1);
+        size_t lower = (size_t)rank;
+        size_t upper = (lower + 1 < count) ? lower + 1 : lower;
+        return values[lower] + (values[upper] - values[lower]) * (rank - lower);
+}
+
+double TJames_MedianAbsoluteDeviation(const double *values, const size_t count, const double median, double *scratch)
+{
+        for(size_t i = 0; i < count; ++i) {
+                scratch[i] = fabs(values[i] - median);
+        }
+        qsort(scratch, count, sizeof(double), TJames_CompareDouble);
+        return TJames_Percentile(scratch, count, 50.0);
+}
+
+// Sorts `samples` and fills `stats`, dropping samples further than three
+// scaled MADs (about three standard deviations for normal noise) from the median.
+void TJames_ComputeBenchStats(double *samples, const size_t count, double *scratch, struct TJames_BenchStats *stats)
+{
+        qsort(samples, count, sizeof(double), TJames_CompareDouble);
+        double median = TJames_Percentile(samples, count, 50.0);
+        double mad = TJames_MedianAbsoluteDeviation(samples, count, median, scratch);
+        double limit = 3.0 * 1.4826 * mad;
+
+        size_t kept = 0;
+        for(size_t i = 0; i < count; ++i) {
+                if(fabs(samples[i] - median) <= limit) {
+                        samples[kept++] = samples[i];
+                }
+        }
+
+        stats->samples = kept;
+        stats->outliers = count - kept;
+        stats->min = samples[0];
+        stats->median = TJames_Percentile(samples, kept, 50.0);
+        stats->p99 = TJames_Percentile(samples, kept, 99.0);
+        stats->mad = TJames_MedianAbsoluteDeviation(samples, kept, stats->median, scratch);
+}
+
+// *---------------*
+// |               |
+// |   BASELINES   |
+// |               |
+// *---------------*
+
+unsigned long long TJames_HashBaselineEntry(const enum TJames_BaselineKind kind, const char *group_name, const char *func_name)
+{
+        return TJames_HashTest(group_name, func_name) ^ (unsigned long long)kind;
+}
+
+struct TJames_BaselineEntry *TJames_FindBaselineEntry(const enum TJames_BaselineKind kind, const struct TJames_TestFuncData *func)
+{
+        struct TJames_Baseline *baseline = &GLOBAL_CORE_DATA.baseline;
+        if(baseline->slot_count == 0) {
+                return NULL;
+        }
+        size_t slot = TJames_HashBaselineEntry(kind, func->group_name, func->func_name) & (baseline->slot_count - 1);
+        while(baseline->slots[slot] != 0) {
+                struct TJames_BaselineEntry *entry = LIST_EPTR(struct TJames_BaselineEntry, baseline->entries, baseline->slots[slot] - 1);
+                if(entry->kind == kind && strcmp(entry->group_name, func->group_name) == 0 &&
+                        strcmp(entry->func_name, func->func_name) == 0) {
+                        return entry;
+                }
+                slot = (slot + 1) & (baseline->slot_count - 1);
+        }
+        return NULL;
+}
+
+// Parses one "KIND<TAB>GROUP<TAB>NAME<TAB>SAMPLE,SAMPLE,..." line into `entry`.
+int TJames_ParseBaselineLine(char *line, struct TJames_BaselineEntry *entry)
+{
+        char *fields[4];
+        fields[0] = line;
+        for(size_t i = 1; i < 4; ++i) {
+                fields[i] = strchr(fields[i - 1], '\t');
+                if(fields[i] == NULL) {
+                        return -1;
+                }
+                *fields[i]++ = '\0';
+        }
+
+        if(strcmp(fields[0], BASELINE_KIND_NAMES[BASELINE_TEST]) == 0) {
+                entry->kind = BASELINE_TEST;
+        } else if(strcmp(fields[0], BASELINE_KIND_NAMES[BASELINE_BENCH]) == 0) {
+                entry->kind = BASELINE_BENCH;
+        } else {
+                return -1;
+        }
+
+        size_t capacity = 1;
+        for(const char *c = fields[3]; *c != '\0'; ++c) {
+                capacity += (*c == ',');
+        }
+        entry->samples = malloc(capacity * sizeof(double));
+        entry->group_name = strdup(fields[1]);
+        entry->func_name = strdup(fields[2]);
+        entry->sample_count = 0;
+        if(entry->samples == NULL || entry->group_name == NULL || entry->func_name == NULL) {
+                free(entry->samples);
+                free(entry->group_name);
+                free(entry->func_name);
+                return -1;
+        }
+
+        char *cursor = fields[3];
+        while(entry->sample_count < capacity) {
+                char *end = NULL;
+                double value = strtod(cursor, &end);
+                if(end == cursor) {
+                        break;
+                }
+                entry->samples[entry->sample_count++] = value;
+                cursor = (*end == ',') ? end + 1 : end;
+        }
+        qsort(entry->samples, entry->sample_count, sizeof(double), TJames_CompareDouble);
+        return 0;
+}
+
+// Loads the --compare-baseline file once, later calls do nothing.
+void TJames_LoadBaseline()
+{
+        struct TJames_Baseline *baseline = &GLOBAL_CORE_DATA.baseline;
+        if(baseline->loaded || GLOBAL_CORE_DATA.options.baseline_path == NULL) {
+                return;
+        }
+        baseline->loaded = 1;
+
+        FILE *stream = fopen(GLOBAL_CORE_DATA.options.baseline_path, "r");
+        if(stream == NULL) {
+                fprintf(stderr, "TJames Error: Failed to open baseline file '%s', nothing is compared!\n",
+                        GLOBAL_CORE_DATA.options.baseline_path);
+                return;
+        }
+
+        char *line = NULL;
+        size_t line_capacity = 0;
+        ssize_t length;
+        while((length = getline(&line, &line_capacity, stream)) > 0) {
+                if(line[length - 1] == '\n') {
+                        line[length - 1] = '\0';
+                }
+                struct TJames_BaselineEntry entry;
+                if(TJames_ParseBaselineLine(line, &entry) == 0 && TJames_AddToList(&baseline->entries, &entry) != 0) {
+                        break;
+                }
+        }
+        free(line);
+        fclose(stream);
+
+        size_t slot_count = 16;
+        while(slot_count < baseline->entries.count * 2) {
+                slot_count *= 2;
+        }
+        baseline->slots = calloc(slot_count, sizeof(size_t));
+        if(baseline->slots == NULL) {
+                fprintf(stderr, "TJames Error: Memory allocation failed, while loading the baseline!\n");
+                return;
+        }
+        baseline->slot_count = slot_count;
+        for(size_t i = 0; i < baseline->entries.count; ++i) {
+                struct TJames_BaselineEntry *entry = LIST_EPTR(struct TJames_BaselineEntry, baseline->entries, i);
+                size_t slot = TJames_HashBaselineEntry(entry->kind, entry->group_name, entry->func_name) & (slot_count - 1);
+                while(baseline->slots[slot] != 0) {
+                        slot = (slot + 1) & (slot_count - 1);
+                }
+                baseline->slots[slot] = i + 1;
+        }
+}
+
+// Appends the samples of a test or benchmark to the --save-baseline file.
+void TJames_SaveBaseline(const enum TJames_BaselineKind kind,
+        const struct TJames_TestFuncData *func,
+        const double *samples,
+        const size_t sample_count)
+{
+        struct TJames_Baseline *baseline = &GLOBAL_CORE_DATA.baseline;
+        if(GLOBAL_CORE_DATA.options.save_baseline_path == NULL) {
+                return;
+        }
+        if(baseline->output == NULL) {
+                // The baseline to compare against may be the very same file.
+                TJames_LoadBaseline();
+                size_t length = strlen(GLOBAL_CORE_DATA.options.save_baseline_path);
+                baseline->output_path = malloc(length + 5);
+                if(baseline->output_path == NULL) {
+                        return;
+                }
+                memcpy(baseline->output_path, GLOBAL_CORE_DATA.options.save_baseline_path, length);
+                memcpy(baseline->output_path + length, ".tmp", 5);
+                baseline->output = fopen(baseline->output_path, "w");
+                if(baseline->output == NULL) {
+                        fprintf(stderr, "TJames Error: Failed to open baseline file '%s' for writing!\n", baseline->output_path);
+                        GLOBAL_CORE_DATA.options.save_baseline_path = NULL;
+                        return;
+                }
+        }
+
+        fprintf(baseline->output, "%s\t%s\t%s\t", BASELINE_KIND_NAMES[kind], func->group_name, func->func_name);
+        for(size_t i = 0; i < sample_count; ++i) {
+                fprintf(baseline->output, "%s%.9g", (i > 0) ? "," : "", samples[i]);
+        }
+        fprintf(baseline->output, "\n");
+}
+
+// One sided Mann-Whitney U test with tie correction, using the normal
+// approximation. Returns the p-value of `new_samples` being stochastically
+// greater than `old_samples`, both have to be sorted.
+double TJames_MannWhitneyP(const double *old_samples, const size_t old_count,
+        const double *new_samples, const size_t new_count)
+{
+        double n = (double)(old_count + new_count);
+        double new_rank_sum = 0.0;
+        double tie_sum = 0.0;
+        size_t old_index = 0;
+        size_t new_index = 0;
+        double rank = 1.0;
+
+        while(old_index < old_count || new_index < new_count) {
+                double value;
+                if(new_index >= new_count || (old_index < old_count && old_samples[old_index] <= new_samples[new_index])) {
+                        value = old_samples[old_index];
+                } else {
+                        value = new_samples[new_index];
+                }
+
+                double old_ties = 0.0;
+                double new_ties = 0.0;
+                while(old_index < old_count && old_samples[old_index] == value) {
+                        ++old_index;
+                        old_ties += 1.0;
+                }
+                while(new_index < new_count && new_samples[new_index] == value) {
+                        ++new_index;
+                        new_ties += 1.0;
+                }
+                double ties = old_ties + new_ties;
+                new_rank_sum += new_ties * (rank + (ties - 1.0) / 2.0);
+                tie_sum += ties * ties * ties - ties;
+                rank += ties;
+        }
+
+        double u = new_rank_sum - new_count * (new_count + 1.0) / 2.0;
+        double mean = old_count * (double)new_count / 2.0;
+        double variance = old_count * (double)new_count / 12.0 * ((n + 1.0) - tie_sum / (n * (n - 1.0)));
+        if(variance <= 0.0) {
+                return 1.0;
+        }
+        double z = (u - mean - 0.5) / sqrt(variance);
+        return 0.5 * erfc(z / sqrt(2.0));
+}
+
+// Fails the test or benchmark in `context` if its sorted samples are
+// significantly slower than the baseline and the median slowed down by more
+// than --regression-threshold. Returns 1 if it did.
+int TJames_CompareToBaseline(const enum TJames_BaselineKind kind,
+        const struct TJames_TestFuncData *func,
+        const double *samples,
+        const size_t sample_count,
+        struct TJames_ExecContext *context)
+{
+        if(GLOBAL_CORE_DATA.options.baseline_path == NULL || sample_count < TJAMES_BASELINE_MIN_SAMPLES) {
+                return 0;
+        }
+        TJames_LoadBaseline();
+        const struct TJames_BaselineEntry *entry = TJames_FindBaselineEntry(kind, func);
+        if(entry == NULL || entry->sample_count < TJAMES_BASELINE_MIN_SAMPLES) {
+                return 0;
+        }
+
+        double old_median = TJames_Percentile(entry->samples, entry->sample_count, 50.0);
+        double new_median = TJames_Percentile(samples, sample_count, 50.0);
+        double change = (old_median > 0.0) ? new_median / old_median - 1.0 : 0.0;
+        if(change <= GLOBAL_CORE_DATA.options.regression_threshold) {
+                return 0;
+        }
+        double p = TJames_MannWhitneyP(entry->samples, entry->sample_count, samples, sample_count);
+        if(p >= TJAMES_BASELINE_ALPHA) {
+                return 0;
+        }
+
+        TJames_SetContextResult(context, FAILED_TEST);
+        TJames_PushContextError(context, NORMAL_ERROR, 0,
+                "Slower than the baseline by %.1f%% (p = %.2g): "
+                "now min %.2f ns, median %.2f ns, p99 %.2f ns (n = %lu), "
+                "was min %.2f ns, median %.2f ns, p99 %.2f ns (n = %lu)",
+                change * 100.0, p,
+                samples[0], new_median, TJames_Percentile(samples, sample_count, 99.0), sample_count,
+                entry->samples[0], old_median, TJames_Percentile(entry->samples, entry->sample_count, 99.0),
+                entry->sample_count);
+        return 1;
+}
+
+// Runs every registered benchmark on the calling thread. Returns the number
+// of benchmarks that reported a failure.
+size_t TJames_RunBenchmarks()
+{
+        size_t sample_count = GLOBAL_CORE_DATA.options.bench_samples;
+        double *samples = malloc(sample_count * sizeof(double));
+        double *scratch = malloc(sample_count * sizeof(double));
+        struct TJames_ExecContext *context = TJames_AcquireContext();
+        TJames_StartOutput();
+        if(samples == NULL || scratch == NULL || context == NULL) {
+                fprintf(stderr, "TJames Error: Memory allocation failed, while starting the benchmarks!\n");
+                free(samples);
+                free(scratch);
+                return GLOBAL_CORE_DATA.bench_list.count;
+        }
+
+        struct TJames_PerfGroup perf;
+        TJames_BeginThreadPerf(&perf);
+
+        size_t failed_benchmarks = 0;
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.bench_list.count; ++i) {
+                struct TJames_BenchFunc *bench = LIST_EPTR(struct TJames_BenchFunc, GLOBAL_CORE_DATA.bench_list, i);
+
+                // Assertions inside of a benchmark body land in this context.
+                context->last_test_result = EMPTY_TEST;
+                TJames_ClearErrorList(context);
+                THREAD_CONTEXT = context;
+
+                struct TJames_BenchStats stats;
+                memset(&stats.perf, 0, sizeof(stats.perf));
+                stats.iterations = TJames_CalibrateBench(bench);
+                for(size_t j = 0; j < sample_count; ++j) {
+                        if(perf.leader >= 0) {
+                                TJames_StartPerfCounters(&perf);
+                        }
+                        samples[j] = (double)TJames_TimeBench(bench, stats.iterations) / stats.iterations;
+                        if(perf.leader >= 0) {
+                                TJames_StopPerfCounters(&perf, &stats.perf);
+                        }
+                }
+                THREAD_CONTEXT = NULL;
+                for(size_t j = 0; j < PERF_COUNTER_COUNT; ++j) {
+                        stats.perf.values[j] /= (double)sample_count * stats.iterations;
+                }
+
+                TJames_ComputeBenchStats(samples, sample_count, scratch, &stats);
+                TJames_CompareToBaseline(BASELINE_BENCH, &bench->data, samples, stats.samples, context);
+                TJames_SaveBaseline(BASELINE_BENCH, &bench->data, samples, stats.samples);
+                TJames_FormatDeferredErrors(context);
+                GLOBAL_CORE_DATA.reporter->bench(&GLOBAL_CORE_DATA.writer, &bench->data, &stats, context);
+                // Benchmarks are few and slow, show every result right away.
+                TJames_FlushWriter(&GLOBAL_CORE_DATA.writer);
+                if(context->last_test_result == FAILED_TEST) {
+                        failed_benchmarks += 1;
+                }
+        }
+
+        TJames_EndThreadPerf(&perf);
+        TJames_ReleaseContext(context);
+        free(samples);
+        free(scratch);
+        return failed_benchmarks;
+}
+
+// *----------------*
+// |                |
+// |   LOAD TESTS   |
+// |                |
+// *----------------*
+
+// Latencies are counted in buckets that double in width every 64 buckets past
+// the first 128, so every value is known to within 1/64 of itself. The
+// largest bucket collects everything above about a day and a half.
+#define TJAMES_HISTOGRAM_SUB_BITS 7
+#define TJAMES_HISTOGRAM_HALF (1u << (TJAMES_HISTOGRAM_SUB_BITS - 1))
+#define TJAMES_HISTOGRAM_MAX_SHIFT 40
+#define TJAMES_HISTOGRAM_BUCKETS ((TJAMES_HISTOGRAM_MAX_SHIFT + 2) * TJAMES_HISTOGRAM_HALF)
+#define TJAMES_LOAD_MAX_STEPS 64
+#define TJAMES_MAX_LOAD_THREADS 1024
+
+// State shared by the threads of one step of a load test.
+struct TJames_LoadRun
+{
+        atomic_size_t ready;
+        atomic_int go;
+        atomic_int stop;
+};
+
+// One thread of a step. Its histogram is only touched by the thread itself
+// until it was joined.
+struct TJames_LoadWorker
+{
+        pthread_t thread;
+        const struct TJames_LoadFunc *load;
+        struct TJames_LoadRun *run;
+        struct TJames_ExecContext *context;
+        size_t index;
+        int cpu; // -1 if the thread is not pinned
+        uint64_t *counts;
+        size_t calls;
+        unsigned long long max;
+};
+
+size_t TJames_HistogramIndex(unsigned long long value)
+{
+        if(value < 2 * TJAMES_HISTOGRAM_HALF) {
+                return value;
+        }
+        unsigned shift = (63 - __builtin_clzll(value)) - (TJAMES_HISTOGRAM_SUB_BITS - 1);
+        if(shift > TJAMES_HISTOGRAM_MAX_SHIFT) {
+                return TJAMES_HISTOGRAM_BUCKETS - 1;
+        }
+        return shift * TJAMES_HISTOGRAM_HALF + (value >> shift);
+}
+
+// The largest value that lands in bucket `index`.
+unsigned long long TJames_HistogramValue(const size_t index)
+{
+        if(index < 2 * TJAMES_HISTOGRAM_HALF) {
+                return index;
+        }
+        unsigned shift = index / TJAMES_HISTOGRAM_HALF - 1;
+        unsigned long long sub = index - shift * TJAMES_HISTOGRAM_HALF;
+        return ((sub + 1) << shift) - 1;
+}
+
+double TJames_HistogramPercentile(const uint64_t *counts, const uint64_t total, const double percentile, const unsigned long long max)
+{
+        uint64_t target = (uint64_t)ceil(percentile / 100.0 * total);
+        target = (target > 0) ? target : 1;
+        uint64_t seen = 0;
+        for(size_t i = 0; i < TJAMES_HISTOGRAM_BUCKETS; ++i) {
+                seen += counts[i];
+                if(seen >= target) {
+                        unsigned long long value = TJames_HistogramValue(i);
+                        return (double)((value < max) ? value : max);
+                }
+        }
+        return (double)max;
+}
+
+#ifdef TJAMES_THREAD_PINNING
+#define TJAMES_CPU_MASK_WORDS (TJAMES_MAX_LOAD_THREADS / (8 * sizeof(unsigned long)))
+
+// Fills `cpus` with the CPUs this process may run on. Returns their count.
+size_t TJames_AllowedCpus(int *cpus, const size_t max)
+{
+        unsigned long mask[TJAMES_CPU_MASK_WORDS] = { 0 };
+        long length = syscall(SYS_sched_getaffinity, 0, sizeof(mask), mask);
+        size_t count = 0;
+        for(long word = 0; word * (long)sizeof(unsigned long) < length; ++word) {
+                for(size_t bit = 0; bit < 8 * sizeof(unsigned long) && count < max; ++bit) {
+                        if(mask[word] & (1ul << bit)) {
+                                cpus[count++] = word * 8 * sizeof(unsigned long) + bit;
+                        }
+                }
+        }
+        return count;
+}
+
+void TJames_PinThread(const int cpu)
+{
+        unsigned long mask[TJAMES_CPU_MASK_WORDS] = { 0 };
+        mask[cpu / (8 * sizeof(unsigned long))] = 1ul << (cpu % (8 * sizeof(unsigned long)));
+        syscall(SYS_sched_setaffinity, 0, sizeof(mask), mask);
+}
+#endif
+
+void *TJames_LoadWorkerMain(void *arg)
+{
+        struct TJames_LoadWorker *worker = arg;
+#ifdef TJAMES_THREAD_PINNING
+        if(worker->cpu >= 0) {
+                TJames_PinThread(worker->cpu);
+        }
+#endif
+        THREAD_CONTEXT = worker->context;
+        TJames_PassedChecks = 0;
+
+        atomic_fetch_add(&worker->run->ready, 1);
+        while(!atomic_load_explicit(&worker->run->go, memory_order_acquire)) {
+                sched_yield();
+        }
+
+        // A failing call ends the thread, every further one would only add
+        // the same error again.
+        unsigned long long start = TJames_ClockNs(CLOCK_MONOTONIC);
+        while(!atomic_load_explicit(&worker->run->stop, memory_order_relaxed) &&
+                worker->context->last_test_result != FAILED_TEST) {
+                worker->load->func_ptr(worker->index);
+                unsigned long long end = TJames_ClockNs(CLOCK_MONOTONIC);
+                unsigned long long latency = end - start;
+                worker->counts[TJames_HistogramIndex(latency)] += 1;
+                worker->max = (latency > worker->max) ? latency : worker->max;
+                worker->calls += 1;
+                start = end;
+        }
+
+        TJames_CollectPassedChecks(worker->context);
+        THREAD_CONTEXT = NULL;
+        return NULL;
+}
+
+// Moves the result and the errors of a worker into the context of the test.
+void TJames_MergeLoadWorker(struct TJames_ExecContext *context, struct TJames_LoadWorker *worker, const size_t threads)
+{
+        TJames_FormatDeferredErrors(worker->context);
+        for(size_t i = 0; i < worker->context->error_list.count; ++i) {
+                struct TJames_Error *error = LIST_EPTR(struct TJames_Error, worker->context->error_list, i);
+                TJames_AddContextError(context, error->type, error->line, TJames_ArenaPrintf(&context->arena,
+                        "Thread %lu of %lu: %s", worker->index, threads, (error->message) ? error->message : ""));
+        }
+        if(worker->context->last_test_result != EMPTY_TEST) {
+                TJames_SetContextResult(context, worker->context->last_test_result);
+        }
+}
+
+// Calls the load function from `threads` threads at once for --load-time and
+// fills `stats`, except for the efficiency. Returns -1 if the step could not
+// be started.
+int TJames_RunLoadStep(const struct TJames_LoadFunc *load,
+        const size_t threads,
+        const int *cpus,
+        const size_t cpu_count,
+        uint64_t *merged,
+        struct TJames_ExecContext *context,
+        struct TJames_LoadStats *stats)
+{
+        struct TJames_LoadWorker *workers = calloc(threads, sizeof(struct TJames_LoadWorker));
+        if(workers == NULL) {
+                TJames_PushContextError(context, NORMAL_ERROR, load->data.added_on_line,
+                        "Memory allocation failed, while starting %lu threads!", threads);
+                return -1;
+        }
+        struct TJames_LoadRun run;
+        atomic_init(&run.ready, 0);
+        atomic_init(&run.go, 0);
+        atomic_init(&run.stop, 0);
+
+        size_t started = 0;
+        for(; started < threads; ++started) {
+                struct TJames_LoadWorker *worker = &workers[started];
+                worker->load = load;
+                worker->run = &run;
+                worker->index = started;
+                worker->cpu = (cpu_count > 0) ? cpus[started % cpu_count] : -1;
+                worker->context = TJames_AcquireContext();
+                worker->counts = calloc(TJAMES_HISTOGRAM_BUCKETS, sizeof(uint64_t));
+                if(worker->context == NULL || worker->counts == NULL ||
+                        pthread_create(&worker->thread, NULL, TJames_LoadWorkerMain, worker) != 0) {
+                        if(worker->context != NULL) {
+                                TJames_ReleaseContext(worker->context);
+                        }
+                        free(worker->counts);
+                        break;
+                }
+        }
+
+        // All threads start calling at once, after the slowest one came up.
+        while(atomic_load(&run.ready) < started) {
+                sched_yield();
+        }
+        if(started < threads) {
+                atomic_store(&run.stop, 1);
+        }
+        unsigned long long start = TJames_ClockNs(CLOCK_MONOTONIC);
+        atomic_store_explicit(&run.go, 1, memory_order_release);
+        if(started == threads) {
+                unsigned long long duration = (unsigned long long)(GLOBAL_CORE_DATA.options.load_time * 1e9);
+                struct timespec sleep_time = { duration / 1000000000ull, duration % 1000000000ull };
+                while(nanosleep(&sleep_time, &sleep_time) != 0 && errno == EINTR) {
+                }
+                atomic_store_explicit(&run.stop, 1, memory_order_relaxed);
+        }
+
+        memset(merged, 0, TJAMES_HISTOGRAM_BUCKETS * sizeof(uint64_t));
+        memset(stats, 0, sizeof(*stats));
+        stats->threads = threads;
+        unsigned long long max = 0;
+        for(size_t i = 0; i < started; ++i) {
+                struct TJames_LoadWorker *worker = &workers[i];
+                pthread_join(worker->thread, NULL);
+                for(size_t j = 0; j < TJAMES_HISTOGRAM_BUCKETS; ++j) {
+                        merged[j] += worker->counts[j];
+                }
+                stats->calls += worker->calls;
+                max = (worker->max > max) ? worker->max : max;
+                TJames_MergeLoadWorker(context, worker, threads);
+                TJames_ReleaseContext(worker->context);
+                free(worker->counts);
+        }
+        stats->seconds = (TJames_ClockNs(CLOCK_MONOTONIC) - start) / 1e9;
+        free(workers);
+        if(started < threads) {
+                TJames_PushContextError(context, NORMAL_ERROR, load->data.added_on_line,
+                        "Failed to start %lu threads, only %lu came up!", threads, started);
+                return -1;
+        }
+
+        stats->calls_per_second = (stats->seconds > 0.0) ? stats->calls / stats->seconds : 0.0;
+        stats->p50 = TJames_HistogramPercentile(merged, stats->calls, 50.0, max);
+        stats->p99 = TJames_HistogramPercentile(merged, stats->calls, 99.0, max);
+        stats->p999 = TJames_HistogramPercentile(merged, stats->calls, 99.9, max);
+        stats->max = (double)max;
+        return 0;
+}
+
+// Runs every registered load test, stepping the thread count through the
+// powers of two up to its maximum. Returns the number of load tests that
+// failed.
+size_t TJames_RunLoads()
+{
+        int cpus[TJAMES_MAX_LOAD_THREADS];
+        size_t cpu_count = 0;
+#ifdef TJAMES_THREAD_PINNING
+        cpu_count = TJames_AllowedCpus(cpus, TJAMES_MAX_LOAD_THREADS);
+#endif
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        size_t default_threads = (cpu_count > 0) ? cpu_count : (online > 0) ? (size_t)online : 1;
+
+        uint64_t *merged = malloc(TJAMES_HISTOGRAM_BUCKETS * sizeof(uint64_t));
+        struct TJames_ExecContext *context = TJames_AcquireContext();
+        TJames_StartOutput();
+        if(merged == NULL || context == NULL) {
+                fprintf(stderr, "TJames Error: Memory allocation failed, while starting the load tests!\n");
+                free(merged);
+                if(context != NULL) {
+                        TJames_ReleaseContext(context);
+                }
+                return GLOBAL_CORE_DATA.load_list.count;
+        }
+
+        size_t failed_loads = 0;
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.load_list.count; ++i) {
+                struct TJames_LoadFunc *load = LIST_EPTR(struct TJames_LoadFunc, GLOBAL_CORE_DATA.load_list, i);
+                context->last_test_result = EMPTY_TEST;
+                TJames_ClearErrorList(context);
+
+                size_t max_threads = (load->max_threads > 0) ? load->max_threads : default_threads;
+                max_threads = (max_threads < TJAMES_MAX_LOAD_THREADS) ? max_threads : TJAMES_MAX_LOAD_THREADS;
+                struct TJames_LoadStats steps[TJAMES_LOAD_MAX_STEPS];
+                size_t step_count = 0;
+                for(size_t threads = 1; step_count < TJAMES_LOAD_MAX_STEPS; threads *= 2) {
+                        threads = (threads < max_threads) ? threads : max_threads;
+                        struct TJames_LoadStats *stats = &steps[step_count];
+                        if(TJames_RunLoadStep(load, threads, cpus, cpu_count, merged, context, stats) != 0) {
+                                TJames_SetContextResult(context, FAILED_TEST);
+                                break;
+                        }
+                        double single = steps[0].calls_per_second;
+                        stats->efficiency = (single > 0.0) ? stats->calls_per_second / (threads * single) : 0.0;
+                        step_count += 1;
+                        if(threads == max_threads || context->last_test_result == FAILED_TEST) {
+                                break;
+                        }
+                }
+
+                GLOBAL_CORE_DATA.reporter->load(&GLOBAL_CORE_DATA.writer, &load->data, steps, step_count, context);
+                TJames_FlushWriter(&GLOBAL_CORE_DATA.writer);
+                if(context->last_test_result == FAILED_TEST) {
+                        failed_loads += 1;
+                }
+        }
+
+        TJames_ReleaseContext(context);
+        free(merged);
+        return failed_loads;
+}
+
+// *-------------------*
+// |                   |
+// |   REPEATED RUNS   |
+// |                   |
+// *-------------------*
+
+// Preemption makes the slowest runs of any test slow, so the variance is
+// judged by how far p99 is from the median rather than by the outliers, and
+// spreads below TJAMES_REPEAT_NOISE_NS are noise.
+#define TJAMES_REPEAT_MAX_SPREAD 4.0
+#define TJAMES_REPEAT_NOISE_NS 10000.0
+
+// With a baseline, the wall times of the first passed runs of every test are
+// kept as its samples.
+#define TJAMES_REPEAT_MAX_SAMPLES 1000
+
+// Results of all runs of a test, shared by every thread. The histogram
+// counts the wall times in ns.
+struct TJames_RepeatTally
+{
+        atomic_size_t runs;
+        atomic_size_t failures;
+        atomic_size_t skips;
+        atomic_ullong max;
+        atomic_int has_failure;
+        struct TJames_ExecContext *failure; // of the first failed run, kept for the report
+        double *samples; // sample_capacity of them
+        atomic_size_t sample_count;
+        _Atomic uint32_t counts[TJAMES_HISTOGRAM_BUCKETS];
+};
+
+struct TJames_RepeatRun
+{
+        struct TJames_RepeatTally *tallies; // per schedule position
+        size_t rounds; // 0 runs until the deadline
+        size_t sample_capacity; // per test, 0 without a baseline
+        unsigned long long deadline; // CLOCK_MONOTONIC ns, 0 runs the rounds
+        atomic_size_t next_round;
+        atomic_int stop; // a test failed with --fail-fast
+};
+
+struct TJames_RepeatWorker
+{
+        pthread_t thread;
+        struct TJames_RepeatRun *run;
+        size_t id;
+        size_t *order; // schedule positions, shuffled every round
+};
+
+int TJames_RepeatDone(struct TJames_RepeatRun *run)
+{
+        return atomic_load_explicit(&run->stop, memory_order_relaxed) ||
+                (run->deadline != 0 && TJames_ClockNs(CLOCK_MONOTONIC) >= run->deadline);
+}
+
+// Runs the scheduled tests in a new random order every round, with a new seed
+// for every run. One context is reused for all runs, only the context of the
+// first failed run of a test is handed to its tally and replaced.
+void *TJames_RepeatWorkerMain(void *arg)
+{
+        struct TJames_RepeatWorker *worker = arg;
+        struct TJames_RepeatRun *run = worker->run;
+        size_t count = GLOBAL_CORE_DATA.schedule_count;
+        struct TJames_Rng rng;
+        TJames_SeedRng(&rng, GLOBAL_CORE_DATA.options.seed, worker->id);
+        struct TJames_ExecContext *context = TJames_AcquireContext();
+        TJames_SetThreadWatch(worker->id);
+        for(size_t i = 0; i < count; ++i) {
+                worker->order[i] = i;
+        }
+
+        while(context != NULL && !TJames_RepeatDone(run)) {
+                if(run->rounds > 0 && atomic_fetch_add(&run->next_round, 1) >= run->rounds) {
+                        break;
+                }
+                for(size_t i = count; i > 1; --i) {
+                        size_t j = TJames_NextRandom(&rng) % i;
+                        size_t position = worker->order[i - 1];
+                        worker->order[i - 1] = worker->order[j];
+                        worker->order[j] = position;
+                }
+
+                for(size_t i = 0; i < count && context != NULL && !TJames_RepeatDone(run); ++i) {
+                        size_t position = worker->order[i];
+                        struct TJames_RepeatTally *tally = &run->tallies[position];
+                        context->seed = TJames_NextRandom(&rng);
+                        TJames_ExecuteTestFunc(GLOBAL_CORE_DATA.schedule[position], context);
+
+                        unsigned long long wall_time = (unsigned long long)(context->wall_time * 1e9);
+                        atomic_fetch_add_explicit(&tally->counts[TJames_HistogramIndex(wall_time)], 1, memory_order_relaxed);
+                        atomic_fetch_add_explicit(&tally->runs, 1, memory_order_relaxed);
+                        unsigned long long max = atomic_load_explicit(&tally->max, memory_order_relaxed);
+                        while(wall_time > max && !atomic_compare_exchange_weak(&tally->max, &max, wall_time)) {
+                        }
+
+                        if(context->last_test_result == SKIPED_TEST) {
+                                atomic_fetch_add_explicit(&tally->skips, 1, memory_order_relaxed);
+                        } else if(context->last_test_result == FAILED_TEST) {
+                                atomic_fetch_add_explicit(&tally->failures, 1, memory_order_relaxed);
+                                if(!atomic_exchange(&tally->has_failure, 1)) {
+                                        tally->failure = context;
+                                        context = TJames_AcquireContext();
+                                }
+                                if(GLOBAL_CORE_DATA.options.fail_fast) {
+                                        atomic_store(&run->stop, 1);
+                                }
+                        } else if(run->sample_capacity > 0) {
+                                size_t sample = atomic_fetch_add_explicit(&tally->sample_count, 1, memory_order_relaxed);
+                                if(sample < run->sample_capacity) {
+                                        tally->samples[sample] = context->wall_time * 1e9;
+                                }
+                        }
+                }
+        }
+
+        if(context != NULL) {
+                TJames_ReleaseContext(context);
+        }
+        TJames_SetThreadWatch(SIZE_MAX);
+        return NULL;
+}
+
+// Derives the statistics of a test from its tally. The mean and standard
+// deviation are taken from the histogram, so they are exact to within 1/64.
+void TJames_SummarizeTally(const struct TJames_RepeatTally *tally, uint64_t *counts, struct TJames_RepeatStats *stats)
+{
+        memset(stats, 0, sizeof(*stats));
+        stats->runs = atomic_load(&tally->runs);
+        stats->failures = atomic_load(&tally->failures);
+        stats->skips = atomic_load(&tally->skips);
+        stats->flaky = stats->failures > 0 && stats->failures + stats->skips < stats->runs;
+        if(stats->runs == 0) {
+                return;
+        }
+
+        unsigned long long max = atomic_load(&tally->max);
+        double sum = 0.0;
+        for(size_t i = 0; i < TJAMES_HISTOGRAM_BUCKETS; ++i) {
+                counts[i] = atomic_load_explicit(&tally->counts[i], memory_order_relaxed);
+                unsigned long long value = TJames_HistogramValue(i);
+                sum += counts[i] * (double)((value < max) ? value : max);
+        }
+        stats->mean = sum / stats->runs;
+        double squares = 0.0;
+        for(size_t i = 0; i < TJAMES_HISTOGRAM_BUCKETS; ++i) {
+                if(counts[i] > 0) {
+                        unsigned long long value = TJames_HistogramValue(i);
+                        double deviation = (double)((value < max) ? value : max) - stats->mean;
+                        squares += counts[i] * deviation * deviation;
+                }
+        }
+        stats->stddev = sqrt(squares / stats->runs);
+        stats->p50 = TJames_HistogramPercentile(counts, stats->runs, 50.0, max);
+        stats->p99 = TJames_HistogramPercentile(counts, stats->runs, 99.0, max);
+        stats->max = (double)max;
+        stats->high_variance = stats->runs > 1 && stats->p99 > TJAMES_REPEAT_MAX_SPREAD * stats->p50 &&
+                stats->p99 - stats->p50 > TJAMES_REPEAT_NOISE_NS;
+}
+
+// Runs the scheduled tests --repeat times, or until --soak ms passed, on
+// --jobs threads and reports every test once with the statistics of its
+// runs. A test counts as failed if any run failed. Returns the number of
+// failed tests.
+size_t TJames_RunRepeated()
+{
+        size_t test_count = GLOBAL_CORE_DATA.schedule_count;
+        size_t thread_count = (GLOBAL_CORE_DATA.options.jobs > 0) ? GLOBAL_CORE_DATA.options.jobs : 1;
+
+        struct TJames_RepeatRun run;
+        run.tallies = calloc(test_count + 1, sizeof(struct TJames_RepeatTally));
+        run.rounds = GLOBAL_CORE_DATA.options.repeat_count;
+        run.deadline = 0;
+        if(GLOBAL_CORE_DATA.options.soak_time > 0.0) {
+                run.deadline = TJames_ClockNs(CLOCK_MONOTONIC) + (unsigned long long)(GLOBAL_CORE_DATA.options.soak_time * 1e9);
+        }
+        atomic_init(&run.next_round, 0);
+        atomic_init(&run.stop, 0);
+        run.sample_capacity = 0;
+        if(run.tallies != NULL && (GLOBAL_CORE_DATA.options.baseline_path != NULL ||
+                GLOBAL_CORE_DATA.options.save_baseline_path != NULL)) {
+                run.sample_capacity = (run.rounds > 0 && run.rounds < TJAMES_REPEAT_MAX_SAMPLES) ?
+                        run.rounds : TJAMES_REPEAT_MAX_SAMPLES;
+                GLOBAL_CORE_DATA.repeat_samples = malloc((test_count * run.sample_capacity + 1) * sizeof(double));
+                if(GLOBAL_CORE_DATA.repeat_samples == NULL) {
+                        fprintf(stderr, "TJames Error: Memory allocation failed, while keeping the samples for the baseline!\n");
+                        run.sample_capacity = 0;
+                }
+                for(size_t i = 0; i < test_count && run.sample_capacity > 0; ++i) {
+                        run.tallies[i].samples = GLOBAL_CORE_DATA.repeat_samples + i * run.sample_capacity;
+                }
+        }
+        struct TJames_RepeatWorker *workers = calloc(thread_count, sizeof(struct TJames_RepeatWorker));
+        uint64_t *counts = malloc(TJAMES_HISTOGRAM_BUCKETS * sizeof(uint64_t));
+        struct TJames_ExecContext *empty = TJames_AcquireContext();
+        if(run.tallies == NULL || workers == NULL || counts == NULL || empty == NULL) {
+                fprintf(stderr, "TJames Error: Memory allocation failed, while starting the repeated runs!\n");
+                free(run.tallies);
+                free(workers);
+                free(counts);
+                if(empty != NULL) {
+                        TJames_ReleaseContext(empty);
+                }
+                return test_count;
+        }
+
+        size_t started = 0;
+        for(; started < thread_count; ++started) {
+                struct TJames_RepeatWorker *worker = &workers[started];
+                worker->run = &run;
+                worker->id = started;
+                worker->order = malloc((test_count + 1) * sizeof(size_t));
+                if(worker->order == NULL || pthread_create(&worker->thread, NULL, TJames_RepeatWorkerMain, worker) != 0) {
+                        fprintf(stderr, "TJames Error: Failed to start repeat thread %lu!\n", started);
+                        free(worker->order);
+                        break;
+                }
+        }
+        if(started == 0) {
+                // Nothing is running yet, so the runs can be done right here.
+                workers[0].order = malloc((test_count + 1) * sizeof(size_t));
+                if(workers[0].order != NULL) {
+                        TJames_RepeatWorkerMain(&workers[0]);
+                }
+                free(workers[0].order);
+        }
+        for(size_t i = 0; i < started; ++i) {
+                pthread_join(workers[i].thread, NULL);
+                free(workers[i].order);
+        }
+
+        size_t failed_tests = 0;
+        for(size_t i = 0; i < test_count; ++i) {
+                size_t index = GLOBAL_CORE_DATA.schedule[i];
+                struct TJames_RepeatTally *tally = &run.tallies[i];
+                struct TJames_TestRun *test_run = &GLOBAL_CORE_DATA.runs[index];
+                struct TJames_RepeatStats stats;
+                TJames_SummarizeTally(tally, counts, &stats);
+
+                struct TJames_ExecContext *context = (tally->failure != NULL) ? tally->failure : empty;
+                size_t sample_count = atomic_load(&tally->sample_count);
+                if(sample_count > run.sample_capacity) {
+                        sample_count = run.sample_capacity;
+                }
+                if(sample_count > 0) {
+                        qsort(tally->samples, sample_count, sizeof(double), TJames_CompareDouble);
+                        test_run->samples = tally->samples;
+                        test_run->sample_count = sample_count;
+                        if(stats.failures == 0) {
+                                stats.regressed = TJames_CompareToBaseline(BASELINE_TEST, &TJames_GetTestFunc(index)->data,
+                                        tally->samples, sample_count, context);
+                        }
+                }
+                TJames_FormatDeferredErrors(context);
+                test_run->result = (stats.failures > 0 || stats.regressed) ? FAILED_TEST :
+                        (stats.runs == 0 || stats.skips == stats.runs) ? SKIPED_TEST : SUCCESSFUL_TEST;
+                test_run->wall_time = stats.mean / 1e9;
+                if(test_run->result == FAILED_TEST) {
+                        failed_tests += 1;
+                }
+
+                GLOBAL_CORE_DATA.reported_tests += 1;
+                GLOBAL_CORE_DATA.reporter->repeat(&GLOBAL_CORE_DATA.writer, GLOBAL_CORE_DATA.reported_tests,
+                        &TJames_GetTestFunc(index)->data, &stats, context);
+                if(tally->failure != NULL) {
+                        TJames_ReleaseContext(tally->failure);
+                } else {
+                        // Holds the regression of this test, if any.
+                        TJames_ClearErrorList(empty);
+                        empty->last_test_result = EMPTY_TEST;
+                }
+        }
+
+        TJames_ReleaseContext(empty);
+        free(run.tallies);
+        free(workers);
+        free(counts);
+        return failed_tests;
+}
+
+// Hands every fixture to the scheduled tests of its group and counts them.
+void TJames_PrepareFixtures()
+{
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.fixtures.count; ++i) {
+                struct TJames_Fixture *fixture = LIST_E(struct TJames_Fixture*, GLOBAL_CORE_DATA.fixtures, i);
+                fixture->pending_tests = 0;
+                struct TJames_IndexGroup *group = TJames_FindIndexGroup(fixture->group_name);
+                for(size_t j = 0; group != NULL && j < group->tests.count; ++j) {
+                        size_t index = LIST_E(size_t, group->tests, j);
+                        // Set for every test, it is part of the fingerprint of the result cache.
+                        GLOBAL_CORE_DATA.runs[index].fixture = fixture;
+                        if(GLOBAL_CORE_DATA.runs[index].scheduled) {
+                                fixture->pending_tests += 1;
+                        }
+                }
+        }
+}
+
+int TJames_Run()
+{
+        size_t failed_tests = 0;
+
+        GLOBAL_CORE_DATA.runs = calloc(TJames_TestCount() + 1, sizeof(struct TJames_TestRun));
+        if(GLOBAL_CORE_DATA.runs == NULL || TJames_SelectTests() != 0 || TJames_ShardTests() != 0) {
+                fprintf(stderr, "TJames Error: Memory allocation failed, while starting the run!\n");
+                TJames_Destroy();
+                return 1;
+        }
+        size_t test_count = GLOBAL_CORE_DATA.schedule_count;
+        for(size_t i = 0; i < test_count; ++i) {
+                GLOBAL_CORE_DATA.runs[GLOBAL_CORE_DATA.schedule[i]].scheduled = 1;
+        }
+        TJames_PrepareFixtures();
+        if(GLOBAL_CORE_DATA.options.cache_path != NULL && !GLOBAL_CORE_DATA.options.list_tests) {
+                TJames_PrepareCache(GLOBAL_CORE_DATA.options.cache_path);
+        }
+        if(GLOBAL_CORE_DATA.options.history_path != NULL && TJames_LoadHistory(GLOBAL_CORE_DATA.options.history_path) == 0) {
+                TJames_OrderByHistory();
+        }
+
+        unsigned long long run_start = TJames_ClockNs(CLOCK_MONOTONIC);
+        GLOBAL_CORE_DATA.run_start = run_start;
+        TJames_StartOutput();
+        if(GLOBAL_CORE_DATA.options.list_tests) {
+                for(size_t i = 0; i < test_count; ++i) {
+                        const struct TJames_TestFunc *func = TJames_GetTestFunc(GLOBAL_CORE_DATA.schedule[i]);
+                        TJames_DumpLineTestFunc(&GLOBAL_CORE_DATA.writer, &func->data);
+                }
+                if(GLOBAL_CORE_DATA.options.shard_count > 1) {
+                        TJames_WriterPrintf(&GLOBAL_CORE_DATA.writer, "\nListed %lu of %lu tests in shard %lu of %lu\n",
+                                test_count, TJames_TestCount(),
+                                GLOBAL_CORE_DATA.options.shard_index, GLOBAL_CORE_DATA.options.shard_count);
+                } else {
+                        TJames_WriterPrintf(&GLOBAL_CORE_DATA.writer, "\nListed %lu of %lu tests\n", test_count, TJames_TestCount());
+                }
+                TJames_Destroy();
+                return 0;
+        }
+
+        if((GLOBAL_CORE_DATA.options.baseline_path != NULL || GLOBAL_CORE_DATA.options.save_baseline_path != NULL) &&
+                test_count > 0 && GLOBAL_CORE_DATA.options.soak_time == 0.0 &&
+                GLOBAL_CORE_DATA.options.repeat_count < TJAMES_BASELINE_MIN_SAMPLES) {
+                fprintf(stderr, "TJames: Tests need --repeat %d or more, or --soak, to be compared to a baseline!\n",
+                        TJAMES_BASELINE_MIN_SAMPLES);
+        }
+
+        GLOBAL_CORE_DATA.reporter->begin_run(&GLOBAL_CORE_DATA.writer, test_count);
+        if(GLOBAL_CORE_DATA.options.events_path != NULL && TJames_OpenEvents(GLOBAL_CORE_DATA.options.events_path) == 0) {
+                unsigned long long values[] = { test_count, GLOBAL_CORE_DATA.options.jobs };
+                TJames_EmitEvent(RUN_BEGIN_EVENT, SIZE_MAX, values, 2);
+        }
+
+        atomic_store(&GLOBAL_CORE_DATA.abort_position, SIZE_MAX);
+        if(GLOBAL_CORE_DATA.options.repeat_count > 0 || GLOBAL_CORE_DATA.options.soak_time > 0.0) {
+                TJames_StartWatchdog((GLOBAL_CORE_DATA.options.jobs > 0) ? GLOBAL_CORE_DATA.options.jobs : 1);
+                failed_tests = TJames_RunRepeated();
+                TJames_StopWatchdog();
+        } else if(GLOBAL_CORE_DATA.options.isolate && test_count > 0) {
+                failed_tests = TJames_RunIsolated();
+        } else if(GLOBAL_CORE_DATA.options.jobs > 1 && test_count > 1) {
+                TJames_StartWatchdog(GLOBAL_CORE_DATA.options.jobs);
+                failed_tests = TJames_RunParallel();
+                TJames_StopWatchdog();
+        } else {
+                TJames_StartWatchdog(1);
+                failed_tests = TJames_RunSerial();
+                TJames_StopWatchdog();
+        }
+        size_t dropped_tests = 0;
+        int aborted = atomic_load(&GLOBAL_CORE_DATA.abort_position) != SIZE_MAX;
+        if((GLOBAL_CORE_DATA.options.fail_fast || aborted) && GLOBAL_CORE_DATA.reported_tests < test_count) {
+                dropped_tests = TJames_DropUnreportedTests();
+                TJames_FlushWriter(&GLOBAL_CORE_DATA.writer);
+                if(aborted) {
+                        fprintf(stderr, "TJames Error: Ran out of execution contexts, %lu of %lu tests not run!\n", dropped_tests, test_count);
+                } else {
+                        fprintf(stderr, "TJames: Stopped at the first failure, %lu of %lu tests not run!\n", dropped_tests, test_count);
+                }
+                test_count = GLOBAL_CORE_DATA.schedule_count;
+        }
+
+        struct TJames_RunSummary summary;
+        summary.test_count = test_count;
+        summary.failed_tests = failed_tests;
+        summary.not_run_tests = dropped_tests;
+        summary.wall_time = (TJames_ClockNs(CLOCK_MONOTONIC) - run_start) / 1e9;
+        GLOBAL_CORE_DATA.reporter->end_run(&GLOBAL_CORE_DATA.writer, &summary);
+        unsigned long long values[] = { failed_tests, (unsigned long long)(summary.wall_time * 1e9) };
+        TJames_EmitEvent(RUN_END_EVENT, SIZE_MAX, values, 2);
+        TJames_CloseEvents();
+
+        if(GLOBAL_CORE_DATA.options.cache_path != NULL) {
+                TJames_SaveCache(GLOBAL_CORE_DATA.options.cache_path);
+        }
+        if(GLOBAL_CORE_DATA.history != NULL) {
+                TJames_SaveHistory(GLOBAL_CORE_DATA.options.history_path);
+        }
+
+        for(size_t i = 0; i < test_count && GLOBAL_CORE_DATA.options.save_baseline_path != NULL; ++i) {
+                size_t index = GLOBAL_CORE_DATA.schedule[i];
+                const struct TJames_TestRun *run = &GLOBAL_CORE_DATA.runs[index];
+                // Fewer samples could never be compared, only --repeat and --soak give enough.
+                if(!run->cached && run->sample_count >= TJAMES_BASELINE_MIN_SAMPLES) {
+                        TJames_SaveBaseline(BASELINE_TEST, &TJames_GetTestFunc(index)->data, run->samples, run->sample_count);
+                }
+        }
+
+        if(GLOBAL_CORE_DATA.options.record_timings_path != NULL) {
+                TJames_RecordTimings(GLOBAL_CORE_DATA.options.record_timings_path);
+        }
+
+        size_t failed_benchmarks = 0;
+        if(GLOBAL_CORE_DATA.options.run_benchmarks && GLOBAL_CORE_DATA.bench_list.count > 0) {
+                failed_benchmarks = TJames_RunBenchmarks();
+        }
+
+        size_t failed_loads = 0;
+        if(GLOBAL_CORE_DATA.options.run_loads && GLOBAL_CORE_DATA.load_list.count > 0) {
+                failed_loads = TJames_RunLoads();
+        }
+
+        TJames_Destroy();
+        return failed_tests != 0 || failed_benchmarks != 0 || failed_loads != 0 || aborted;
+}
+
+void TJames_FillFuncData(struct TJames_TestFuncData *data,
+        const char *func_name,
+        const char *group_name,
+        const size_t added_on_line,
+        const char* file)
+{
+        data->func_name = func_name;
+        data->group_name = (group_name) ? group_name : "Default";
+        data->added_on_line = added_on_line;
+        data->file = file;
+        data->file_name = GetFileName(file);
+        data->timeout_ms = 0;
+}
+
+int TJames_AddFunc(const TestFuncPtr func_ptr,
+        const char *func_name,
+        const char *group_name,
+        const size_t added_on_line,
+        const char* file)
+{
+        return TJames_AddTimedFunc(func_ptr, func_name, group_name, 0, added_on_line, file);
+}
+
+int TJames_AddTimedFunc(const TestFuncPtr func_ptr,
         const char *func_name,
         const char *group_name,
+        const size_t timeout_ms,
         const size_t added_on_line,
         const char* file)
 {
         struct TJames_TestFunc test_func;
         test_func.func_ptr = func_ptr;
-        test_func.data.func_name = func_name;
-        test_func.data.group_name = (group_name) ? group_name : "Default";
-        test_func.data.added_on_line = added_on_line;
-        test_func.data.file = file;
-        test_func.data.file_name = GetFileName(file);
-        return TJames_AddToList(&GLOBAL_CORE_DATA.func_list, &test_func);
+        test_func.chunk = NULL;
+        TJames_FillFuncData(&test_func.data, func_name, group_name, added_on_line, file);
+        test_func.data.timeout_ms = timeout_ms;
+        if(TJames_AddToList(&GLOBAL_CORE_DATA.func_list, &test_func) != 0) {
+                return -1;
+        }
+        return TJames_IndexTest(TJames_TestCount() - 1);
+}
+
+// Maps the case file and registers a test per chunk of its rows. The rows are
+// only counted here, the chunks remember where they start and end.
+int TJames_AddTable(const TableFuncPtr func_ptr,
+        const char *func_name,
+        const char *group_name,
+        const char *path,
+        const size_t rows_per_chunk,
+        const size_t added_on_line,
+        const char* file)
+{
+        size_t chunk_rows = (rows_per_chunk > 0) ? rows_per_chunk : TJAMES_TABLE_CHUNK_ROWS;
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        struct stat info;
+        if(fd < 0 || fstat(fd, &info) != 0) {
+                fprintf(stderr, "TJames Error: Failed to open table '%s': %s!\n", path, strerror(errno));
+                if(fd >= 0) {
+                        close(fd);
+                }
+                return -1;
+        }
+        if(info.st_size == 0) {
+                close(fd);
+                fprintf(stderr, "TJames Error: Table '%s' has no rows!\n", path);
+                return -1;
+        }
+
+        struct TJames_Table *table = calloc(1, sizeof(struct TJames_Table));
+        void *data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if(table == NULL || data == MAP_FAILED) {
+                fprintf(stderr, "TJames Error: Failed to map table '%s'!\n", path);
+                free(table);
+                if(data != MAP_FAILED) {
+                        munmap(data, info.st_size);
+                }
+                return -1;
+        }
+        table->func_ptr = func_ptr;
+        table->data = data;
+        table->size = info.st_size;
+        if(TJames_AddToList(&GLOBAL_CORE_DATA.table_list, &table) != 0) {
+                munmap(data, info.st_size);
+                free(table);
+                return -1;
+        }
+
+        struct TJames_List chunks = TJames_CreateList(sizeof(struct TJames_Chunk));
+        struct TJames_Chunk chunk;
+        chunk.kind = TABLE_CHUNK;
+        chunk.table = table;
+        chunk.property = NULL;
+        chunk.first_row = 0;
+        chunk.begin = 0;
+        size_t row_count = 0;
+        const char *cursor = table->data;
+        const char *end = table->data + table->size;
+        while(cursor < end) {
+                const char *line_end = memchr(cursor, '\n', end - cursor);
+                cursor = (line_end != NULL) ? line_end + 1 : end;
+                row_count += 1;
+                if(row_count % chunk_rows == 0 || cursor == end) {
+                        chunk.end = cursor - table->data;
+                        chunk.name = NULL;
+                        if(TJames_AddToList(&chunks, &chunk) != 0) {
+                                break;
+                        }
+                        chunk.first_row = row_count;
+                        chunk.begin = chunk.end;
+                }
+        }
+        table->chunks = chunks.data;
+        table->chunk_count = chunks.count;
+
+        for(size_t i = 0; i < table->chunk_count; ++i) {
+                struct TJames_Chunk *current = &table->chunks[i];
+                size_t last_row = (i + 1 < table->chunk_count) ? table->chunks[i + 1].first_row - 1 : row_count - 1;
+                size_t name_length = snprintf(NULL, 0, "%s[%lu-%lu]", func_name, current->first_row, last_row) + 1;
+                current->name = malloc(name_length);
+                if(current->name == NULL) {
+                        fprintf(stderr, "TJames Error: Memory allocation failed, while registering table '%s'!\n", path);
+                        return -1;
+                }
+                snprintf(current->name, name_length, "%s[%lu-%lu]", func_name, current->first_row, last_row);
+
+                struct TJames_TestFunc test_func;
+                test_func.func_ptr = NULL;
+                test_func.chunk = current;
+                TJames_FillFuncData(&test_func.data, current->name, group_name, added_on_line, file);
+                if(TJames_AddToList(&GLOBAL_CORE_DATA.func_list, &test_func) != 0 ||
+                        TJames_IndexTest(TJames_TestCount() - 1) != 0) {
+                        return -1;
+                }
+        }
+        return 0;
+}
+
+// Registers a test per TJAMES_PROPERTY_CHUNK_CASES cases of the property.
+int TJames_AddProperty(const struct TJames_Property *property,
+        const char *func_name,
+        const char *group_name,
+        const size_t cases,
+        const size_t added_on_line,
+        const char* file)
+{
+        size_t case_count = (cases > 0) ? cases : TJAMES_PROPERTY_CASES;
+        for(size_t begin = 0; begin < case_count; begin += TJAMES_PROPERTY_CHUNK_CASES) {
+                struct TJames_Chunk *chunk = calloc(1, sizeof(struct TJames_Chunk));
+                if(chunk == NULL || TJames_AddToList(&GLOBAL_CORE_DATA.property_chunks, &chunk) != 0) {
+                        fprintf(stderr, "TJames Error: Memory allocation failed, while registering property '%s'!\n", func_name);
+                        free(chunk);
+                        return -1;
+                }
+                chunk->kind = PROPERTY_CHUNK;
+                chunk->property = property;
+                chunk->first_row = begin;
+                chunk->begin = begin;
+                chunk->end = (case_count - begin > TJAMES_PROPERTY_CHUNK_CASES) ? begin + TJAMES_PROPERTY_CHUNK_CASES : case_count;
+
+                size_t name_length = snprintf(NULL, 0, "%s[%lu-%lu]", func_name, chunk->begin, chunk->end - 1) + 1;
+                chunk->name = malloc(name_length);
+                if(chunk->name == NULL) {
+                        fprintf(stderr, "TJames Error: Memory allocation failed, while registering property '%s'!\n", func_name);
+                        return -1;
+                }
+                snprintf(chunk->name, name_length, "%s[%lu-%lu]", func_name, chunk->begin, chunk->end - 1);
+
+                struct TJames_TestFunc test_func;
+                test_func.func_ptr = NULL;
+                test_func.chunk = chunk;
+                TJames_FillFuncData(&test_func.data, chunk->name, group_name, added_on_line, file);
+                if(TJames_AddToList(&GLOBAL_CORE_DATA.func_list, &test_func) != 0 ||
+                        TJames_IndexTest(TJames_TestCount() - 1) != 0) {
+                        return -1;
+                }
+        }
+        return 0;
+}
+
+struct TJames_Fixture *TJames_RequireFixture(const char *group_name)
+{
+        const char *name = (group_name) ? group_name : "Default";
+        for(size_t i = 0; i < GLOBAL_CORE_DATA.fixtures.count; ++i) {
+                struct TJames_Fixture *fixture = LIST_E(struct TJames_Fixture*, GLOBAL_CORE_DATA.fixtures, i);
+                if(strcmp(fixture->group_name, name) == 0) {
+                        return fixture;
+                }
+        }
+
+        struct TJames_Fixture *fixture = calloc(1, sizeof(struct TJames_Fixture));
+        if(fixture == NULL || TJames_AddToList(&GLOBAL_CORE_DATA.fixtures, &fixture) != 0) {
+                fprintf(stderr, "TJames Error: Memory allocation failed, while adding a fixture to group '%s'!\n", name);
+                free(fixture);
+                return NULL;
+        }
+        fixture->group_name = name;
+        pthread_mutex_init(&fixture->mutex, NULL);
+        return fixture;
+}
+
+int TJames_AddGroupFixture(const char *group_name, const GroupSetupPtr setup, const TeardownPtr teardown)
+{
+        struct TJames_Fixture *fixture = TJames_RequireFixture(group_name);
+        if(fixture == NULL) {
+                return -1;
+        }
+        fixture->group_setup = setup;
+        fixture->group_teardown = teardown;
+        return 0;
+}
+
+int TJames_AddTestFixture(const char *group_name, const TestSetupPtr setup, const TeardownPtr teardown)
+{
+        struct TJames_Fixture *fixture = TJames_RequireFixture(group_name);
+        if(fixture == NULL) {
+                return -1;
+        }
+        fixture->test_setup = setup;
+        fixture->test_teardown = teardown;
+        return 0;
+}
+
+int TJames_AddBench(const BenchFuncPtr func_ptr,
+        const char *func_name,
+        const char *group_name,
+        const size_t added_on_line,
+        const char* file)
+{
+        struct TJames_BenchFunc bench_func;
+        bench_func.func_ptr = func_ptr;
+        TJames_FillFuncData(&bench_func.data, func_name, group_name, added_on_line, file);
+        return TJames_AddToList(&GLOBAL_CORE_DATA.bench_list, &bench_func);
+}
+
+int TJames_AddLoad(const LoadFuncPtr func_ptr,
+        const char *func_name,
+        const char *group_name,
+        const size_t max_threads,
+        const size_t added_on_line,
+        const char* file)
+{
+        struct TJames_LoadFunc load_func;
+        load_func.func_ptr = func_ptr;
+        load_func.max_threads = max_threads;
+        TJames_FillFuncData(&load_func.data, func_name, group_name, added_on_line, file);
+        return TJames_AddToList(&GLOBAL_CORE_DATA.load_list, &load_func);
+}
+
+int TJames_ParseSize(const char *option, const char *value, size_t *out)
+{
+        char *end = NULL;
+        if(value == NULL || *value == '\0' || *value == '-') {
+                fprintf(stderr, "TJames Error: Option '%s' expects a positive number!\n", option);
+                return -1;
+        }
+        unsigned long long parsed = strtoull(value, &end, 10);
+        if(*end != '\0') {
+                fprintf(stderr, "TJames Error: Option '%s' expects a positive number, got '%s'!\n", option, value);
+                return -1;
+        }
+        *out = parsed;
+        return 0;
+}
+
+int TJames_ParseArgs(const int argc, char **argv)
+{
+        for(int i = 1; i < argc; ++i) {
+                const char *arg = argv[i];
+                const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+                if(strcmp(arg, "--jobs") == 0 || strcmp(arg, "-j") == 0) {
+                        size_t jobs;
+                        if(TJames_ParseSize(arg, value, &jobs) != 0) {
+                                return -1;
+                        }
+                        if(jobs == 0) {
+                                long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+                                jobs = (cpus > 0) ? (size_t)cpus : 1;
+                        }
+                        GLOBAL_CORE_DATA.options.jobs = jobs;
+                        ++i;
+                } else if(strcmp(arg, "--isolate") == 0) {
+                        GLOBAL_CORE_DATA.options.isolate = 1;
+                } else if(strcmp(arg, "--bench") == 0) {
+                        GLOBAL_CORE_DATA.options.run_benchmarks = 1;
+                } else if(strcmp(arg, "--bench-samples") == 0) {
+                        size_t samples;
+                        if(TJames_ParseSize(arg, value, &samples) != 0 || samples == 0) {
+                                return -1;
+                        }
+                        GLOBAL_CORE_DATA.options.bench_samples = samples;
+                        ++i;
+                } else if(strcmp(arg, "--bench-time") == 0) {
+                        size_t milliseconds;
+                        if(TJames_ParseSize(arg, value, &milliseconds) != 0 || milliseconds == 0) {
+                                return -1;
+                        }
+                        GLOBAL_CORE_DATA.options.bench_sample_time = milliseconds / 1000.0;
+                        ++i;
+                } else if(strcmp(arg, "--load") == 0) {
+                        GLOBAL_CORE_DATA.options.run_loads = 1;
+                } else if(strcmp(arg, "--load-time") == 0) {
+                        size_t milliseconds;
+                        if(TJames_ParseSize(arg, value, &milliseconds) != 0 || milliseconds == 0) {
+                                return -1;
+                        }
+                        GLOBAL_CORE_DATA.options.load_time = milliseconds / 1000.0;
+                        ++i;
+                } else if(strcmp(arg, "--slowest") == 0) {
+                        if(TJames_ParseSize(arg, value, &GLOBAL_CORE_DATA.options.slowest_count) != 0) {
+                                return -1;
+                        }
+                        ++i;
+                } else if(strcmp(arg, "--filter") == 0 || strcmp(arg, "--exclude") == 0) {
+                        if(value == NULL) {
+                                fprintf(stderr, "TJames Error: Option '%s' expects a pattern!\n", arg);
+                                return -1;
+                        }
+                        struct TJames_List *filters = (strcmp(arg, "--filter") == 0)
+                                ? &GLOBAL_CORE_DATA.options.filters
+                                : &GLOBAL_CORE_DATA.options.excludes;
+                        if(TJames_ParseFilters(filters, value) != 0) {
+                                return -1;
+                        }
+                        ++i;
+                } else if(strcmp(arg, "--shard-index") == 0) {
+                        if(TJames_ParseSize(arg, value, &GLOBAL_CORE_DATA.options.shard_index) != 0) {
+                                return -1;
+                        }
+                        ++i;
+                } else if(strcmp(arg, "--shard-count") == 0) {
+                        if(TJames_ParseSize(arg, value, &GLOBAL_CORE_DATA.options.shard_count) != 0) {
+                                return -1;
+                        }
+                        ++i;
+                } else if(strcmp(arg, "--timings-file") == 0 || strcmp(arg, "--record-timings") == 0) {
+                        if(value == NULL) {
+                                fprintf(stderr, "TJames Error: Option '%s' expects a file path!\n", arg);
+                                return -1;
+                        }
+                        if(strcmp(arg, "--timings-file") == 0) {
+                                GLOBAL_CORE_DATA.options.timings_path = value;
+                        } else {
+                                GLOBAL_CORE_DATA.options.record_timings_path = value;
+                        }
+                        ++i;
+                } else if(strcmp(arg, "--seed") == 0) {
+                        size_t seed;
+                        if(TJames_ParseSize(arg, value, &seed) != 0) {
+                                return -1;
+                        }
+                        GLOBAL_CORE_DATA.options.seed = seed;
+                        ++i;
+                } else if(strcmp(arg, "--golden-dir") == 0) {
+                        if(value == NULL) {
+                                fprintf(stderr, "TJames Error: Option '%s' expects a directory!\n", arg);
+                                return -1;
+                        }
+                        GLOBAL_CORE_DATA.options.golden_dir = value;
+                        ++i;
+                } else if(strcmp(arg, "--events") == 0) {
+                        if(value == NULL) {
+                                fprintf(stderr, "TJames Error: Option '%s' expects a file path!\n", arg);
+                                return -1;
+                        }
+                        GLOBAL_CORE_DATA.options.events_path = value;
+                        ++i;
+                } else if(strcmp(arg, "--cache") == 0) {
+                        if(value == NULL) {
+                                fprintf(stderr, "TJames Error: Option '%s' expects a file path!\n", arg);
+                                return -1;
+                        }
+                        GLOBAL_CORE_DATA.options.cache_path = value;
+                        ++i;
+                } else if(strcmp(arg, "--history") == 0) {
+                        if(value == NULL) {
+                                fprintf(stderr, "TJames Error: Option '%s' expects a file path!\n", arg);
+                                return -1;
+                        }
+                        GLOBAL_CORE_DATA.options.history_path = value;
+                        ++i;
+                } else if(strcmp(arg, "--fail-fast") == 0) {
+                        GLOBAL_CORE_DATA.options.fail_fast = 1;
+                } else if(strcmp(arg, "--repeat") == 0) {
+                        if(TJames_ParseSize(arg, value, &GLOBAL_CORE_DATA.options.repeat_count) != 0) {
+                                return -1;
+                        }
+                        ++i;
+                } else if(strcmp(arg, "--soak") == 0) {
+                        size_t milliseconds;
+                        if(TJames_ParseSize(arg, value, &milliseconds) != 0) {
+                                return -1;
+                        }
+                        GLOBAL_CORE_DATA.options.soak_time = milliseconds / 1000.0;
+                        ++i;
+                } else if(strcmp(arg, "--update-golden") == 0) {
+                        GLOBAL_CORE_DATA.options.update_golden = 1;
+                } else if(strcmp(arg, "--list") == 0) {
+                        GLOBAL_CORE_DATA.options.list_tests = 1;
+                } else if(strcmp(arg, "--reporter") == 0) {
+                        if(value == NULL || TJames_FindReporter(value) == NULL) {
+                                fprintf(stderr, "TJames Error: Option '%s' expects one of console, quiet, junit, json or tap!\n", arg);
+                                return -1;
+                        }
+                        GLOBAL_CORE_DATA.options.reporter_name = value;
+                        ++i;
+                } else if(strcmp(arg, "--output") == 0) {
+                        if(value == NULL) {
+                                fprintf(stderr, "TJames Error: Option '%s' expects a file path!\n", arg);
+                                return -1;
+                        }
+                        GLOBAL_CORE_DATA.options.output_path = value;
+                        ++i;
+                } else if(strcmp(arg, "--track-allocs") == 0) {
+                        if(!ALLOC_HOOKS_INSTALLED) {
+                                fprintf(stderr, "TJames Error: Allocation tracking needs tjames_alloc_hooks linked in!\n");
+                                return -1;
+                        }
+                        GLOBAL_CORE_DATA.options.track_allocs = 1;
+                } else if(strcmp(arg, "--perf-counters") == 0) {
+                        if(TJames_ProbePerfCounters() == 0) {
+                                fprintf(stderr, "TJames Error: No performance counters can be opened: %s!\n", strerror(errno));
+                                return -1;
+                        }
+                        GLOBAL_CORE_DATA.options.perf_counters = 1;
+                } else if(strcmp(arg, "--compare-baseline") == 0 || strcmp(arg, "--save-baseline") == 0) {
+                        if(value == NULL) {
+                                fprintf(stderr, "TJames Error: Option '%s' expects a file path!\n", arg);
+                                return -1;
+                        }
+                        if(strcmp(arg, "--compare-baseline") == 0) {
+                                GLOBAL_CORE_DATA.options.baseline_path = value;
+                        } else {
+                                GLOBAL_CORE_DATA.options.save_baseline_path = value;
+                        }
+                        ++i;
+                } else if(strcmp(arg, "--regression-threshold") == 0) {
+                        size_t percent;
+                        if(TJames_ParseSize(arg, value, &percent) != 0) {
+                                return -1;
+                        }
+                        GLOBAL_CORE_DATA.options.regression_threshold = percent / 100.0;
+                        ++i;
+                } else if(strcmp(arg, "--timeout") == 0) {
+                        size_t milliseconds;
+                        if(TJames_ParseSize(arg, value, &milliseconds) != 0) {
+                                return -1;
+                        }
+                        GLOBAL_CORE_DATA.options.timeout = milliseconds / 1000.0;
+                        ++i;
+                } else if(strcmp(arg, "--time-budget") == 0) {
+                        size_t milliseconds;
+                        if(TJames_ParseSize(arg, value, &milliseconds) != 0) {
+                                return -1;
+                        }
+                        GLOBAL_CORE_DATA.options.time_budget = milliseconds / 1000.0;
+                        ++i;
+                } else {
+                        fprintf(stderr, "TJames Error: Unknown option '%s'!\n", arg);
+                        return -1;
+                }
+        }
+        if(GLOBAL_CORE_DATA.options.shard_count == 0 ||
+                GLOBAL_CORE_DATA.options.shard_index >= GLOBAL_CORE_DATA.options.shard_count) {
+                fprintf(stderr, "TJames Error: Shard index %lu is out of range for %lu shards!\n",
+                        GLOBAL_CORE_DATA.options.shard_index, GLOBAL_CORE_DATA.options.shard_count);
+                return -1;
+        }
+        // The repeated runs keep their statistics in this process.
+        if(GLOBAL_CORE_DATA.options.isolate &&
+                (GLOBAL_CORE_DATA.options.repeat_count > 0 || GLOBAL_CORE_DATA.options.soak_time > 0.0)) {
+                fprintf(stderr, "TJames Error: --isolate can not be used with --repeat or --soak!\n");
+                return -1;
+        }
+        return 0;
 }
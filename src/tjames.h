@@ -1,7 +1,115 @@
 #include <stdlib.h>
 #include <math.h> // needed in floating point comparision
+#include <string.h> // needed in string comparision
 
 typedef void (*TestFuncPtr)();
+typedef void (*BenchFuncPtr)(const size_t iterations);
+typedef void (*LoadFuncPtr)(const size_t thread_index);
+typedef void *(*GroupSetupPtr)();
+typedef void *(*TestSetupPtr)(const void *group_state);
+typedef void (*TeardownPtr)(void *state);
+
+struct TJames_TestFuncData
+{
+        const char *func_name;
+        const char *group_name;
+        size_t added_on_line;
+        const char *file;
+        const char *file_name; // NULL if it has to be derived from file
+        size_t timeout_ms; // 0 falls back to --timeout
+};
+
+// A row of a table test. It points straight into the mapped case file and is
+// not NUL terminated, a trailing '\r' is not part of it.
+struct TJames_Row
+{
+        const char *data;
+        size_t length;
+        size_t index; // of the row in the whole table
+};
+
+typedef void (*TableFuncPtr)(const struct TJames_Row *row);
+
+enum TJames_GenKind
+{
+        INT_GEN = 0,
+        FLOAT_GEN,
+        STRING_GEN,
+        BYTES_GEN
+};
+
+// Describes how one argument of a property is generated, see TJAMES_GEN_*.
+struct TJames_Gen
+{
+        enum TJames_GenKind kind;
+        long long min;
+        long long max;
+        double min_float;
+        double max_float;
+        size_t max_length;
+        const char *alphabet; // NULL for printable ASCII
+};
+
+// A generated argument. Strings and byte buffers live in buffers of the
+// engine, which are reused for the next case; strings are NUL terminated.
+struct TJames_Value
+{
+        long long i;
+        double f;
+        const char *data;
+        size_t length;
+};
+
+typedef void (*PropertyFuncPtr)(const struct TJames_Value *values);
+
+struct TJames_Property
+{
+        PropertyFuncPtr func_ptr;
+        const struct TJames_Gen *gens;
+        size_t gen_count;
+};
+
+struct TJames_Chunk;
+
+struct TJames_TestFunc
+{
+        TestFuncPtr func_ptr;
+        struct TJames_TestFuncData data;
+        const struct TJames_Chunk *chunk; // rows of a table or cases of a property to run, NULL for plain tests
+};
+
+enum TJames_OperandKind
+{
+        SIGNED_OPERAND = 0,
+        UNSIGNED_OPERAND,
+        FLOATING_OPERAND,
+        CHAR_OPERAND,
+        STRING_OPERAND,
+        POINTER_OPERAND
+};
+
+// A operand of a failed TJAMES_EXPECT_* check, kept with its type so it is
+// only formatted once the failure is reported.
+struct TJames_Operand
+{
+        enum TJames_OperandKind kind;
+        union
+        {
+                long long i;
+                unsigned long long u;
+                double f;
+                const char *s;
+                const void *p;
+        };
+};
+
+// The part of a check that is known at compile time.
+struct TJames_Check
+{
+        const char *expression;
+        const char *op;
+        size_t line;
+};
 
 enum TJames_ErrorType
 {
@@ -15,7 +123,8 @@ enum TJames_TestResult
         EMPTY_TEST = 0,
         SUCCESSFUL_TEST,
         FAILED_TEST,
-        SKIPED_TEST
+        SKIPED_TEST,
+        CACHED_TEST
 };
 
 extern int TJames_AddFunc(const TestFuncPtr func_ptr,
@@ -24,12 +133,69 @@ extern int TJames_AddFunc(const TestFuncPtr func_ptr,
         const size_t added_on_line,
         const char* file);
 
+extern int TJames_AddTimedFunc(const TestFuncPtr func_ptr,
+        const char *func_name,
+        const char *group_name,
+        const size_t timeout_ms,
+        const size_t added_on_line,
+        const char* file);
+
+extern int TJames_AddTable(const TableFuncPtr func_ptr,
+        const char *func_name,
+        const char *group_name,
+        const char *path,
+        const size_t rows_per_chunk,
+        const size_t added_on_line,
+        const char* file);
+
+extern int TJames_AddProperty(const struct TJames_Property *property,
+        const char *func_name,
+        const char *group_name,
+        const size_t cases,
+        const size_t added_on_line,
+        const char* file);
+
+extern int TJames_AddBench(const BenchFuncPtr func_ptr,
+        const char *func_name,
+        const char *group_name,
+        const size_t added_on_line,
+        const char* file);
+
+extern int TJames_AddLoad(const LoadFuncPtr func_ptr,
+        const char *func_name,
+        const char *group_name,
+        const size_t max_threads,
+        const size_t added_on_line,
+        const char* file);
+
+extern int TJames_AddGroupFixture(const char *group_name, const GroupSetupPtr setup, const TeardownPtr teardown);
+extern int TJames_AddTestFixture(const char *group_name, const TestSetupPtr setup, const TeardownPtr teardown);
+
 extern void TJames_Init();
+extern int  TJames_ParseArgs(const int argc, char **argv);
 extern int  TJames_Run();
+extern size_t TJames_RunBenchmarks();
+extern size_t TJames_RunLoads();
 extern void TJames_Destroy();
 
 void TJames_PushError(const enum TJames_ErrorType type, const size_t line, const char* message, ...);
+// Stores `message` by pointer, it has to outlive the run (e.g. a string literal).
+void TJames_PushConstError(const enum TJames_ErrorType type, const size_t line, const char* message);
 extern void TJames_SetTestFuncResult(const enum TJames_TestResult result);
+extern void TJames_LimitAllocs(const size_t line, const size_t max_allocs);
+extern void TJames_ForbidLeaks(const size_t line);
+// Called by the malloc family of tjames_alloc_hooks.c, which only binaries that
+// track allocations link, since it replaces the allocator of the whole process.
+extern void TJames_InstallAllocHooks();
+extern void *TJames_HookedAlloc(void *ptr, const size_t size);
+extern void TJames_HookedRealloc(void *ptr, void *new_ptr, const size_t size);
+extern void TJames_HookedFree(void *ptr);
+extern void TJames_CheckFailed(const struct TJames_Check *check, const struct TJames_Operand a, const struct TJames_Operand b)
+        __attribute__((cold, noinline));
+// Checks that passed on this thread since the test result was last updated.
+extern _Thread_local size_t TJames_PassedChecks;
+extern const void *TJames_GroupState();
+extern void *TJames_TestState();
 
 // *--------------------------*
 // |                          |
@@ -40,6 +206,101 @@ extern void TJames_SetTestFuncResult(const enum TJames_TestResult result);
 #define TJAMES_ADD_GROUPED_FUNC(func_ptr, group) TJames_AddFunc(func_ptr, #func_ptr, group, __LINE__, __FILE__)
 #define TJAMES_ADD_FUNC(func_ptr) TJAMES_ADD_GROUPED_FUNC(func_ptr, NULL)
 
+// Like the above, but the test fails and the run is aborted if it takes longer
+// than `timeout_ms`, overriding --timeout.
+#define TJAMES_ADD_GROUPED_TIMED_FUNC(func_ptr, group, timeout_ms) \
+        TJames_AddTimedFunc(func_ptr, #func_ptr, group, timeout_ms, __LINE__, __FILE__)
+#define TJAMES_ADD_TIMED_FUNC(func_ptr, timeout_ms) TJAMES_ADD_GROUPED_TIMED_FUNC(func_ptr, NULL, timeout_ms)
+
+#ifdef __FILE_NAME__
+#define TJAMES_FILE_NAME __FILE_NAME__
+#else
+#define TJAMES_FILE_NAME NULL
+#endif
+
+// Defines a test which needs no registration call. Its constant descriptor is
+// referenced from the tjames_tests linker section, which the runner sorts by
+// file and line at startup, so tests from every translation unit are found
+// without a call each.
+#define TJAMES_TIMED_TEST(group, name, timeout_ms) \
+        static void name(); \
+        static const struct TJames_TestFunc TJames_TestFunc_##name = \
+                { name, { #name, group, __LINE__, __FILE__, TJAMES_FILE_NAME, timeout_ms }, NULL }; \
+        static const struct TJames_TestFunc *const TJames_TestFuncRef_##name \
+                __attribute__((used, section("tjames_tests"))) = &TJames_TestFunc_##name; \
+        static void name()
+#define TJAMES_TEST(group, name) TJAMES_TIMED_TEST(group, name, 0)
+
+// Maps the file at `path` and calls `func_ptr` once per line of it. Every
+// `rows_per_chunk` rows (0 for TJAMES_TABLE_CHUNK_ROWS) form a test of their
+// own, named "func_ptr[FIRST-LAST]", so chunks run concurrently and can be
+// filtered. Errors pushed from a row carry its index.
+#define TJAMES_TABLE_CHUNK_ROWS 1024
+#define TJAMES_ADD_GROUPED_TABLE(func_ptr, group, path, rows_per_chunk) \
+        TJames_AddTable(func_ptr, #func_ptr, group, path, rows_per_chunk, __LINE__, __FILE__)
+#define TJAMES_ADD_TABLE(func_ptr, path, rows_per_chunk) TJAMES_ADD_GROUPED_TABLE(func_ptr, NULL, path, rows_per_chunk)
+
+// Defines a property `name` over the arguments the given TJAMES_GEN_*
+// descriptors generate, e.g.
+//
+//      TJAMES_PROPERTY(reverse_twice, TJAMES_GEN_STRING(64, NULL)) { ... values[0].data ... }
+//
+// It is registered with TJAMES_ADD_PROPERTY and run on `cases` (0 for
+// TJAMES_PROPERTY_CASES) generated cases, split into tests of
+// TJAMES_PROPERTY_CHUNK_CASES cases that run concurrently. A failing case is
+// shrunk and reported together with the --seed that reproduces it.
+#define TJAMES_PROPERTY_CASES 1000
+#define TJAMES_PROPERTY_CHUNK_CASES 250
+#define TJAMES_GEN_INT(min, max) { INT_GEN, (min), (max), 0.0, 0.0, 0, NULL }
+#define TJAMES_GEN_FLOAT(min, max) { FLOAT_GEN, 0, 0, (min), (max), 0, NULL }
+#define TJAMES_GEN_STRING(max_length, alphabet) { STRING_GEN, 0, 0, 0.0, 0.0, (max_length), (alphabet) }
+#define TJAMES_GEN_BYTES(max_length) { BYTES_GEN, 0, 0, 0.0, 0.0, (max_length), NULL }
+#define TJAMES_PROPERTY(name, ...) \
+        static void name(const struct TJames_Value *values); \
+        static const struct TJames_Gen TJames_PropertyGens_##name[] = { __VA_ARGS__ }; \
+        static const struct TJames_Property TJames_Property_##name = { name, TJames_PropertyGens_##name, \
+                sizeof(TJames_PropertyGens_##name) / sizeof(struct TJames_Gen) }; \
+        static void name(const struct TJames_Value *values)
+#define TJAMES_ADD_GROUPED_PROPERTY(name, group, cases) \
+        TJames_AddProperty(&TJames_Property_##name, #name, group, cases, __LINE__, __FILE__)
+#define TJAMES_ADD_PROPERTY(name, cases) TJAMES_ADD_GROUPED_PROPERTY(name, NULL, cases)
+
+// Attaches setup and teardown hooks to the tests of `group` (NULL for the
+// default group). The group setup runs once, when the first of its tests is
+// about to run, and its state is shared read-only by all of them, on any
+// thread, until it is torn down after the last one. The test setup runs
+// before every test and receives the group state. Either setup may fail with
+// TJAMES_FAILURE, which fails the tests depending on it.
+#define TJAMES_ADD_GROUP_FIXTURE(group, setup, teardown) TJames_AddGroupFixture(group, setup, teardown)
+#define TJAMES_ADD_TEST_FIXTURE(group, setup, teardown) TJames_AddTestFixture(group, setup, teardown)
+#define TJAMES_GROUP_STATE(type) ((const type*)TJames_GroupState())
+#define TJAMES_TEST_STATE(type) ((type*)TJames_TestState())
+
+// Benchmarks receive the number of iterations they have to run, the runner
+// calibrates that count so that every sample takes about --bench-time ms.
+#define TJAMES_ADD_GROUPED_BENCH(func_ptr, group) TJames_AddBench(func_ptr, #func_ptr, group, __LINE__, __FILE__)
+#define TJAMES_ADD_BENCH(func_ptr) TJAMES_ADD_GROUPED_BENCH(func_ptr, NULL)
+
+// Load tests run with --load. Their function is called in a loop from 1, 2,
+// 4 ... `max_threads` (0 for one per CPU) threads pinned to distinct CPUs,
+// for --load-time ms per thread count. The latency of every call is recorded,
+// and the throughput, percentiles and scaling efficiency of each thread count
+// are reported.
+#define TJAMES_ADD_GROUPED_LOAD(func_ptr, group, max_threads) \
+        TJames_AddLoad(func_ptr, #func_ptr, group, max_threads, __LINE__, __FILE__)
+#define TJAMES_ADD_LOAD(func_ptr, max_threads) TJAMES_ADD_GROUPED_LOAD(func_ptr, NULL, max_threads)
+
+// *--------------------------*
+// |                          |
+// |   OPTIMIZATION BARRIERS  |
+// |                          |
+// *--------------------------*
+
+// Forces `value` to be computed, without storing it anywhere.
+#define TJAMES_DO_NOT_OPTIMIZE(value) __asm__ __volatile__("" : : "r,m"(value) : "memory")
+// Forces all pending writes to memory to be treated as observable.
+#define TJAMES_CLOBBER_MEMORY() __asm__ __volatile__("" : : : "memory")
+
 // *-----------------------*
 // |                       |
 // |   BASIS TEST MACROS   |
@@ -56,7 +317,14 @@ extern void TJames_SetTestFuncResult(const enum TJames_TestResult result);
 
 #define TJAMES_FAILURE(message) do { \
                                         TJames_SetTestFuncResult(FAILED_TEST); \
-                                        TJames_PushError(NORMAL_ERROR, __LINE__, message); \
+                                        TJames_PushError(NORMAL_ERROR, __LINE__, "%s", message); \
+                                } while(0)
+
+// The _CONST variants only take string literals, which are stored by pointer
+// instead of being copied.
+#define TJAMES_FAILURE_CONST(message) do { \
+                                        TJames_SetTestFuncResult(FAILED_TEST); \
+                                        TJames_PushConstError(NORMAL_ERROR, __LINE__, "" message); \
                                 } while(0)
 
 #define TJAMES_FAILURE_FMT(message, ...) do { \
@@ -69,19 +337,39 @@ extern void TJames_SetTestFuncResult(const enum TJames_TestResult result);
                                                 return; \
                                         } while(0)
 
+#define TJAMES_FAILURE_EXIT_CONST(message)      do { \
+                                                        TJAMES_FAILURE_CONST(message); \
+                                                        return; \
+                                                } while(0)
+
 #define TJAMES_FAILURE_EXIT_FMT(message, ...) do { \
                                                 TJAMES_FAILURE_FMT(message, __VA_ARGS__); \
                                                 return; \
                                         } while(0)
 
 #define TJAMES_WARNING(message) do { \
-                                        TJames_PushError(WARNING_ERROR, __LINE__, message); \
+                                        TJames_PushError(WARNING_ERROR, __LINE__, "%s", message); \
+                                } while(0)
+
+#define TJAMES_WARNING_CONST(message) do { \
+                                        TJames_PushConstError(WARNING_ERROR, __LINE__, "" message); \
                                 } while(0)
 
 #define TJAMES_WARNING_FMT(message, ...) do { \
                                         TJames_PushError(WARNING_ERROR, __LINE__, message, __VA_ARGS__); \
                                 } while(0)
 
+// Fails the test if it makes more than `n` heap allocations from here until it
+// returns. Allocations of the framework itself are not counted.
+#define TJAMES_MAX_ALLOCS(n)    do { \
+                                        TJames_LimitAllocs(__LINE__, n); \
+                                } while(0)
+
+// Fails the test if memory it allocates from here on is still allocated once it returns.
+#define TJAMES_NO_LEAKS()       do { \
+                                        TJames_ForbidLeaks(__LINE__); \
+                                } while(0)
+
 #define TJAMES_SKIP()   do { \
                                 TJames_SetTestFuncResult(SKIPED_TEST); \
                                 return; \
@@ -95,29 +383,38 @@ extern void TJames_SetTestFuncResult(const enum TJames_TestResult result);
 
 #define TJAMES_CMP_BASE(comparision, message)   do { \
                                                 if (comparision) { \
-                                                        TJAMES_SUCCESS(); \
+                                                        TJames_PassedChecks += 1; \
                                                 } else { \
                                                         TJAMES_FAILURE_EXIT(message); \
                                                 } \
                                         } while(0)
 
+#define TJAMES_CMP_BASE_CONST(comparision, message)     do { \
+                                                if (comparision) { \
+                                                        TJames_PassedChecks += 1; \
+                                                } else { \
+                                                        TJAMES_FAILURE_EXIT_CONST(message); \
+                                                } \
+                                        } while(0)
+
 #define TJAMES_CMP_BASE_FMT(comparision, message, ...)   do { \
                                                 if (comparision) { \
-                                                        TJAMES_SUCCESS(); \
+                                                        TJames_PassedChecks += 1; \
                                                 } else { \
                                                         TJAMES_FAILURE_EXIT_FMT(message, __VA_ARGS__); \
                                                 } \
                                         } while(0)
 
 #define TJAMES_CMP(a, op, b, message) TJAMES_CMP_BASE(a op b, message)
+#define TJAMES_CMP_CONST(a, op, b, message) TJAMES_CMP_BASE_CONST(a op b, message)
 #define TJAMES_CMP_FMT(a, op, b, message, ...) TJAMES_CMP_BASE_FMT(a op b, message, __VA_ARGS__)
 
-#define         TJAMES_EQUAL(a, b) TJAMES_CMP(a, ==, b, "Failed generic equal comparison!") 
-#define     TJAMES_NOT_EQUAL(a, b) TJAMES_CMP(a, !=, b, "Failed generic not equal comparison!") 
-#define          TJAMES_LESS(a, b) TJAMES_CMP(a, <,  b, "Failed generic less comparison!") 
-#define       TJAMES_GREATER(a, b) TJAMES_CMP(a, >,  b, "Failed generic greater comparison!") 
-#define    TJAMES_LESS_EQUAL(a, b) TJAMES_CMP(a, <=, b, "Failed generic less equal comparison!") 
-#define TJAMES_GREATER_EQUAL(a, b) TJAMES_CMP(a, >=, b, "Failed generic greater equal comparison!") 
+#define         TJAMES_EQUAL(a, b) TJAMES_CMP_CONST(a, ==, b, "Failed generic equal comparison!") 
+#define     TJAMES_NOT_EQUAL(a, b) TJAMES_CMP_CONST(a, !=, b, "Failed generic not equal comparison!") 
+#define          TJAMES_LESS(a, b) TJAMES_CMP_CONST(a, <,  b, "Failed generic less comparison!") 
+#define       TJAMES_GREATER(a, b) TJAMES_CMP_CONST(a, >,  b, "Failed generic greater comparison!") 
+#define    TJAMES_LESS_EQUAL(a, b) TJAMES_CMP_CONST(a, <=, b, "Failed generic less equal comparison!") 
+#define TJAMES_GREATER_EQUAL(a, b) TJAMES_CMP_CONST(a, >=, b, "Failed generic greater equal comparison!") 
 
 #define         TJAMES_EQUAL_FMT(a, b, a_fc, b_fc) TJAMES_CMP_FMT(a, ==, b, "Failed \"" #a_fc "\" == \"" #b_fc "\"!", a, b) 
 #define     TJAMES_NOT_EQUAL_FMT(a, b, a_fc, b_fc) TJAMES_CMP_FMT(a, !=, b, "Failed \"" #a_fc "\" != \"" #b_fc "\"!", a, b) 
@@ -133,17 +430,17 @@ extern void TJames_SetTestFuncResult(const enum TJames_TestResult result);
 #define    TJAMES_FLOATING_LESS_EQUAL_CONDITION(a, b, delta) ((a) <= (b) + (delta))
 #define TJAMES_FLOATING_GREATER_EQUAL_CONDITION(a, b, delta) ((a) >= (b) - (delta))
 
-#define         TJAMES_FLOATING_EQUAL(a, b, delta) TJAMES_CMP_BASE(TJAMES_FLOATING_EQUAL_CONDITION(a, b, delta), \
+#define         TJAMES_FLOATING_EQUAL(a, b, delta) TJAMES_CMP_BASE_CONST(TJAMES_FLOATING_EQUAL_CONDITION(a, b, delta), \
                                                                         "Failed generic floating equal comparison!") 
-#define     TJAMES_FLOATING_NOT_EQUAL(a, b, delta) TJAMES_CMP_BASE(TJAMES_FLOATING_NOT_EQUAL_CONDITION(a, b, delta), \
+#define     TJAMES_FLOATING_NOT_EQUAL(a, b, delta) TJAMES_CMP_BASE_CONST(TJAMES_FLOATING_NOT_EQUAL_CONDITION(a, b, delta), \
                                                                         "Failed generic floating not equal comparison!") 
-#define          TJAMES_FLOATING_LESS(a, b, delta) TJAMES_CMP_BASE(TJAMES_FLOATING_LESS_CONDITION(a, b, delta), \
+#define          TJAMES_FLOATING_LESS(a, b, delta) TJAMES_CMP_BASE_CONST(TJAMES_FLOATING_LESS_CONDITION(a, b, delta), \
                                                                         "Failed generic floating less comparison!") 
-#define       TJAMES_FLOATING_GREATER(a, b, delta) TJAMES_CMP_BASE(TJAMES_FLOATING_GREATER_CONDITION(a, b, delta), \
+#define       TJAMES_FLOATING_GREATER(a, b, delta) TJAMES_CMP_BASE_CONST(TJAMES_FLOATING_GREATER_CONDITION(a, b, delta), \
                                                                         "Failed generic floating greater comparison!") 
-#define    TJAMES_FLOATING_LESS_EQUAL(a, b, delta) TJAMES_CMP_BASE(TJAMES_FLOATING_LESS_EQUAL_CONDITION(a, b, delta), \
+#define    TJAMES_FLOATING_LESS_EQUAL(a, b, delta) TJAMES_CMP_BASE_CONST(TJAMES_FLOATING_LESS_EQUAL_CONDITION(a, b, delta), \
                                                                         "Failed generic floating less equal comparison!") 
-#define TJAMES_FLOATING_GREATER_EQUAL(a, b, delta) TJAMES_CMP_BASE(TJAMES_FLOATING_GREATER_EQUAL_CONDITION(a, b, delta), \
+#define TJAMES_FLOATING_GREATER_EQUAL(a, b, delta) TJAMES_CMP_BASE_CONST(TJAMES_FLOATING_GREATER_EQUAL_CONDITION(a, b, delta), \
                                                                         "Failed generic floating greater equal comparison!") 
 
 #define         TJAMES_FLOATING_EQUAL_FMT(a, b, delta, a_fc, b_fc) TJAMES_CMP_BASE_FMT(TJAMES_FLOATING_EQUAL_CONDITION(a, b, delta), \
@@ -263,3 +560,200 @@ extern void TJames_SetTestFuncResult(const enum TJames_TestResult result);
 #define       TJAMES_GREATER_LONGDOUBLE(a, b)       TJAMES_FLOATING_GREATER_FMT(a, b, TJAMES_LONGDOUBLE_DELTA, %Lf, %Lf)
 #define    TJAMES_LESS_EQUAL_LONGDOUBLE(a, b)    TJAMES_FLOATING_LESS_EQUAL_FMT(a, b, TJAMES_LONGDOUBLE_DELTA, %Lf, %Lf)
 #define TJAMES_GREATER_EQUAL_LONGDOUBLE(a, b) TJAMES_FLOATING_GREATER_EQUAL_FMT(a, b, TJAMES_LONGDOUBLE_DELTA, %Lf, %Lf)
+
+// *-------------------------*
+// |                         |
+// |   TYPE-GENERIC CHECKS   |
+// |                         |
+// *-------------------------*
+
+// Unlike the macros above these take operands of any arithmetic, string or
+// pointer type and evaluate them once. A passing check only counts, a failing
+// one records its operands with their type and lets the test carry on; the
+// message is formatted once the failure is reported.
+
+static inline struct TJames_Operand TJames_SignedOperand(const long long value)
+{
+        struct TJames_Operand operand;
+        operand.kind = SIGNED_OPERAND;
+        operand.i = value;
+        return operand;
+}
+
+static inline struct TJames_Operand TJames_UnsignedOperand(const unsigned long long value)
+{
+        struct TJames_Operand operand;
+        operand.kind = UNSIGNED_OPERAND;
+        operand.u = value;
+        return operand;
+}
+
+static inline struct TJames_Operand TJames_FloatingOperand(const double value)
+{
+        struct TJames_Operand operand;
+        operand.kind = FLOATING_OPERAND;
+        operand.f = value;
+        return operand;
+}
+
+static inline struct TJames_Operand TJames_CharOperand(const char value)
+{
+        struct TJames_Operand operand;
+        operand.kind = CHAR_OPERAND;
+        operand.i = value;
+        return operand;
+}
+
+static inline struct TJames_Operand TJames_StringOperand(const char *value)
+{
+        struct TJames_Operand operand;
+        operand.kind = STRING_OPERAND;
+        operand.s = value;
+        return operand;
+}
+
+static inline struct TJames_Operand TJames_PointerOperand(const void *value)
+{
+        struct TJames_Operand operand;
+        operand.kind = POINTER_OPERAND;
+        operand.p = value;
+        return operand;
+}
+
+#define TJAMES_OPERAND(value) _Generic((value), \
+        _Bool: TJames_UnsignedOperand, \
+        char: TJames_CharOperand, \
+        signed char: TJames_SignedOperand, \
+        short: TJames_SignedOperand, \
+        int: TJames_SignedOperand, \
+        long: TJames_SignedOperand, \
+        long long: TJames_SignedOperand, \
+        unsigned char: TJames_UnsignedOperand, \
+        unsigned short: TJames_UnsignedOperand, \
+        unsigned int: TJames_UnsignedOperand, \
+        unsigned long: TJames_UnsignedOperand, \
+        unsigned long long: TJames_UnsignedOperand, \
+        float: TJames_FloatingOperand, \
+        double: TJames_FloatingOperand, \
+        long double: TJames_FloatingOperand, \
+        char*: TJames_StringOperand, \
+        const char*: TJames_StringOperand, \
+        default: TJames_PointerOperand)(value)
+
+#define TJAMES_EXPECT_BASE(a, op, b, condition) do { \
+                __auto_type TJames_A_ = (a); \
+                __auto_type TJames_B_ = (b); \
+                if(__builtin_expect(!!(condition), 1)) { \
+                        TJames_PassedChecks += 1; \
+                } else { \
+                        static const struct TJames_Check TJames_Check_ = { #a " " op " " #b, op, __LINE__ }; \
+                        TJames_CheckFailed(&TJames_Check_, TJAMES_OPERAND(TJames_A_), TJAMES_OPERAND(TJames_B_)); \
+                } \
+        } while(0)
+
+#define TJAMES_EXPECT_EQ(a, b) TJAMES_EXPECT_BASE(a, "==", b, TJames_A_ == TJames_B_)
+#define TJAMES_EXPECT_NE(a, b) TJAMES_EXPECT_BASE(a, "!=", b, TJames_A_ != TJames_B_)
+#define TJAMES_EXPECT_LT(a, b) TJAMES_EXPECT_BASE(a, "<",  b, TJames_A_ <  TJames_B_)
+#define TJAMES_EXPECT_GT(a, b) TJAMES_EXPECT_BASE(a, ">",  b, TJames_A_ >  TJames_B_)
+#define TJAMES_EXPECT_LE(a, b) TJAMES_EXPECT_BASE(a, "<=", b, TJames_A_ <= TJames_B_)
+#define TJAMES_EXPECT_GE(a, b) TJAMES_EXPECT_BASE(a, ">=", b, TJames_A_ >= TJames_B_)
+
+// Compares the contents of two strings, NULL only equals NULL.
+#define TJAMES_STRINGS_EQUAL(a, b) ((a) == (b) || ((a) != NULL && (b) != NULL && strcmp(a, b) == 0))
+#define TJAMES_EXPECT_STR_EQ(a, b) TJAMES_EXPECT_BASE(a, "==", b, TJAMES_STRINGS_EQUAL(TJames_A_, TJames_B_))
+#define TJAMES_EXPECT_STR_NE(a, b) TJAMES_EXPECT_BASE(a, "!=", b, !TJAMES_STRINGS_EQUAL(TJames_A_, TJames_B_))
+
+// Passes if `a` and `b` are at most `delta` apart.
+#define TJAMES_EXPECT_NEAR(a, b, delta) \
+        TJAMES_EXPECT_BASE(a, "~=", b, fabsl((long double)TJames_A_ - (long double)TJames_B_) <= (delta))
+
+// *-----------------*
+// |                 |
+// |   BULK CHECKS   |
+// |                 |
+// *-----------------*
+
+// Compare whole buffers and arrays at once. A failure reports how many bytes,
+// elements or values differ and shows the data around the first of them.
+
+extern int TJames_EqualMemory(const size_t line, const char *a_text, const char *b_text,
+        const void *a, const void *b, const size_t size, const size_t element_size);
+extern int TJames_NearFloats(const size_t line, const char *a_text, const char *b_text,
+        const float *a, const float *b, const size_t count, const float delta);
+extern int TJames_NearDoubles(const size_t line, const char *a_text, const char *b_text,
+        const double *a, const double *b, const size_t count, const double delta);
+
+#define TJAMES_BULK_BASE(equal) do { \
+                if(equal) { \
+                        TJames_PassedChecks += 1; \
+                } else { \
+                        return; \
+                } \
+        } while(0)
+
+#define TJAMES_EQUAL_MEMORY(a, b, size) \
+        TJAMES_BULK_BASE(TJames_EqualMemory(__LINE__, #a, #b, a, b, size, 1))
+#define TJAMES_EQUAL_ARRAY(a, b, count) \
+        TJAMES_BULK_BASE(TJames_EqualMemory(__LINE__, #a, #b, a, b, (count) * sizeof(*(a)), sizeof(*(a))))
+#define TJAMES_NEAR_ARRAY_FLOAT(a, b, count) \
+        TJAMES_BULK_BASE(TJames_NearFloats(__LINE__, #a, #b, a, b, count, TJAMES_FLOAT_DELTA))
+#define TJAMES_NEAR_ARRAY_DOUBLE(a, b, count) \
+        TJAMES_BULK_BASE(TJames_NearDoubles(__LINE__, #a, #b, a, b, count, TJAMES_DOUBLE_DELTA))
+
+// *------------------*
+// |                  |
+// |   GOLDEN FILES   |
+// |                  |
+// *------------------*
+
+// Compares output against a file under --golden-dir ("golden" by default).
+// Running with --update-golden rewrites the files that don't match.
+
+extern int TJames_MatchesGolden(const size_t line, const char *name, const void *data, const size_t size);
+
+#define TJAMES_MATCHES_GOLDEN(name, buf, len) TJAMES_BULK_BASE(TJames_MatchesGolden(__LINE__, name, buf, len))
+
+// *------------------*
+// |                  |
+// |   EVENT STREAM   |
+// |                  |
+// *------------------*
+
+// Layout of the file written with --events FILE and read by tjames_monitor. It
+// is a header, a ring of `capacity` events and a table of the test names.
+// Events are claimed by bumping `head` and published by storing their
+// position plus one in `sequence`, so readers skip slots still being written
+// and notice the ones that were overwritten.
+
+#define TJAMES_EVENTS_MAGIC 0x53544E455645544Aull // "JTEVENTS"
+#define TJAMES_EVENTS_VERSION 1
+
+enum TJames_EventKind
+{
+        RUN_BEGIN_EVENT = 1, // values: scheduled tests, jobs
+        TEST_BEGIN_EVENT,    // values: none
+        TEST_ERROR_EVENT,    // values: line, enum TJames_ErrorType
+        TEST_END_EVENT,      // values: enum TJames_TestResult, wall ns, cpu ns, allocations, instructions
+        RUN_END_EVENT        // values: failed tests, wall ns
+};
+
+struct TJames_Event
+{
+        _Atomic unsigned long long sequence;
+        unsigned kind;
+        unsigned test; // index into the name table, UINT_MAX for events of the run
+        unsigned long long time_ns; // since the start of the run
+        unsigned long long values[5];
+};
+
+struct TJames_EventHeader
+{
+        _Atomic unsigned long long magic; // TJAMES_EVENTS_MAGIC once the file is complete
+        unsigned version;
+        unsigned test_count;
+        unsigned long long capacity; // a power of two
+        unsigned long long names_offset; // "group\0name\0" per test, in index order
+        unsigned long long names_size;
+        long long pid; // of the runner
+        _Alignas(64) _Atomic unsigned long long head; // events claimed so far
+};
@@ -0,0 +1,83 @@
+#include "tjames.h"
+
+#include <errno.h>
+#include <stddef.h>
+
+// Interposes the malloc family to count the allocations of tests, for
+// --track-allocs, TJAMES_MAX_ALLOCS and TJAMES_NO_LEAKS. Only link it into
+// test binaries, it replaces the allocator of the whole process, and every
+// call checks whether the calling thread is tracked. Sanitizers bring their
+// own allocator, so the hooks are left out under them and tracking stays off.
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void *__libc_valloc(size_t size);
+extern void *__libc_pvalloc(size_t size);
+
+__attribute__((constructor)) static void TJames_LinkAllocHooks()
+{
+        TJames_InstallAllocHooks();
+}
+
+void *malloc(size_t size)
+{
+        return TJames_HookedAlloc(__libc_malloc(size), size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+        return TJames_HookedAlloc(__libc_calloc(count, size), count * size);
+}
+
+// The aligned entry points do not go through malloc inside glibc, so they
+// are hooked on their own.
+void *aligned_alloc(size_t alignment, size_t size)
+{
+        return TJames_HookedAlloc(__libc_memalign(alignment, size), size);
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+        return TJames_HookedAlloc(__libc_memalign(alignment, size), size);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size)
+{
+        if(alignment == 0 || (alignment & (alignment - 1)) != 0 || alignment % sizeof(void*) != 0) {
+                return EINVAL;
+        }
+        void *new_ptr = TJames_HookedAlloc(__libc_memalign(alignment, size), size);
+        if(new_ptr == NULL) {
+                return ENOMEM;
+        }
+        *ptr = new_ptr;
+        return 0;
+}
+
+void *valloc(size_t size)
+{
+        return TJames_HookedAlloc(__libc_valloc(size), size);
+}
+
+void *pvalloc(size_t size)
+{
+        return TJames_HookedAlloc(__libc_pvalloc(size), size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+        void *new_ptr = __libc_realloc(ptr, size);
+        TJames_HookedRealloc(ptr, new_ptr, size);
+        return new_ptr;
+}
+
+void free(void *ptr)
+{
+        TJames_HookedFree(ptr);
+        __libc_free(ptr);
+}
+#endif
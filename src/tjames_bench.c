@@ -0,0 +1,171 @@
+#include "tjames.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Benchmarks TJames itself and prints a JSON line per measurement, so changes
+// to the framework can be compared from run to run.
+//
+//      tjames_bench [TJames options]
+//
+// The options are passed on to every run after --reporter quiet --output
+// /dev/null, so only the results are written to stdout.
+
+#define TJAMES_BENCH_TESTS 100000
+#define TJAMES_BENCH_CHECKS 10000000
+#define TJAMES_BENCH_ERRORS 100000
+#define TJAMES_BENCH_ROUNDS 5
+#define TJAMES_BENCH_NAME_SIZE 24
+
+struct TJames_BenchResult
+{
+        const char *name;
+        size_t operations; // per round
+        double seconds[TJAMES_BENCH_ROUNDS];
+};
+
+enum TJames_BenchKind
+{
+        ADD_FUNC_BENCH,
+        RUN_TEST_BENCH,
+        CMP_BASE_BENCH,
+        PUSH_ERROR_BENCH,
+        BENCH_KIND_COUNT
+};
+
+static struct TJames_BenchResult BENCH_RESULTS[BENCH_KIND_COUNT] = {
+        { "add_func",   TJAMES_BENCH_TESTS,  { 0 } },
+        { "run_test",   TJAMES_BENCH_TESTS,  { 0 } },
+        { "cmp_base",   TJAMES_BENCH_CHECKS, { 0 } },
+        { "push_error", TJAMES_BENCH_ERRORS, { 0 } },
+};
+
+static size_t BENCH_ROUND;
+static volatile size_t BENCH_LIMIT = TJAMES_BENCH_CHECKS;
+
+double TJames_BenchClock()
+{
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+void TJames_BenchEmpty()
+{
+}
+
+void TJames_BenchChecks()
+{
+        double start = TJames_BenchClock();
+        for(size_t i = 0; i < TJAMES_BENCH_CHECKS; ++i) {
+                TJAMES_CMP_BASE(i < BENCH_LIMIT, "Failed bench check!");
+        }
+        BENCH_RESULTS[CMP_BASE_BENCH].seconds[BENCH_ROUND] = TJames_BenchClock() - start;
+}
+
+void TJames_BenchErrors()
+{
+        double start = TJames_BenchClock();
+        for(size_t i = 0; i < TJAMES_BENCH_ERRORS; ++i) {
+                TJames_PushError(WARNING_ERROR, __LINE__, "Bench warning %lu", (unsigned long)i);
+        }
+        BENCH_RESULTS[PUSH_ERROR_BENCH].seconds[BENCH_ROUND] = TJames_BenchClock() - start;
+}
+
+// Registers the empty tests and runs them. The run time is divided by the
+// test count, which makes it the overhead per test of the whole run.
+int TJames_BenchTests(const char *names, int argc, char **argv)
+{
+        TJames_Init();
+        double start = TJames_BenchClock();
+        for(size_t i = 0; i < TJAMES_BENCH_TESTS; ++i) {
+                if(TJames_AddFunc(TJames_BenchEmpty, names + i * TJAMES_BENCH_NAME_SIZE, "bench", __LINE__, __FILE__) != 0) {
+                        TJames_Destroy();
+                        return -1;
+                }
+        }
+        BENCH_RESULTS[ADD_FUNC_BENCH].seconds[BENCH_ROUND] = TJames_BenchClock() - start;
+
+        if(TJames_ParseArgs(argc, argv) != 0) {
+                TJames_Destroy();
+                return -1;
+        }
+        start = TJames_BenchClock();
+        int failed = TJames_Run();
+        BENCH_RESULTS[RUN_TEST_BENCH].seconds[BENCH_ROUND] = TJames_BenchClock() - start;
+        return failed;
+}
+
+int TJames_BenchAsserts(int argc, char **argv)
+{
+        TJames_Init();
+        TJAMES_ADD_GROUPED_FUNC(TJames_BenchChecks, "bench");
+        TJAMES_ADD_GROUPED_FUNC(TJames_BenchErrors, "bench");
+        if(TJames_ParseArgs(argc, argv) != 0) {
+                TJames_Destroy();
+                return -1;
+        }
+        return TJames_Run();
+}
+
+int TJames_CompareSeconds(const void *a, const void *b)
+{
+        double first = *(const double*)a;
+        double second = *(const double*)b;
+        return (first > second) - (first < second);
+}
+
+void TJames_WriteBenchResult(struct TJames_BenchResult *result)
+{
+        qsort(result->seconds, TJAMES_BENCH_ROUNDS, sizeof(double), TJames_CompareSeconds);
+        double median = result->seconds[TJAMES_BENCH_ROUNDS / 2];
+        double per_operation = median / result->operations;
+        printf("{\"type\":\"self_bench\",\"name\":\"%s\",\"operations\":%lu,\"rounds\":%d,"
+                "\"median_ns\":%.0f,\"min_ns\":%.0f,\"max_ns\":%.0f,\"ns_per_op\":%.3f,\"ops_per_second\":%.0f}\n",
+                result->name, (unsigned long)result->operations, TJAMES_BENCH_ROUNDS,
+                median * 1e9, result->seconds[0] * 1e9, result->seconds[TJAMES_BENCH_ROUNDS - 1] * 1e9,
+                per_operation * 1e9, (per_operation > 0.0) ? 1.0 / per_operation : 0.0);
+}
+
+int main(int argc, char **argv)
+{
+        char **run_argv = calloc(argc + 5, sizeof(char*));
+        char *names = malloc(TJAMES_BENCH_TESTS * TJAMES_BENCH_NAME_SIZE);
+        if(run_argv == NULL || names == NULL) {
+                fprintf(stderr, "TJames Error: Failed to set up the benchmarks!\n");
+                free(run_argv);
+                free(names);
+                return 2;
+        }
+
+        run_argv[0] = argv[0];
+        run_argv[1] = "--reporter";
+        run_argv[2] = "quiet";
+        run_argv[3] = "--output";
+        run_argv[4] = "/dev/null";
+        for(int i = 1; i < argc; ++i) {
+                run_argv[i + 4] = argv[i];
+        }
+        for(size_t i = 0; i < TJAMES_BENCH_TESTS; ++i) {
+                snprintf(names + i * TJAMES_BENCH_NAME_SIZE, TJAMES_BENCH_NAME_SIZE, "empty_%lu", (unsigned long)i);
+        }
+
+        int failed = 0;
+        for(BENCH_ROUND = 0; BENCH_ROUND < TJAMES_BENCH_ROUNDS && failed == 0; ++BENCH_ROUND) {
+                failed = TJames_BenchTests(names, argc + 4, run_argv) != 0 ||
+                        TJames_BenchAsserts(argc + 4, run_argv) != 0;
+        }
+        if(failed == 0) {
+                for(int i = 0; i < BENCH_KIND_COUNT; ++i) {
+                        TJames_WriteBenchResult(&BENCH_RESULTS[i]);
+                }
+        } else {
+                fprintf(stderr, "TJames Error: The benchmark runs failed!\n");
+        }
+
+        free(run_argv);
+        free(names);
+        return failed;
+}
@@ -0,0 +1,293 @@
+#include "tjames.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Follows the --events file of a running (or finished) TJames run and renders
+// a live progress line, or converts every event to a JSON line with --json.
+//
+//      tjames_monitor FILE [--json]
+
+#define TJAMES_MONITOR_POLL_NS (20 * 1000 * 1000)
+#define TJAMES_MONITOR_REDRAW_NS (100 * 1000 * 1000)
+
+struct TJames_Monitor
+{
+        const struct TJames_EventHeader *header;
+        const struct TJames_Event *ring;
+        size_t size;
+        const char **groups; // per test
+        const char **names;
+        int json;
+
+        unsigned long long position; // of the next event to read
+        unsigned long long lost;
+        unsigned long long scheduled;
+        unsigned long long finished;
+        unsigned long long failed;
+        unsigned long long last_test; // UINT_MAX before the first test began
+        unsigned long long last_time_ns;
+        unsigned long long last_redraw;
+        int done;
+};
+
+static const char *const RESULT_NAMES[] = { "empty", "success", "failed", "skipped", "cached" };
+static const char *const ERROR_NAMES[] = { "warning", "error", "critical" };
+
+unsigned long long TJames_MonitorClock()
+{
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+void TJames_MonitorSleep()
+{
+        struct timespec pause = { 0, TJAMES_MONITOR_POLL_NS };
+        nanosleep(&pause, NULL);
+}
+
+// Waits for the runner to create the file, then maps it. Returns -1 if it is
+// not a event file.
+int TJames_OpenMonitor(struct TJames_Monitor *monitor, const char *path)
+{
+        int fd;
+        struct stat info;
+        while((fd = open(path, O_RDONLY | O_CLOEXEC)) < 0) {
+                if(errno != ENOENT) {
+                        fprintf(stderr, "TJames Error: Failed to open '%s': %s!\n", path, strerror(errno));
+                        return -1;
+                }
+                TJames_MonitorSleep();
+        }
+        if(fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(struct TJames_EventHeader)) {
+                fprintf(stderr, "TJames Error: '%s' is not a event file!\n", path);
+                close(fd);
+                return -1;
+        }
+        void *data = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if(data == MAP_FAILED) {
+                fprintf(stderr, "TJames Error: Failed to map '%s': %s!\n", path, strerror(errno));
+                return -1;
+        }
+
+        const struct TJames_EventHeader *header = data;
+        if(atomic_load_explicit(&header->magic, memory_order_acquire) != TJAMES_EVENTS_MAGIC ||
+                header->version != TJAMES_EVENTS_VERSION ||
+                header->names_offset + header->names_size > (unsigned long long)info.st_size) {
+                fprintf(stderr, "TJames Error: '%s' is not a event file of this version!\n", path);
+                munmap(data, info.st_size);
+                return -1;
+        }
+
+        memset(monitor, 0, sizeof(*monitor));
+        monitor->header = header;
+        monitor->ring = (const struct TJames_Event*)(header + 1);
+        monitor->size = info.st_size;
+        monitor->groups = calloc(header->test_count + 1, sizeof(const char*));
+        monitor->names = calloc(header->test_count + 1, sizeof(const char*));
+        if(monitor->groups == NULL || monitor->names == NULL) {
+                fprintf(stderr, "TJames Error: Memory allocation failed, while reading the test names!\n");
+                return -1;
+        }
+        const char *cursor = (const char*)data + header->names_offset;
+        const char *end = cursor + header->names_size;
+        for(unsigned i = 0; i < header->test_count && cursor < end; ++i) {
+                monitor->groups[i] = cursor;
+                cursor += strnlen(cursor, end - cursor) + 1;
+                monitor->names[i] = (cursor < end) ? cursor : "";
+                cursor += strnlen(cursor, end - cursor) + 1;
+        }
+        monitor->last_test = UINT_MAX;
+        return 0;
+}
+
+void TJames_WriteMonitorJsonString(const char *string)
+{
+        putchar('"');
+        for(; *string != '\0'; ++string) {
+                if(*string == '"' || *string == '\\') {
+                        printf("\\%c", *string);
+                } else if((unsigned char)*string < 0x20) {
+                        printf("\\u%04x", *string);
+                } else {
+                        putchar(*string);
+                }
+        }
+        putchar('"');
+}
+
+void TJames_WriteMonitorJson(const struct TJames_Monitor *monitor, const struct TJames_Event *event)
+{
+        static const char *const KIND_NAMES[] = { "", "run_begin", "test_begin", "test_error", "test_end", "run_end" };
+        const char *kind = (event->kind <= RUN_END_EVENT) ? KIND_NAMES[event->kind] : "unknown";
+        printf("{\"event\":\"%s\",\"time_ns\":%llu", kind, event->time_ns);
+        if(event->test < monitor->header->test_count) {
+                printf(",\"group\":");
+                TJames_WriteMonitorJsonString(monitor->groups[event->test]);
+                printf(",\"name\":");
+                TJames_WriteMonitorJsonString(monitor->names[event->test]);
+        }
+        switch(event->kind)
+        {
+        case RUN_BEGIN_EVENT:
+                printf(",\"tests\":%llu,\"jobs\":%llu", event->values[0], event->values[1]);
+                break;
+        case TEST_ERROR_EVENT:
+                printf(",\"line\":%llu,\"type\":\"%s\"", event->values[0],
+                        (event->values[1] <= CRITICAL_ERROR) ? ERROR_NAMES[event->values[1]] : "unknown");
+                break;
+        case TEST_END_EVENT:
+                printf(",\"result\":\"%s\",\"wall_ns\":%llu,\"cpu_ns\":%llu,\"allocations\":%llu,\"instructions\":%llu",
+                        (event->values[0] <= CACHED_TEST) ? RESULT_NAMES[event->values[0]] : "unknown",
+                        event->values[1], event->values[2], event->values[3], event->values[4]);
+                break;
+        case RUN_END_EVENT:
+                printf(",\"failed\":%llu,\"wall_ns\":%llu", event->values[0], event->values[1]);
+                break;
+        }
+        printf("}\n");
+}
+
+void TJames_DrawProgress(struct TJames_Monitor *monitor)
+{
+        double seconds = monitor->last_time_ns / 1e9;
+        double rate = (seconds > 0.0) ? monitor->finished / seconds : 0.0;
+        printf("\r\033[K[%llu/%llu] %llu failed, %.1f tests/s, %.3f s",
+                monitor->finished, monitor->scheduled, monitor->failed, rate, seconds);
+        if(monitor->last_test < monitor->header->test_count && !monitor->done) {
+                printf(", running %s/%s", monitor->groups[monitor->last_test], monitor->names[monitor->last_test]);
+        }
+        fflush(stdout);
+        monitor->last_redraw = TJames_MonitorClock();
+}
+
+void TJames_HandleEvent(struct TJames_Monitor *monitor, const struct TJames_Event *event)
+{
+        monitor->last_time_ns = event->time_ns;
+        if(monitor->json) {
+                TJames_WriteMonitorJson(monitor, event);
+        }
+        int known = event->test < monitor->header->test_count;
+
+        switch(event->kind)
+        {
+        case RUN_BEGIN_EVENT:
+                monitor->scheduled = event->values[0];
+                break;
+        case TEST_BEGIN_EVENT:
+                monitor->last_test = event->test;
+                break;
+        case TEST_ERROR_EVENT:
+                if(!monitor->json && known && event->values[1] != WARNING_ERROR) {
+                        printf("\r\033[K%s/%s: error on line %llu\n",
+                                monitor->groups[event->test], monitor->names[event->test], event->values[0]);
+                }
+                break;
+        case TEST_END_EVENT:
+                monitor->finished += 1;
+                if(event->values[0] == FAILED_TEST) {
+                        monitor->failed += 1;
+                        if(!monitor->json && known) {
+                                printf("\r\033[K%s/%s: failed after %.3f ms\n",
+                                        monitor->groups[event->test], monitor->names[event->test], event->values[1] / 1e6);
+                        }
+                }
+                break;
+        case RUN_END_EVENT:
+                monitor->failed = event->values[0];
+                monitor->last_time_ns = event->values[1];
+                monitor->done = 1;
+                break;
+        }
+}
+
+// Reads every event published since the last call. Returns the number read.
+size_t TJames_PollEvents(struct TJames_Monitor *monitor)
+{
+        const struct TJames_EventHeader *header = monitor->header;
+        unsigned long long head = atomic_load_explicit(&header->head, memory_order_acquire);
+        if(head - monitor->position > header->capacity) {
+                monitor->lost += head - header->capacity - monitor->position;
+                monitor->position = head - header->capacity;
+        }
+
+        size_t read = 0;
+        while(monitor->position < head && !monitor->done) {
+                const struct TJames_Event *slot = &monitor->ring[monitor->position & (header->capacity - 1)];
+                unsigned long long sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+                if(sequence < monitor->position + 1) {
+                        // Claimed, but not yet published.
+                        break;
+                }
+                struct TJames_Event event;
+                event.kind = slot->kind;
+                event.test = slot->test;
+                event.time_ns = slot->time_ns;
+                memcpy(event.values, slot->values, sizeof(event.values));
+                atomic_thread_fence(memory_order_acquire);
+                if(sequence != monitor->position + 1 ||
+                        atomic_load_explicit(&slot->sequence, memory_order_relaxed) != sequence) {
+                        // Overwritten by a later event while it was read.
+                        monitor->lost += 1;
+                } else {
+                        TJames_HandleEvent(monitor, &event);
+                        read += 1;
+                }
+                monitor->position += 1;
+        }
+        return read;
+}
+
+int main(int argc, char **argv)
+{
+        if(argc < 2 || (argc > 2 && strcmp(argv[2], "--json") != 0)) {
+                printf("Usage: %s FILE [--json]\n", argv[0]);
+                return 2;
+        }
+
+        struct TJames_Monitor monitor;
+        if(TJames_OpenMonitor(&monitor, argv[1]) != 0) {
+                return 2;
+        }
+        monitor.json = (argc > 2);
+
+        while(!monitor.done) {
+                size_t read = TJames_PollEvents(&monitor);
+                if(!monitor.json && TJames_MonitorClock() - monitor.last_redraw >= TJAMES_MONITOR_REDRAW_NS) {
+                        TJames_DrawProgress(&monitor);
+                }
+                if(read == 0) {
+                        // A runner that died never sends the end of the run.
+                        if(kill(monitor.header->pid, 0) != 0 && errno == ESRCH &&
+                                atomic_load(&monitor.header->head) == monitor.position) {
+                                break;
+                        }
+                        TJames_MonitorSleep();
+                }
+        }
+
+        if(!monitor.json) {
+                TJames_DrawProgress(&monitor);
+                printf("\n%s", monitor.done ? "" : "The run ended without finishing!\n");
+        }
+        if(monitor.lost > 0) {
+                fprintf(stderr, "TJames Warning: %llu events were overwritten before they could be read!\n", monitor.lost);
+        }
+        int failed = !monitor.done || monitor.failed > 0;
+        free(monitor.groups);
+        free(monitor.names);
+        munmap((void*)monitor.header, monitor.size);
+        return failed;
+}
@@ -0,0 +1,6 @@
+// A shared library tjames_suite calls into. It is built twice, the second time
+// with another TJAMES_FIXTURE_VALUE, to stand in for a rebuilt library.
+int TJames_FixtureValue()
+{
+        return TJAMES_FIXTURE_VALUE;
+}
@@ -0,0 +1,431 @@
+#include "tjames.h"
+
+#include <math.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+// The suite tjames_test runs. Every group exercises one part of TJames and is
+// picked out there with --filter, some only make sense with --isolate. It is
+// built a second time with TJAMES_SUITE_CHANGED, which changes its data but not
+// its code, and links the fixture library found through LD_LIBRARY_PATH.
+
+// The build passes the absolute path, the table is mapped when it is added.
+#ifndef TJAMES_SUITE_ROWS
+#define TJAMES_SUITE_ROWS "tests/tjames_suite_rows.txt"
+#endif
+
+#ifdef TJAMES_SUITE_CHANGED
+#define TJAMES_SUITE_TABLE 1, 2, 4
+#else
+#define TJAMES_SUITE_TABLE 1, 2, 3
+#endif
+
+int TJames_FixtureValue();
+
+// The bulk kernels are internal to tjames.c, declared here so the vector ones
+// can be checked against the scalar ones.
+#if defined(__x86_64__) && !defined(TJAMES_NO_SIMD)
+#define TJAMES_SUITE_KERNELS 3
+#else
+#define TJAMES_SUITE_KERNELS 1
+#endif
+
+typedef size_t (*MismatchKernel)(const unsigned char *a, const unsigned char *b, size_t begin, const size_t size);
+typedef size_t (*FarFloatKernel)(const float *a, const float *b, size_t begin, const size_t count, const float delta);
+typedef size_t (*FarDoubleKernel)(const double *a, const double *b, size_t begin, const size_t count, const double delta);
+
+size_t TJames_FindMismatchScalar(const unsigned char *a, const unsigned char *b, size_t begin, const size_t size);
+size_t TJames_FindFarFloatScalar(const float *a, const float *b, size_t begin, const size_t count, const float delta);
+size_t TJames_FindFarDoubleScalar(const double *a, const double *b, size_t begin, const size_t count, const double delta);
+// As are the buckets of the latency histograms of load tests.
+size_t TJames_HistogramIndex(unsigned long long value);
+unsigned long long TJames_HistogramValue(const size_t index);
+double TJames_HistogramPercentile(const uint64_t *counts, const uint64_t total, const double percentile, const unsigned long long max);
+
+#if TJAMES_SUITE_KERNELS > 1
+size_t TJames_FindMismatchSse2(const unsigned char *a, const unsigned char *b, size_t begin, const size_t size);
+size_t TJames_FindFarFloatSse2(const float *a, const float *b, size_t begin, const size_t count, const float delta);
+size_t TJames_FindFarDoubleSse2(const double *a, const double *b, size_t begin, const size_t count, const double delta);
+size_t TJames_FindMismatchAvx2(const unsigned char *a, const unsigned char *b, size_t begin, const size_t size);
+size_t TJames_FindFarFloatAvx2(const float *a, const float *b, size_t begin, const size_t count, const float delta);
+size_t TJames_FindFarDoubleAvx2(const double *a, const double *b, size_t begin, const size_t count, const double delta);
+#endif
+
+TJAMES_TEST("Order", order_first)
+{
+        TJAMES_EQUAL(1, 1);
+}
+
+TJAMES_TEST("Order", order_second)
+{
+        TJAMES_EQUAL(2, 2);
+}
+
+TJAMES_TEST("Order", order_third)
+{
+        TJAMES_EQUAL(3, 3);
+}
+
+void mixed_pass()
+{
+        TJAMES_EQUAL(1, 1);
+}
+
+void mixed_skip()
+{
+        TJAMES_SKIP();
+}
+
+void mixed_fail()
+{
+        TJAMES_EQUAL(1, 2);
+}
+
+void mixed_after()
+{
+        TJAMES_EQUAL(1, 1);
+}
+
+void crash_segv()
+{
+        raise(SIGSEGV);
+}
+
+void crash_survivor()
+{
+        TJAMES_EQUAL(1, 1);
+}
+
+// Still running when timeout_spin times out next to it with --jobs.
+void stall_sleep()
+{
+        struct timespec duration = { 1, 0 };
+        nanosleep(&duration, NULL);
+        TJAMES_EQUAL(1, 1);
+}
+
+void timeout_spin()
+{
+        for(volatile int spin = 1; spin;) {
+        }
+}
+
+// Kept reachable from outside, so the compiler can not drop the allocations.
+void *LEAKED[2];
+
+void leak_malloc()
+{
+        TJAMES_NO_LEAKS();
+        LEAKED[0] = malloc(32);
+        TJAMES_EQUAL(1, 1);
+}
+
+void leak_aligned()
+{
+        TJAMES_NO_LEAKS();
+        LEAKED[1] = aligned_alloc(64, 128);
+        TJAMES_EQUAL(1, 1);
+}
+
+void leak_freed()
+{
+        TJAMES_NO_LEAKS();
+        void *ptr = aligned_alloc(64, 128);
+        TJAMES_DO_NOT_OPTIMIZE(ptr);
+        free(ptr);
+        TJAMES_EQUAL(1, 1);
+}
+
+TJAMES_PROPERTY(below_hundred, TJAMES_GEN_INT(0, 1000))
+{
+        TJAMES_CMP(values[0].i, <, 100, "Failed below hundred!");
+}
+
+void golden_text()
+{
+        TJAMES_MATCHES_GOLDEN("text", "golden\n", 7);
+}
+
+void library_value()
+{
+        TJAMES_EQUAL(TJames_FixtureValue(), 1);
+}
+
+// The rows hold 1 to 5, only the one with index 3 fails.
+void table_row(const struct TJames_Row *row)
+{
+        TJAMES_CMP(row->length, ==, 1, "Row is not a single digit!");
+        TJAMES_CMP(row->data[0], !=, '4', "Row holds a four!");
+}
+
+// Fails a check of every operand kind. The string is changed after its check
+// failed, the report has to show it as it was.
+void expect_formats()
+{
+        char text[] = "abc";
+        const char *missing = NULL;
+        TJAMES_EXPECT_EQ(-3, 4);
+        TJAMES_EXPECT_LT(7u, 2u);
+        TJAMES_EXPECT_EQ(0.5, 0.25);
+        TJAMES_EXPECT_EQ((char)'a', (char)'\n');
+        TJAMES_EXPECT_STR_EQ(text, "abd");
+        text[0] = 'x';
+        TJAMES_EXPECT_STR_EQ(missing, "abc");
+        TJAMES_EXPECT_NEAR(1.0, 2.0, 0.5);
+}
+
+// Kernels past the first that this CPU can run.
+size_t kernel_count()
+{
+#if TJAMES_SUITE_KERNELS > 1
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? 3 : 2;
+#else
+        return 1;
+#endif
+}
+
+// Moves a single mismatch through every position of buffers starting at every
+// offset of a vector, so the unaligned heads and the tails are covered.
+void kernel_mismatch()
+{
+        static const MismatchKernel KERNELS[] = {
+                TJames_FindMismatchScalar,
+#if TJAMES_SUITE_KERNELS > 1
+                TJames_FindMismatchSse2, TJames_FindMismatchAvx2
+#endif
+        };
+        const size_t kernels = kernel_count();
+        unsigned char a[256];
+        unsigned char b[256];
+        for(size_t i = 0; i < sizeof(a); ++i) {
+                a[i] = b[i] = (unsigned char)(i * 7 + 1);
+        }
+        for(size_t offset = 0; offset < 32; ++offset) {
+                for(size_t size = 0; offset + size <= 160; ++size) {
+                        for(size_t diff = 0; diff <= size; ++diff) {
+                                if(diff < size) {
+                                        b[offset + diff] ^= 0x40;
+                                }
+                                for(size_t begin = 0; begin <= diff && begin < 2; ++begin) {
+                                        size_t expected = TJames_FindMismatchScalar(a + offset, b + offset, begin, size);
+                                        for(size_t k = 1; k < kernels; ++k) {
+                                                size_t found = KERNELS[k](a + offset, b + offset, begin, size);
+                                                TJAMES_CMP_FMT(found, ==, expected, "Kernel %lu found %lu instead of %lu, offset %lu, size %lu!",
+                                                        k, found, expected, offset, size);
+                                        }
+                                }
+                                if(diff < size) {
+                                        b[offset + diff] ^= 0x40;
+                                }
+                        }
+                }
+        }
+}
+
+// Values that are equal, just within the delta, just outside of it and NaN,
+// at every position after every offset.
+void kernel_far()
+{
+        static const FarFloatKernel FLOAT_KERNELS[] = {
+                TJames_FindFarFloatScalar,
+#if TJAMES_SUITE_KERNELS > 1
+                TJames_FindFarFloatSse2, TJames_FindFarFloatAvx2
+#endif
+        };
+        static const FarDoubleKernel DOUBLE_KERNELS[] = {
+                TJames_FindFarDoubleScalar,
+#if TJAMES_SUITE_KERNELS > 1
+                TJames_FindFarDoubleSse2, TJames_FindFarDoubleAvx2
+#endif
+        };
+        static const double CHANGES[] = { 0.0, 0.25, 0.5, 0.75, NAN };
+        const size_t kernels = kernel_count();
+        float fa[64];
+        float fb[64];
+        double da[64];
+        double db[64];
+        for(size_t i = 0; i < 64; ++i) {
+                fa[i] = fb[i] = (float)i - 20.0f;
+                da[i] = db[i] = (double)i - 20.0;
+        }
+        // A signed zero equals the unsigned one.
+        fa[5] = -0.0f;
+        fb[5] = 0.0f;
+        da[5] = -0.0;
+        db[5] = 0.0;
+
+        for(size_t offset = 0; offset < 8; ++offset) {
+                for(size_t count = 0; offset + count <= 40; ++count) {
+                        for(size_t diff = 0; diff < count; ++diff) {
+                                for(size_t c = 0; c < sizeof(CHANGES) / sizeof(CHANGES[0]); ++c) {
+                                        float old_float = fb[offset + diff];
+                                        double old_double = db[offset + diff];
+                                        fb[offset + diff] += (float)CHANGES[c];
+                                        db[offset + diff] += CHANGES[c];
+                                        size_t expected_float = TJames_FindFarFloatScalar(fa + offset, fb + offset, 0, count, 0.5f);
+                                        size_t expected_double = TJames_FindFarDoubleScalar(da + offset, db + offset, 0, count, 0.5);
+                                        size_t far = (c < 3) ? count : diff;
+                                        TJAMES_CMP_FMT(expected_float, ==, far, "Scalar kernel found %lu instead of %lu, change %lu!",
+                                                expected_float, far, c);
+                                        for(size_t k = 1; k < kernels; ++k) {
+                                                size_t found = FLOAT_KERNELS[k](fa + offset, fb + offset, 0, count, 0.5f);
+                                                TJAMES_CMP_FMT(found, ==, expected_float, "Float kernel %lu found %lu instead of %lu, offset %lu, count %lu!",
+                                                        k, found, expected_float, offset, count);
+                                                found = DOUBLE_KERNELS[k](da + offset, db + offset, 0, count, 0.5);
+                                                TJAMES_CMP_FMT(found, ==, expected_double, "Double kernel %lu found %lu instead of %lu, offset %lu, count %lu!",
+                                                        k, found, expected_double, offset, count);
+                                        }
+                                        fb[offset + diff] = old_float;
+                                        db[offset + diff] = old_double;
+                                }
+                        }
+                }
+        }
+}
+
+// Every value lands in a bucket whose upper end is at most 1/64 above it, and
+// the buckets grow with the values.
+void histogram_buckets()
+{
+        size_t last_index = 0;
+        for(unsigned long long value = 0; value < 100000; ++value) {
+                size_t index = TJames_HistogramIndex(value);
+                unsigned long long upper = TJames_HistogramValue(index);
+                TJAMES_CMP_FMT(index, >=, last_index, "Value %llu went back to bucket %lu!", value, index);
+                TJAMES_CMP_FMT(upper, >=, value, "Bucket %lu ends at %llu, below %llu!", index, upper, value);
+                TJAMES_CMP_FMT(upper - value, <=, value / 64, "Bucket %lu ends at %llu, too far above %llu!", index, upper, value);
+                last_index = index;
+        }
+        for(unsigned shift = 17; shift < 47; ++shift) {
+                for(unsigned long long step = 0; step < 3; ++step) {
+                        unsigned long long value = (1ull << shift) + step * ((1ull << shift) / 3) - 1;
+                        unsigned long long upper = TJames_HistogramValue(TJames_HistogramIndex(value));
+                        TJAMES_CMP_FMT(upper, >=, value, "Bucket ends at %llu, below %llu!", upper, value);
+                        TJAMES_CMP_FMT(upper - value, <=, value / 64, "Bucket ends at %llu, too far above %llu!", upper, value);
+                }
+        }
+        // Beyond the range everything shares the last bucket.
+        TJAMES_EQUAL(TJames_HistogramIndex(1ull << 50), TJames_HistogramIndex(~0ull));
+}
+
+// The percentiles of 1 ... 1000, each recorded once.
+void histogram_percentiles()
+{
+        uint64_t *counts = calloc(TJames_HistogramIndex(~0ull) + 1, sizeof(uint64_t));
+        if(counts == NULL) {
+                TJAMES_FAILURE_EXIT_CONST("Out of memory!");
+        }
+        for(unsigned long long value = 1; value <= 1000; ++value) {
+                counts[TJames_HistogramIndex(value)] += 1;
+        }
+        static const double PERCENTILES[] = { 50.0, 99.0, 99.9, 100.0 };
+        static const double VALUES[] = { 500.0, 990.0, 999.0, 1000.0 };
+        for(size_t i = 0; i < sizeof(PERCENTILES) / sizeof(PERCENTILES[0]); ++i) {
+                double found = TJames_HistogramPercentile(counts, 1000, PERCENTILES[i], 1000);
+                TJAMES_EXPECT_GE(found, VALUES[i]);
+                TJAMES_EXPECT_LE(found, VALUES[i] * (1.0 + 1.0 / 64.0));
+        }
+        // The top bucket is capped by the largest value that was seen.
+        TJAMES_EXPECT_EQ(TJames_HistogramPercentile(counts, 1000, 100.0, 997), 997.0);
+        free(counts);
+}
+
+static atomic_size_t LOAD_CALLS;
+
+void load_counter(const size_t thread_index)
+{
+        (void)thread_index;
+        atomic_fetch_add(&LOAD_CALLS, 1);
+}
+
+// Passes alone, its second thread fails on the first call.
+void load_second_thread(const size_t thread_index)
+{
+        TJAMES_CMP_FMT(thread_index, ==, 0ul, "Called from thread %lu!", thread_index);
+}
+
+// Only the first run of these passes or is fast, so a single run of the suite
+// is unaffected. Under --repeat the counters are shared by every thread.
+static atomic_size_t FLAKY_RUNS;
+static atomic_size_t JITTERY_RUNS;
+
+void repeat_steady()
+{
+        TJAMES_EQUAL(1, 1);
+}
+
+void repeat_flaky()
+{
+        if(atomic_fetch_add(&FLAKY_RUNS, 1) % 2 == 1) {
+                TJAMES_FAILURE_CONST("Failed every second run!");
+        }
+}
+
+void repeat_jittery()
+{
+        if(atomic_fetch_add(&JITTERY_RUNS, 1) % 10 == 9) {
+                struct timespec duration = { 0, 2000000 };
+                nanosleep(&duration, NULL);
+        }
+        TJAMES_EQUAL(1, 1);
+}
+
+// Not a literal and not a format.
+void message_variable()
+{
+        const char *message = "100% of %s";
+        TJAMES_WARNING(message);
+        TJAMES_FAILURE(message);
+}
+
+static const int TABLE[] = { TJAMES_SUITE_TABLE };
+
+// The index keeps the compiler from folding the table into the code.
+static volatile size_t TABLE_INDEX = 2;
+
+void table_value()
+{
+        TJAMES_EQUAL(TABLE[TABLE_INDEX], 3);
+}
+
+int main(int argc, char **argv)
+{
+        TJames_Init();
+        TJAMES_ADD_GROUPED_FUNC(mixed_pass, "Mixed");
+        TJAMES_ADD_GROUPED_FUNC(mixed_skip, "Mixed");
+        TJAMES_ADD_GROUPED_FUNC(mixed_fail, "Mixed");
+        TJAMES_ADD_GROUPED_FUNC(mixed_after, "Mixed");
+        TJAMES_ADD_GROUPED_FUNC(crash_segv, "Crash");
+        TJAMES_ADD_GROUPED_FUNC(crash_survivor, "Crash");
+        TJAMES_ADD_GROUPED_FUNC(stall_sleep, "Stall");
+        TJAMES_ADD_GROUPED_TIMED_FUNC(timeout_spin, "Timeout", 100);
+        TJAMES_ADD_GROUPED_FUNC(leak_malloc, "Leak");
+        TJAMES_ADD_GROUPED_FUNC(leak_aligned, "Leak");
+        TJAMES_ADD_GROUPED_FUNC(leak_freed, "Leak");
+        TJAMES_ADD_GROUPED_PROPERTY(below_hundred, "Property", 0);
+        TJAMES_ADD_GROUPED_FUNC(golden_text, "Golden");
+        TJAMES_ADD_GROUPED_FUNC(library_value, "Library");
+        TJAMES_ADD_GROUPED_FUNC(table_value, "Table");
+        TJAMES_ADD_GROUPED_FUNC(expect_formats, "Expect");
+        TJAMES_ADD_GROUPED_FUNC(message_variable, "Message");
+        TJAMES_ADD_GROUPED_FUNC(kernel_mismatch, "Kernels");
+        TJAMES_ADD_GROUPED_FUNC(kernel_far, "Kernels");
+        TJAMES_ADD_GROUPED_TABLE(table_row, "Rows", TJAMES_SUITE_ROWS, 2);
+        TJAMES_ADD_GROUPED_FUNC(repeat_steady, "Repeat");
+        TJAMES_ADD_GROUPED_FUNC(repeat_flaky, "Repeat");
+        TJAMES_ADD_GROUPED_FUNC(repeat_jittery, "Repeat");
+        TJAMES_ADD_GROUPED_FUNC(histogram_buckets, "Histogram");
+        TJAMES_ADD_GROUPED_FUNC(histogram_percentiles, "Histogram");
+        TJAMES_ADD_GROUPED_LOAD(load_counter, "Load", 2);
+        TJAMES_ADD_GROUPED_LOAD(load_second_thread, "Load", 4);
+        if(TJames_ParseArgs(argc, argv) != 0) {
+                TJames_Destroy();
+                return 2;
+        }
+        return TJames_Run();
+}
@@ -0,0 +1,991 @@
+#include "tjames.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+// Runs tjames_suite with different options and checks its exit code and what
+// its reporters write, so whole runs are covered and not only single parts.
+//
+//      tjames_test SUITE [TJames options]
+//
+// The files the runs need are kept in tjames_test_work of the working directory.
+// SUITE_changed and the fixture libraries in the fixture and fixture_changed
+// directories next to SUITE stand in for rebuilds, tjames_monitor next to SUITE
+// reads the --events files of the runs.
+
+#define TJAMES_TEST_WORK_DIR "tjames_test_work"
+#define TJAMES_TEST_MAX_ARGS 32
+#define TJAMES_TEST_MAX_ENV 256
+// Seconds a run of the suite may take, a hung run is ended by SIGALRM.
+#define TJAMES_TEST_RUN_LIMIT 60
+
+extern char **environ;
+
+// Which builds of the suite and its fixture library a run uses.
+enum TJames_SuiteBuild
+{
+        ORIGINAL_BUILD = 0,
+        CHANGED_SUITE = 1,
+        CHANGED_LIBRARY = 2
+};
+
+static const char *SUITE_PATH;
+static char CHANGED_SUITE_PATH[PATH_MAX];
+static char MONITOR_PATH[PATH_MAX];
+static char LIBRARY_PATHS[2][PATH_MAX * 2 + 64];
+static char *SUITE_ENV[2][TJAMES_TEST_MAX_ENV + 2];
+
+struct TJames_SuiteRun
+{
+        int status; // exit code, or 128 plus the signal
+        char *output; // stdout, the banners and errors go to stderr
+        size_t length;
+};
+
+// Builds the environments of the suite, with LD_LIBRARY_PATH leading to either
+// fixture library and to a shared libtjames.
+void TJames_PrepareSuiteEnv()
+{
+        const char *slash = strrchr(SUITE_PATH, '/');
+        int dir_length = (slash != NULL) ? (int)(slash - SUITE_PATH) : 1;
+        const char *dir = (slash != NULL) ? SUITE_PATH : ".";
+        snprintf(CHANGED_SUITE_PATH, sizeof(CHANGED_SUITE_PATH), "%s_changed", SUITE_PATH);
+        snprintf(MONITOR_PATH, sizeof(MONITOR_PATH), "%.*s/tjames_monitor", dir_length, dir);
+
+        const char *inherited = getenv("LD_LIBRARY_PATH");
+        for(int i = 0; i < 2; ++i) {
+                snprintf(LIBRARY_PATHS[i], sizeof(LIBRARY_PATHS[i]), "LD_LIBRARY_PATH=%.*s/%s:%.*s%s%s",
+                        dir_length, dir, (i == 0) ? "fixture" : "fixture_changed", dir_length, dir,
+                        (inherited != NULL) ? ":" : "", (inherited != NULL) ? inherited : "");
+                size_t count = 0;
+                SUITE_ENV[i][count++] = LIBRARY_PATHS[i];
+                for(char **entry = environ; *entry != NULL && count < TJAMES_TEST_MAX_ENV; ++entry) {
+                        if(strncmp(*entry, "LD_LIBRARY_PATH=", 16) != 0) {
+                                SUITE_ENV[i][count++] = *entry;
+                        }
+                }
+                SUITE_ENV[i][count] = NULL;
+        }
+}
+
+// Runs the binary at `path` with the space separated `args`, its stderr is
+// dropped.
+int TJames_RunBinary(struct TJames_SuiteRun *run, const char *path, char **env, const char *args)
+{
+        char *copy = strdup(args);
+        char *argv[TJAMES_TEST_MAX_ARGS + 2] = { (char*)path };
+        size_t argc = 1;
+        char *state = NULL;
+        for(char *arg = strtok_r(copy, " ", &state); arg != NULL && argc <= TJAMES_TEST_MAX_ARGS; arg = strtok_r(NULL, " ", &state)) {
+                argv[argc++] = arg;
+        }
+
+        int fds[2];
+        if(copy == NULL || pipe(fds) != 0) {
+                free(copy);
+                return -1;
+        }
+        pid_t pid = fork();
+        if(pid == 0) {
+                int null_fd = open("/dev/null", O_WRONLY);
+                dup2(fds[1], STDOUT_FILENO);
+                dup2(null_fd, STDERR_FILENO);
+                close(fds[0]);
+                alarm(TJAMES_TEST_RUN_LIMIT);
+                execve(path, argv, env);
+                _exit(127);
+        }
+        close(fds[1]);
+        free(copy);
+
+        size_t capacity = 4096;
+        run->output = malloc(capacity);
+        run->length = 0;
+        for(;;) {
+                if(run->output != NULL && run->length + 1 == capacity) {
+                        capacity *= 2;
+                        char *output = realloc(run->output, capacity);
+                        if(output == NULL) {
+                                free(run->output);
+                        }
+                        run->output = output;
+                }
+                if(run->output == NULL) {
+                        break;
+                }
+                ssize_t received = read(fds[0], run->output + run->length, capacity - run->length - 1);
+                if(received < 0 && errno == EINTR) {
+                        continue;
+                }
+                if(received <= 0) {
+                        break;
+                }
+                run->length += received;
+        }
+        close(fds[0]);
+
+        int status = 0;
+        if(pid < 0 || waitpid(pid, &status, 0) != pid || run->output == NULL) {
+                free(run->output);
+                run->output = NULL;
+                return -1;
+        }
+        run->output[run->length] = '\0';
+        run->status = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+        return 0;
+}
+
+int TJames_RunSuiteBuild(struct TJames_SuiteRun *run, const int build, const char *args)
+{
+        return TJames_RunBinary(run, (build & CHANGED_SUITE) ? CHANGED_SUITE_PATH : SUITE_PATH,
+                SUITE_ENV[(build & CHANGED_LIBRARY) ? 1 : 0], args);
+}
+
+int TJames_RunSuite(struct TJames_SuiteRun *run, const char *args)
+{
+        return TJames_RunSuiteBuild(run, ORIGINAL_BUILD, args);
+}
+
+void TJames_FreeSuiteRun(struct TJames_SuiteRun *run)
+{
+        free(run->output);
+        run->output = NULL;
+}
+
+size_t TJames_CountOccurrences(const char *text, const char *needle)
+{
+        size_t count = 0;
+        size_t length = strlen(needle);
+        for(const char *found = strstr(text, needle); found != NULL; found = strstr(found + length, needle)) {
+                count += 1;
+        }
+        return count;
+}
+
+// Builds the path of a file in the work directory, removing what a previous
+// run left there.
+const char *TJames_WorkFile(char *path, const size_t size, const char *name)
+{
+        snprintf(path, size, "%s/%s", TJAMES_TEST_WORK_DIR, name);
+        unlink(path);
+        return path;
+}
+
+// Returns the contents of the file at `path`, or NULL if it can not be read.
+char *TJames_ReadFile(const char *path)
+{
+        FILE *stream = fopen(path, "r");
+        if(stream == NULL) {
+                return NULL;
+        }
+        size_t capacity = 4096;
+        size_t length = 0;
+        char *text = malloc(capacity);
+        while(text != NULL) {
+                length += fread(text + length, 1, capacity - length - 1, stream);
+                if(length + 1 < capacity) {
+                        text[length] = '\0';
+                        break;
+                }
+                capacity *= 2;
+                char *grown = realloc(text, capacity);
+                if(grown == NULL) {
+                        free(text);
+                }
+                text = grown;
+        }
+        fclose(stream);
+        return text;
+}
+
+// *-------------------*
+// |                   |
+// |   JSON VALIDATOR   |
+// |                   |
+// *-------------------*
+
+const char *TJames_SkipJsonSpace(const char *text)
+{
+        while(*text == ' ' || *text == '\t' || *text == '\n' || *text == '\r') {
+                ++text;
+        }
+        return text;
+}
+
+const char *TJames_ParseJsonString(const char *text)
+{
+        if(*text != '"') {
+                return NULL;
+        }
+        for(++text; *text != '"'; ++text) {
+                if((unsigned char)*text < 0x20) {
+                        return NULL;
+                }
+                if(*text == '\\') {
+                        ++text;
+                        if(*text == '\0' || strchr("\"\\/bfnrtu", *text) == NULL) {
+                                return NULL;
+                        }
+                }
+        }
+        return text + 1;
+}
+
+// Returns the end of the JSON value at `text`, or NULL if it is not valid.
+const char *TJames_ParseJsonValue(const char *text)
+{
+        text = TJames_SkipJsonSpace(text);
+        if(*text == '{' || *text == '[') {
+                char close = (*text == '{') ? '}' : ']';
+                text = TJames_SkipJsonSpace(text + 1);
+                if(*text == close) {
+                        return text + 1;
+                }
+                for(;;) {
+                        if(close == '}') {
+                                text = TJames_ParseJsonString(TJames_SkipJsonSpace(text));
+                                text = (text != NULL) ? TJames_SkipJsonSpace(text) : NULL;
+                                if(text == NULL || *text != ':') {
+                                        return NULL;
+                                }
+                                ++text;
+                        }
+                        text = TJames_ParseJsonValue(text);
+                        if(text == NULL) {
+                                return NULL;
+                        }
+                        text = TJames_SkipJsonSpace(text);
+                        if(*text == close) {
+                                return text + 1;
+                        }
+                        if(*text != ',') {
+                                return NULL;
+                        }
+                        ++text;
+                }
+        }
+        if(*text == '"') {
+                return TJames_ParseJsonString(text);
+        }
+        static const char *const LITERALS[] = { "true", "false", "null" };
+        for(size_t i = 0; i < 3; ++i) {
+                if(strncmp(text, LITERALS[i], strlen(LITERALS[i])) == 0) {
+                        return text + strlen(LITERALS[i]);
+                }
+        }
+        char *end;
+        strtod(text, &end);
+        return (end != text) ? end : NULL;
+}
+
+// Counts the lines of `output` that are not a single valid JSON value. It
+// splits `output` in place, so check it last.
+size_t TJames_CountInvalidJsonLines(char *output)
+{
+        size_t invalid = 0;
+        char *state = NULL;
+        for(char *line = strtok_r(output, "\n", &state); line != NULL; line = strtok_r(NULL, "\n", &state)) {
+                const char *end = TJames_ParseJsonValue(line);
+                if(end == NULL || *TJames_SkipJsonSpace(end) != '\0') {
+                        invalid += 1;
+                }
+        }
+        return invalid;
+}
+
+// *-----------*
+// |           |
+// |   TESTS   |
+// |           |
+// *-----------*
+
+void test_exit_codes()
+{
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Order --reporter tap"), 0);
+        TJAMES_EXPECT_EQ(run.status, 0);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "\nok "), 3ul);
+        TJames_FreeSuiteRun(&run);
+
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Mixed --reporter tap"), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "\nnot ok "), 1ul);
+        TJames_FreeSuiteRun(&run);
+
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--no-such-option"), 0);
+        TJAMES_EXPECT_EQ(run.status, 2);
+        TJames_FreeSuiteRun(&run);
+}
+
+void test_source_order()
+{
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Order --reporter tap"), 0);
+        TJAMES_EXPECT_NE(strstr(run.output, "ok 1 - Order/order_first\nok 2 - Order/order_second\nok 3 - Order/order_third\n"),
+                NULL);
+        TJames_FreeSuiteRun(&run);
+}
+
+// The workers finish in any order, the reporter still has to write the tests
+// in schedule order, byte for byte like a serial run.
+void test_jobs_output()
+{
+        static const char *const JOBS[] = { "2", "4", "8" };
+        struct TJames_SuiteRun serial;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&serial, "--filter Order,Mixed,Leak,Golden,Library,Table,Message --reporter tap"), 0);
+        TJAMES_EXPECT_EQ(serial.status, 1);
+        for(size_t i = 0; i < sizeof(JOBS) / sizeof(JOBS[0]); ++i) {
+                char args[256];
+                snprintf(args, sizeof(args), "--filter Order,Mixed,Leak,Golden,Library,Table,Message --reporter tap --jobs %s", JOBS[i]);
+                struct TJames_SuiteRun run;
+                TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+                TJAMES_EXPECT_EQ(run.status, 1);
+                TJAMES_EXPECT_STR_EQ(run.output, serial.output);
+                TJames_FreeSuiteRun(&run);
+        }
+        TJames_FreeSuiteRun(&serial);
+}
+
+// A pattern with '*' or '?' is a glob over the whole name, anything else
+// matches as a substring. Without a slash it matches the group or the name.
+void test_filters()
+{
+        static const struct
+        {
+                const char *args;
+                const char *listed;
+                const char *included;
+                const char *excluded;
+        } CASES[] = {
+                { "--filter order", "\nListed 3 of ", "[FUNC: order_third]", "[GROUP: Mixed]" },
+                { "--filter Order/*_s*", "\nListed 1 of ", "[FUNC: order_second]", "[FUNC: order_first]" },
+                { "--filter ?ixed", "\nListed 4 of ", "[FUNC: mixed_after]", "[GROUP: Order]" },
+                { "--filter Le?k/* --exclude leak_m*", "\nListed 2 of ", "[FUNC: leak_freed]", "[FUNC: leak_malloc]" },
+                { "--filter order_second,mixed_p", "\nListed 2 of ", "[FUNC: mixed_pass]", "[FUNC: order_first]" },
+                { "--filter Order --exclude Order/order_t*", "\nListed 2 of ", "[FUNC: order_first]", "[FUNC: order_third]" },
+                { "--filter nothing", "\nListed 0 of ", NULL, "[FUNC: " },
+        };
+        for(size_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); ++i) {
+                char args[256];
+                snprintf(args, sizeof(args), "--list %s", CASES[i].args);
+                struct TJames_SuiteRun run;
+                TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+                TJAMES_EXPECT_EQ(run.status, 0);
+                TJAMES_EXPECT_NE(strstr(run.output, CASES[i].listed), NULL);
+                if(CASES[i].included != NULL) {
+                        TJAMES_EXPECT_NE(strstr(run.output, CASES[i].included), NULL);
+                }
+                TJAMES_EXPECT_EQ(strstr(run.output, CASES[i].excluded), NULL);
+                TJames_FreeSuiteRun(&run);
+        }
+}
+
+// Every test lands in exactly one shard, and with recorded timings the
+// longest test gets a shard of its own.
+void test_sharding()
+{
+        static const char *const FUNCS[] = {
+                "order_first", "order_second", "order_third", "mixed_pass", "mixed_skip", "mixed_fail", "mixed_after"
+        };
+        size_t found[sizeof(FUNCS) / sizeof(FUNCS[0])] = { 0 };
+        for(size_t shard = 0; shard < 3; ++shard) {
+                char args[256];
+                snprintf(args, sizeof(args), "--list --filter Order,Mixed --shard-count 3 --shard-index %lu", shard);
+                struct TJames_SuiteRun run;
+                TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+                TJAMES_EXPECT_EQ(run.status, 0);
+                for(size_t i = 0; i < sizeof(FUNCS) / sizeof(FUNCS[0]); ++i) {
+                        char needle[64];
+                        snprintf(needle, sizeof(needle), "[FUNC: %s]", FUNCS[i]);
+                        found[i] += TJames_CountOccurrences(run.output, needle);
+                }
+                TJames_FreeSuiteRun(&run);
+        }
+        for(size_t i = 0; i < sizeof(FUNCS) / sizeof(FUNCS[0]); ++i) {
+                TJAMES_EXPECT_EQ(found[i], 1ul);
+        }
+
+        char path[256];
+        char args[512];
+        TJames_WorkFile(path, sizeof(path), "timings");
+        snprintf(args, sizeof(args), "--filter Order,Mixed --reporter tap --record-timings %s", path);
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJames_FreeSuiteRun(&run);
+        char *timings = TJames_ReadFile(path);
+        TJAMES_EXPECT_NE(timings, NULL);
+        if(timings != NULL) {
+                TJAMES_EXPECT_EQ(TJames_CountOccurrences(timings, "\n"), 7ul);
+                TJAMES_EXPECT_NE(strstr(timings, "Order\torder_first\t"), NULL);
+        }
+        free(timings);
+
+        // Later lines win, as for the concatenated files of several shards.
+        FILE *stream = fopen(path, "a");
+        TJAMES_EXPECT_NE(stream, NULL);
+        if(stream != NULL) {
+                for(size_t i = 0; i < sizeof(FUNCS) / sizeof(FUNCS[0]); ++i) {
+                        fprintf(stream, "%s\t%s\t%s\n", (i < 3) ? "Order" : "Mixed", FUNCS[i], (i == 0) ? "10.0" : "1.0");
+                }
+                fclose(stream);
+        }
+        for(size_t shard = 0; shard < 2; ++shard) {
+                snprintf(args, sizeof(args), "--list --filter Order,Mixed --shard-count 2 --shard-index %lu --timings-file %s", shard, path);
+                TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+                TJAMES_EXPECT_EQ(run.status, 0);
+                TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "[FUNC: "), (shard == 0) ? 1ul : 6ul);
+                TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "[FUNC: order_first]"), (shard == 0) ? 1ul : 0ul);
+                TJames_FreeSuiteRun(&run);
+        }
+}
+
+void test_cache_run_twice()
+{
+        char path[256];
+        char args[512];
+        snprintf(args, sizeof(args), "--filter Order --reporter json --cache %s", TJames_WorkFile(path, sizeof(path), "cache"));
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+        TJAMES_EXPECT_EQ(run.status, 0);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "\"result\":\"success\""), 3ul);
+        TJames_FreeSuiteRun(&run);
+
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+        TJAMES_EXPECT_EQ(run.status, 0);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "\"result\":\"cached\""), 3ul);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "\"failed\":0"), 1ul);
+        TJames_FreeSuiteRun(&run);
+
+        strcat(args, " --fail-fast");
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+        TJAMES_EXPECT_EQ(run.status, 0);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "\"result\":\"cached\""), 3ul);
+        TJames_FreeSuiteRun(&run);
+}
+
+// A rebuilt library or changed constant data must not be hidden by the cache,
+// although the code of the tests stayed the same.
+void test_cache_rebuilds()
+{
+        char path[256];
+        char args[512];
+        snprintf(args, sizeof(args), "--filter Library,Table --reporter json --cache %s",
+                TJames_WorkFile(path, sizeof(path), "rebuild_cache"));
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+        TJAMES_EXPECT_EQ(run.status, 0);
+        TJames_FreeSuiteRun(&run);
+
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+        TJAMES_EXPECT_EQ(run.status, 0);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "\"result\":\"cached\""), 2ul);
+        TJames_FreeSuiteRun(&run);
+
+        TJAMES_EXPECT_EQ(TJames_RunSuiteBuild(&run, CHANGED_LIBRARY, args), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "\"result\":\"cached\""), 0ul);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "\"result\":\"failed\""), 1ul);
+        TJames_FreeSuiteRun(&run);
+
+        TJAMES_EXPECT_EQ(TJames_RunSuiteBuild(&run, CHANGED_SUITE, args), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "\"result\":\"cached\""), 0ul);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "\"result\":\"failed\""), 1ul);
+        TJames_FreeSuiteRun(&run);
+}
+
+// The failure stops the run, the skipped test before it does not, whichever
+// way the tests are run.
+void test_fail_fast()
+{
+        static const char *const MODES[] = { "", " --jobs 3", " --isolate", " --isolate --jobs 3" };
+        for(size_t i = 0; i < sizeof(MODES) / sizeof(MODES[0]); ++i) {
+                char args[256];
+                snprintf(args, sizeof(args), "--filter Mixed --reporter tap --fail-fast%s", MODES[i]);
+                struct TJames_SuiteRun run;
+                TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+                TJAMES_EXPECT_EQ(run.status, 1);
+                TJAMES_EXPECT_NE(strstr(run.output, "ok 2 - Mixed/mixed_skip # SKIP\n"), NULL);
+                TJAMES_EXPECT_NE(strstr(run.output, "not ok 3 - Mixed/mixed_fail\n"), NULL);
+                TJAMES_EXPECT_EQ(strstr(run.output, "mixed_after"), NULL);
+                TJames_FreeSuiteRun(&run);
+        }
+}
+
+void test_isolate_crash()
+{
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Crash --isolate --reporter tap"), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_NE(strstr(run.output, "not ok 1 - Crash/crash_segv\n"), NULL);
+        TJAMES_EXPECT_NE(strstr(run.output, "killed by signal"), NULL);
+        TJAMES_EXPECT_NE(strstr(run.output, "\nok 2 - Crash/crash_survivor\n"), NULL);
+        TJames_FreeSuiteRun(&run);
+}
+
+void test_timeout()
+{
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Timeout --isolate --reporter tap"), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_NE(strstr(run.output, "not ok 1 - Timeout/timeout_spin\n"), NULL);
+        TJAMES_EXPECT_NE(strstr(run.output, "timed out"), NULL);
+        TJames_FreeSuiteRun(&run);
+}
+
+// In process, the watchdog reports the timed out test and ends the run, even
+// while a test before it in the schedule is still running.
+void test_timeout_in_process()
+{
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Timeout --reporter tap"), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_NE(strstr(run.output, "not ok 1 - Timeout/timeout_spin\n"), NULL);
+        TJAMES_EXPECT_NE(strstr(run.output, "[CRITICAL] Test timed out"), NULL);
+        TJames_FreeSuiteRun(&run);
+
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Stall,Timeout --jobs 2 --reporter tap"), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_NE(strstr(run.output, "1..2\nnot ok 1 - Timeout/timeout_spin\n"), NULL);
+        TJAMES_EXPECT_NE(strstr(run.output, "[CRITICAL] Test timed out"), NULL);
+        TJAMES_EXPECT_NE(strstr(run.output, "# Run a total of 1 tests, with a successrate of 0/1, 1 tests not run\n"), NULL);
+        TJames_FreeSuiteRun(&run);
+
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Stall,Timeout --jobs 2 --reporter junit"), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "<testcase "), 1ul);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "<failure"), 1ul);
+        TJAMES_EXPECT_NE(strstr(run.output, "</testsuite>\n"), NULL);
+        TJames_FreeSuiteRun(&run);
+}
+
+void test_timeout_repeated()
+{
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Timeout --repeat 2 --reporter tap"), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_NE(strstr(run.output, "not ok 1 - Timeout/timeout_spin\n"), NULL);
+        TJAMES_EXPECT_NE(strstr(run.output, "[CRITICAL] Test timed out"), NULL);
+        TJames_FreeSuiteRun(&run);
+
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Stall,Timeout --jobs 2 --soak 5000 --reporter tap"), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_NE(strstr(run.output, "[CRITICAL] Test timed out"), NULL);
+        TJames_FreeSuiteRun(&run);
+
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Timeout --repeat 2 --isolate"), 0);
+        TJAMES_EXPECT_EQ(run.status, 2);
+        TJames_FreeSuiteRun(&run);
+}
+
+// Returns the value of the number `key` on the line of `name` in JSON output,
+// or -1 if there is none.
+double TJames_JsonNumberOf(const char *output, const char *name, const char *key)
+{
+        char needle[128];
+        snprintf(needle, sizeof(needle), "\"name\":\"%s\"", name);
+        const char *line = strstr(output, needle);
+        snprintf(needle, sizeof(needle), "\"%s\":", key);
+        const char *found = (line != NULL) ? strstr(line, needle) : NULL;
+        const char *end = (line != NULL) ? strchr(line, '\n') : NULL;
+        double value;
+        if(found == NULL || (end != NULL && found > end) || sscanf(found + strlen(needle), "%lf", &value) != 1) {
+                return -1.0;
+        }
+        return value;
+}
+
+// Every run of a repeated test is counted, a test that fails some of its runs
+// is flaky, and one with rare slow runs has a high variance.
+void test_repeat_verdicts()
+{
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Repeat --repeat 50 --reporter json"), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "\"runs\":50,\"failures\":0,\"skips\":0,\"flaky\":false,"), 2ul);
+        TJAMES_EXPECT_NE(strstr(run.output, "\"name\":\"repeat_flaky\",\"file\":"), NULL);
+        TJAMES_EXPECT_NE(strstr(run.output, "\"runs\":50,\"failures\":25,\"skips\":0,\"flaky\":true,"), NULL);
+        // Only the first failed run keeps its errors.
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "Failed every second run!"), 1ul);
+        const char *jittery = strstr(run.output, "\"name\":\"repeat_jittery\"");
+        TJAMES_EXPECT_NE(jittery, NULL);
+        if(jittery != NULL) {
+                const char *flag = strstr(jittery, "\"high_variance\":true");
+                TJAMES_EXPECT_NE(flag, NULL);
+                TJAMES_EXPECT_LT(flag, strchr(jittery, '\n'));
+        }
+        TJAMES_EXPECT_EQ(TJames_CountInvalidJsonLines(run.output), 0ul);
+        TJames_FreeSuiteRun(&run);
+
+        // The rounds are shared by the threads, not run by each of them.
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Repeat,Mixed/mixed_skip --repeat 50 --jobs 4 --reporter tap"), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_NE(strstr(run.output, "ok 1 - Mixed/mixed_skip # SKIP 0 of 50 runs failed,"), NULL);
+        TJAMES_EXPECT_NE(strstr(run.output, "ok 2 - Repeat/repeat_steady # 0 of 50 runs failed,"), NULL);
+        TJAMES_EXPECT_NE(strstr(run.output, "not ok 3 - Repeat/repeat_flaky # 25 of 50 runs failed (flaky),"), NULL);
+        TJAMES_EXPECT_NE(strstr(run.output, ", high variance\n"), NULL);
+        TJames_FreeSuiteRun(&run);
+
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Repeat --soak 100 --jobs 2 --reporter json"), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_GT(TJames_JsonNumberOf(run.output, "repeat_steady", "runs"), 1.0);
+        TJAMES_EXPECT_GT(TJames_JsonNumberOf(run.output, "repeat_flaky", "failures"), 0.0);
+        const char *summary = strstr(run.output, "{\"type\":\"summary\"");
+        double wall_ms = 0.0;
+        TJAMES_EXPECT_NE(summary, NULL);
+        if(summary != NULL && sscanf(summary, "{\"type\":\"summary\",\"tests\":%*u,\"failed\":%*u,\"not_run\":%*u,\"wall_ms\":%lf", &wall_ms) == 1) {
+                TJAMES_EXPECT_GE(wall_ms, 100.0);
+        }
+        TJames_FreeSuiteRun(&run);
+
+        // The second run fails, --fail-fast ends the rounds there.
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Repeat/repeat_flaky --repeat 1000 --fail-fast --reporter json"), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_EQ(TJames_JsonNumberOf(run.output, "repeat_flaky", "runs"), 2.0);
+        TJames_FreeSuiteRun(&run);
+}
+
+// A single run of a test can never be compared, so only repeated tests are
+// written to the baseline.
+void test_baseline_samples()
+{
+        char path[256];
+        char args[512];
+        snprintf(args, sizeof(args), "--filter Order --reporter tap --save-baseline %s",
+                TJames_WorkFile(path, sizeof(path), "samples_baseline"));
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+        TJAMES_EXPECT_EQ(run.status, 0);
+        TJames_FreeSuiteRun(&run);
+        char *baseline = TJames_ReadFile(path);
+        TJAMES_EXPECT_EQ(baseline, NULL);
+        free(baseline);
+
+        strcat(args, " --repeat 5");
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+        TJAMES_EXPECT_EQ(run.status, 0);
+        TJames_FreeSuiteRun(&run);
+        baseline = TJames_ReadFile(path);
+        TJAMES_EXPECT_NE(baseline, NULL);
+        if(baseline != NULL) {
+                TJAMES_EXPECT_EQ(TJames_CountOccurrences(baseline, "test\tOrder\t"), 3ul);
+        }
+        free(baseline);
+}
+
+// Failed checks are only formatted when reported, in --isolate right away,
+// both have to print the operands alike.
+void test_expect_formats()
+{
+        static const char *const LINES[] = {
+                "Failed \"-3 == 4\", got -3 == 4!\n",
+                "Failed \"7u < 2u\", got 7 < 2!\n",
+                "Failed \"0.5 == 0.25\", got 0.5 == 0.25!\n",
+                "Failed \"(char)'a' == (char)'\\n'\", got 'a' == '\\x0a'!\n",
+                "Failed \"text == \"abd\"\", got \"abc\" == \"abd\"!\n",
+                "Failed \"missing == \"abc\"\", got NULL == \"abc\"!\n",
+                "Failed \"1.0 ~= 2.0\", got 1 ~= 2!\n",
+        };
+        static const char *const MODES[] = { "", " --isolate" };
+        for(size_t i = 0; i < sizeof(MODES) / sizeof(MODES[0]); ++i) {
+                char args[256];
+                snprintf(args, sizeof(args), "--filter Expect --reporter tap%s", MODES[i]);
+                struct TJames_SuiteRun run;
+                TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+                TJAMES_EXPECT_EQ(run.status, 1);
+                for(size_t j = 0; j < sizeof(LINES) / sizeof(LINES[0]); ++j) {
+                        TJAMES_EXPECT_NE(strstr(run.output, LINES[j]), NULL);
+                }
+                TJames_FreeSuiteRun(&run);
+        }
+
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Expect --reporter json"), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_EQ(TJames_CountInvalidJsonLines(run.output), 0ul);
+        TJames_FreeSuiteRun(&run);
+}
+
+// The suite checks the SSE2 and AVX2 kernels against the scalar ones on every
+// head offset, length and mismatch position.
+void test_bulk_kernels()
+{
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Kernels --reporter tap"), 0);
+        TJAMES_EXPECT_EQ(run.status, 0);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "\nok "), 2ul);
+        TJames_FreeSuiteRun(&run);
+}
+
+// Loads only run with --load. Every step reports p50 <= p99 <= p99.9 <= max,
+// and a load stops at the first step with a failed thread.
+void test_load_histograms()
+{
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Histogram --reporter json"), 0);
+        TJAMES_EXPECT_EQ(run.status, 0);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "\"result\":\"success\""), 2ul);
+        TJAMES_EXPECT_EQ(strstr(run.output, "\"type\":\"load\""), NULL);
+        TJames_FreeSuiteRun(&run);
+
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Histogram --load --load-time 20 --reporter json"), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "\"type\":\"load\""), 2ul);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "{\"threads\":1,"), 2ul);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "{\"threads\":2,"), 2ul);
+        // The failing load stops at the step that failed.
+        TJAMES_EXPECT_EQ(strstr(run.output, "{\"threads\":4,"), NULL);
+        TJAMES_EXPECT_NE(strstr(run.output, "\"message\":\"Thread 1 of 2: Called from thread 1!\""), NULL);
+
+        size_t steps = 0;
+        for(const char *step = strstr(run.output, "\"calls\":"); step != NULL; step = strstr(step + 1, "\"calls\":")) {
+                unsigned long calls;
+                double p50, p99, p999, max;
+                if(sscanf(step, "\"calls\":%lu,\"seconds\":%*f,\"calls_per_s\":%*f,\"efficiency\":%*f,"
+                        "\"p50_ns\":%lf,\"p99_ns\":%lf,\"p999_ns\":%lf,\"max_ns\":%lf", &calls, &p50, &p99, &p999, &max) != 5) {
+                        TJAMES_FAILURE_CONST("Unreadable load step!");
+                        break;
+                }
+                TJAMES_EXPECT_GT(calls, 0ul);
+                TJAMES_EXPECT_LE(p50, p99);
+                TJAMES_EXPECT_LE(p99, p999);
+                TJAMES_EXPECT_LE(p999, max);
+                steps += 1;
+        }
+        TJAMES_EXPECT_EQ(steps, 4ul);
+        TJAMES_EXPECT_EQ(TJames_CountInvalidJsonLines(run.output), 0ul);
+        TJames_FreeSuiteRun(&run);
+}
+
+// tjames_monitor reads back one begin and one end per test, the errors and the
+// results, from serial, parallel and isolated runs.
+void test_event_stream()
+{
+        static const char *const MODES[] = { "", " --jobs 3", " --isolate" };
+        char path[256];
+        char args[512];
+        struct TJames_SuiteRun run;
+        for(size_t i = 0; i < sizeof(MODES) / sizeof(MODES[0]); ++i) {
+                TJames_WorkFile(path, sizeof(path), "events");
+                snprintf(args, sizeof(args), "--filter Mixed --reporter tap --events %s%s", path, MODES[i]);
+                TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+                TJAMES_EXPECT_EQ(run.status, 1);
+                TJames_FreeSuiteRun(&run);
+
+                snprintf(args, sizeof(args), "%s --json", path);
+                TJAMES_EXPECT_EQ(TJames_RunBinary(&run, MONITOR_PATH, SUITE_ENV[0], args), 0);
+                TJAMES_EXPECT_EQ(run.status, 1);
+                TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "{\"event\":\"run_begin\""), 1ul);
+                TJAMES_EXPECT_NE(strstr(run.output, "\"tests\":4,"), NULL);
+                TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "{\"event\":\"test_begin\""), 4ul);
+                TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "{\"event\":\"test_end\""), 4ul);
+                TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "\"result\":\"success\""), 2ul);
+                TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "\"result\":\"skipped\""), 1ul);
+                TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "\"name\":\"mixed_fail\",\"result\":\"failed\""), 1ul);
+                TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "\"name\":\"mixed_fail\",\"line\":"), 1ul);
+                TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "{\"event\":\"run_end\""), 1ul);
+                TJAMES_EXPECT_EQ(TJames_CountInvalidJsonLines(run.output), 0ul);
+                TJames_FreeSuiteRun(&run);
+        }
+
+        TJAMES_EXPECT_EQ(TJames_RunBinary(&run, MONITOR_PATH, SUITE_ENV[0], path), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_NE(strstr(run.output, "Mixed/mixed_fail: failed after "), NULL);
+        TJAMES_EXPECT_NE(strstr(run.output, "[4/4] "), NULL);
+        TJames_FreeSuiteRun(&run);
+
+        FILE *stream = fopen(path, "w");
+        TJAMES_EXPECT_NE(stream, NULL);
+        if(stream == NULL) {
+                return;
+        }
+        fprintf(stream, "Not a ring of events, but longer than its header.%256s\n", "");
+        fclose(stream);
+        TJAMES_EXPECT_EQ(TJames_RunBinary(&run, MONITOR_PATH, SUITE_ENV[0], path), 0);
+        TJAMES_EXPECT_EQ(run.status, 2);
+        TJames_FreeSuiteRun(&run);
+}
+
+void test_messages()
+{
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Message --reporter tap"), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_NE(strstr(run.output, "[WARNING] 100% of %s\n"), NULL);
+        TJAMES_EXPECT_NE(strstr(run.output, "[ERROR] 100% of %s\n"), NULL);
+        TJames_FreeSuiteRun(&run);
+}
+
+// A test only fails against the baseline if its median slowed down and the
+// Mann-Whitney test finds the slowdown significant.
+void test_baseline_regressions()
+{
+        static const struct
+        {
+                const char *samples;
+                int status;
+        } CASES[] = {
+                { "1,1,1,1,1,1,1,1,1,1", 1 },
+                { "1e9,1e9,1e9,1e9,1e9,1e9,1e9,1e9,1e9,1e9", 0 },
+                // The median slowed down, but not significantly.
+                { "1,1,1,1,1,1,1e9,1e9,1e9,1e9,1e9", 0 },
+                // Too few samples to compare against.
+                { "1,1,1", 0 },
+        };
+        char path[256];
+        TJames_WorkFile(path, sizeof(path), "regression_baseline");
+        for(size_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); ++i) {
+                FILE *stream = fopen(path, "w");
+                TJAMES_EXPECT_NE(stream, NULL);
+                if(stream == NULL) {
+                        return;
+                }
+                fprintf(stream, "test\tOrder\torder_first\t%s\n", CASES[i].samples);
+                fclose(stream);
+
+                char args[512];
+                snprintf(args, sizeof(args), "--filter Order/order_first --reporter tap --repeat 10 --compare-baseline %s", path);
+                struct TJames_SuiteRun run;
+                TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+                TJAMES_EXPECT_EQ(run.status, CASES[i].status);
+                TJAMES_EXPECT_EQ(strstr(run.output, "Slower than the baseline") != NULL, CASES[i].status);
+                TJames_FreeSuiteRun(&run);
+        }
+}
+
+// Every chunk of rows is a test of its own, and the errors of a row carry its
+// index, also when the chunk ran in another thread or process.
+void test_table_rows()
+{
+        static const char *const MODES[] = { "", " --jobs 3", " --isolate" };
+        for(size_t i = 0; i < sizeof(MODES) / sizeof(MODES[0]); ++i) {
+                char args[256];
+                snprintf(args, sizeof(args), "--filter Rows --reporter tap%s", MODES[i]);
+                struct TJames_SuiteRun run;
+                TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+                TJAMES_EXPECT_EQ(run.status, 1);
+                TJAMES_EXPECT_NE(strstr(run.output, "1..3\nok 1 - Rows/table_row[0-1]\nnot ok 2 - Rows/table_row[2-3]\n"), NULL);
+                TJAMES_EXPECT_NE(strstr(run.output, "[ERROR] Row 3: Row holds a four!\nok 3 - Rows/table_row[4-4]\n"), NULL);
+                TJames_FreeSuiteRun(&run);
+        }
+
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter table_row[4 --reporter tap"), 0);
+        TJAMES_EXPECT_EQ(run.status, 0);
+        TJAMES_EXPECT_NE(strstr(run.output, "1..1\nok 1 - Rows/table_row[4-4]\n"), NULL);
+        TJames_FreeSuiteRun(&run);
+}
+
+void test_leak_checks()
+{
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Leak --reporter tap"), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_NE(strstr(run.output, "not ok 1 - Leak/leak_malloc\n"), NULL);
+        TJAMES_EXPECT_NE(strstr(run.output, "not ok 2 - Leak/leak_aligned\n"), NULL);
+        TJAMES_EXPECT_NE(strstr(run.output, "\nok 3 - Leak/leak_freed\n"), NULL);
+        TJames_FreeSuiteRun(&run);
+}
+
+void test_shrinking()
+{
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Property --seed 1 --reporter tap"), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJAMES_EXPECT_NE(strstr(run.output, "Property falsified"), NULL);
+        TJAMES_EXPECT_NE(strstr(run.output, "values[0] = 100\n"), NULL);
+        TJames_FreeSuiteRun(&run);
+}
+
+void test_golden_files()
+{
+        char path[256];
+        char args[512];
+        TJames_WorkFile(path, sizeof(path), "golden/text");
+        snprintf(args, sizeof(args), "--filter Golden --reporter tap --golden-dir %s/golden", TJAMES_TEST_WORK_DIR);
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+        TJAMES_EXPECT_EQ(run.status, 1);
+        TJames_FreeSuiteRun(&run);
+
+        strcat(args, " --update-golden");
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+        TJAMES_EXPECT_EQ(run.status, 0);
+        TJames_FreeSuiteRun(&run);
+
+        args[strlen(args) - strlen(" --update-golden")] = '\0';
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, args), 0);
+        TJAMES_EXPECT_EQ(run.status, 0);
+        TJames_FreeSuiteRun(&run);
+}
+
+// Nothing but the reporter may write to stdout, or its output can not be read.
+void test_reporter_output()
+{
+        struct TJames_SuiteRun run;
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Order,Mixed --reporter json"), 0);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "{\"type\":\"test\""), 7ul);
+        TJAMES_EXPECT_EQ(TJames_CountInvalidJsonLines(run.output), 0ul);
+        TJames_FreeSuiteRun(&run);
+
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Order,Mixed --reporter junit"), 0);
+        TJAMES_EXPECT_EQ(strncmp(run.output, "<?xml", 5), 0);
+        TJAMES_EXPECT_EQ(TJames_CountOccurrences(run.output, "<testcase "), 7ul);
+        TJAMES_EXPECT_NE(strstr(run.output, "</testsuite>\n"), NULL);
+        TJames_FreeSuiteRun(&run);
+
+        TJAMES_EXPECT_EQ(TJames_RunSuite(&run, "--filter Order,Mixed --reporter tap"), 0);
+        TJAMES_EXPECT_EQ(strncmp(run.output, "TAP version 13\n1..7\n", 20), 0);
+        TJames_FreeSuiteRun(&run);
+}
+
+int main(int argc, char **argv)
+{
+        if(argc < 2) {
+                fprintf(stderr, "Usage: %s SUITE [TJames options]\n", argv[0]);
+                return 2;
+        }
+        SUITE_PATH = argv[1];
+        TJames_PrepareSuiteEnv();
+        mkdir(TJAMES_TEST_WORK_DIR, 0755);
+
+        TJames_Init();
+        TJAMES_ADD_GROUPED_FUNC(test_exit_codes, "Run");
+        TJAMES_ADD_GROUPED_FUNC(test_source_order, "Run");
+        TJAMES_ADD_GROUPED_FUNC(test_jobs_output, "Jobs");
+        TJAMES_ADD_GROUPED_FUNC(test_filters, "Filter");
+        TJAMES_ADD_GROUPED_FUNC(test_sharding, "Shard");
+        TJAMES_ADD_GROUPED_FUNC(test_cache_run_twice, "Cache");
+        TJAMES_ADD_GROUPED_FUNC(test_cache_rebuilds, "Cache");
+        TJAMES_ADD_GROUPED_FUNC(test_fail_fast, "FailFast");
+        TJAMES_ADD_GROUPED_FUNC(test_isolate_crash, "Isolate");
+        TJAMES_ADD_GROUPED_FUNC(test_timeout, "Isolate");
+        TJAMES_ADD_GROUPED_FUNC(test_timeout_in_process, "Timeout");
+        TJAMES_ADD_GROUPED_FUNC(test_timeout_repeated, "Timeout");
+        TJAMES_ADD_GROUPED_FUNC(test_repeat_verdicts, "Repeat");
+        TJAMES_ADD_GROUPED_FUNC(test_baseline_samples, "Baseline");
+        TJAMES_ADD_GROUPED_FUNC(test_baseline_regressions, "Baseline");
+        TJAMES_ADD_GROUPED_FUNC(test_expect_formats, "Expect");
+        TJAMES_ADD_GROUPED_FUNC(test_messages, "Messages");
+        TJAMES_ADD_GROUPED_FUNC(test_bulk_kernels, "Kernels");
+        TJAMES_ADD_GROUPED_FUNC(test_load_histograms, "Load");
+        TJAMES_ADD_GROUPED_FUNC(test_event_stream, "Events");
+        TJAMES_ADD_GROUPED_FUNC(test_table_rows, "Tables");
+        TJAMES_ADD_GROUPED_FUNC(test_leak_checks, "Allocs");
+        TJAMES_ADD_GROUPED_FUNC(test_shrinking, "Property");
+        TJAMES_ADD_GROUPED_FUNC(test_golden_files, "Golden");
+        TJAMES_ADD_GROUPED_FUNC(test_reporter_output, "Reporters");
+        if(TJames_ParseArgs(argc - 1, argv + 1) != 0) {
+                TJames_Destroy();
+                return 2;
+        }
+        return TJames_Run();
+}